@@ -0,0 +1,67 @@
+#include "atomicfile.h"
+#include "tracing.h"
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <stdexcept>
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+namespace {
+
+bool syncToDisk(const std::string& path, bool directory) {
+    KANBAN_TRACE_SCOPE("fsync");
+#ifdef _WIN32
+    if (directory) return true;   // каталоги в Windows не синхронизируются
+    HANDLE file = CreateFileA(path.c_str(), GENERIC_WRITE, FILE_SHARE_READ | FILE_SHARE_WRITE,
+                              nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+    if (file == INVALID_HANDLE_VALUE) return false;
+    bool ok = FlushFileBuffers(file) != 0;
+    CloseHandle(file);
+    return ok;
+#else
+    int fd = ::open(path.c_str(), directory ? O_RDONLY | O_DIRECTORY : O_RDWR);
+    if (fd < 0) return false;
+    bool ok = ::fsync(fd) == 0;
+    ::close(fd);
+    return ok;
+#endif
+}
+
+}
+
+void writeFileAtomically(const std::string& filename,
+                         const std::function<void(std::ostream&)>& write)
+{
+    KANBAN_TRACE_SCOPE("writeFileAtomically");
+    std::string tmp = filename + ".tmp";
+    try {
+        {
+            std::ofstream file(tmp.c_str(), std::ios::binary | std::ios::trunc);
+            if (!file) {
+                throw std::runtime_error("Невозможно открыть файл для записи");
+            }
+            write(file);
+            file.close();
+            if (!file) {
+                throw std::runtime_error("Ошибка записи файла");
+            }
+        }
+        if (!syncToDisk(tmp, false)) {
+            throw std::runtime_error("Не удалось сбросить файл на диск");
+        }
+        std::filesystem::rename(tmp, filename);
+    } catch (...) {
+        std::remove(tmp.c_str());
+        throw;
+    }
+
+    // Переименование должно пережить сбой питания: синхронизируем и каталог.
+    std::filesystem::path dir = std::filesystem::path(filename).parent_path();
+    syncToDisk(dir.empty() ? std::string(".") : dir.string(), true);
+}
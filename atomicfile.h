@@ -0,0 +1,10 @@
+#pragma once
+#include <functional>
+#include <ostream>
+#include <string>
+
+// Записывает файл через временный файл рядом с ним: данные сбрасываются на
+// диск (fsync), после чего временный файл переименованием подменяет прежний.
+// На диске всегда лежит либо старая, либо новая версия целиком.
+void writeFileAtomically(const std::string& filename,
+                         const std::function<void(std::ostream&)>& write);
@@ -0,0 +1,32 @@
+#pragma once
+#include <random>
+#include <string>
+#include "scrumboard.h"
+#include "task.h"
+
+// Данные для замеров, общие для всех файлов kanban_bench. Генератор с
+// фиксированным зерном: прогоны на разных машинах меряют одно и то же.
+
+// Четверть задач в бэклоге, остальные назначены на одного из developers
+// разработчиков и равномерно распределены по статусам.
+inline Task makeTask(int id, std::mt19937& rng, int developers = 50) {
+    Task task(id, "Задача " + std::to_string(id), "Описание задачи номер " + std::to_string(id));
+    if (rng() % 4 != 0) {
+        task.assignDeveloper((int)(rng() % (unsigned)developers) + 1);
+        static const TaskStatus statuses[] = {
+            TaskStatus::Assigned, TaskStatus::InProgress, TaskStatus::Blocked, TaskStatus::Done
+        };
+        task.changeStatus(statuses[rng() % 4]);
+    }
+    return task;
+}
+
+inline ScrumBoard makeBoard(int count, int developers = 50) {
+    std::mt19937 rng(42);
+    ScrumBoard board;
+    for (int id = 1; id <= developers; ++id) board.addDeveloper(Developer(id, "Разработчик " + std::to_string(id)));
+    for (int id = 1; id <= count; ++id) board.addTask(makeTask(id, rng, developers));
+    board.setNextDeveloperId(developers + 1);
+    board.setNextTaskId(count + 1);
+    return board;
+}
@@ -0,0 +1,702 @@
+#include <benchmark/benchmark.h>
+
+#include "benchboards.h"
+#include "task.h"
+#include "taskstore.h"
+#include "textpool.h"
+#include "scrumboard.h"
+#include "boardhistory.h"
+#include "boardserializer.h"
+#include "boardsnapshot.h"
+#include "boardworkspace.h"
+#include "taskimporter.h"
+#include "tasksearchindex.h"
+#include "metrics.h"
+#include "taskutils.h"
+#include "tracing.h"
+
+#include <algorithm>
+#include <cstdio>
+#include <filesystem>
+#include <map>
+#include <memory>
+#include <random>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+// Прежняя раскладка ScrumBoard (узел красно-чёрного дерева на задачу)
+// для сравнения с TaskStore на тех же данных.
+using MapTaskStorage = std::map<int, Task>;
+
+static MapTaskStorage makeMapStorage(int count) {
+    std::mt19937 rng(42);
+    MapTaskStorage tasks;
+    for (int id = 1; id <= count; ++id) tasks.emplace(id, makeTask(id, rng));
+    return tasks;
+}
+
+static TaskStore makeTaskStore(int count) {
+    std::mt19937 rng(42);
+    TaskStore store;
+    store.reserve((size_t)count);
+    for (int id = 1; id <= count; ++id) store.insert(makeTask(id, rng));
+    return store;
+}
+
+static std::vector<int> makeLookupIds(int count) {
+    std::mt19937 rng(7);
+    std::vector<int> ids(4096);
+    for (int& id : ids) id = (int)(rng() % (unsigned)count) + 1;
+    return ids;
+}
+
+static void BM_MapScanByStatus(benchmark::State& state) {
+    MapTaskStorage tasks = makeMapStorage((int)state.range(0));
+    for (auto _ : state) {
+        size_t inProgress = 0;
+        for (const auto& [id, task] : tasks) {
+            if (task.status() == TaskStatus::InProgress) ++inProgress;
+        }
+        benchmark::DoNotOptimize(inProgress);
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+static void BM_StoreScanByStatus(benchmark::State& state) {
+    TaskStore store = makeTaskStore((int)state.range(0));
+    for (auto _ : state) {
+        size_t inProgress = 0;
+        for (TaskStatus status : store.statuses()) {
+            if (status == TaskStatus::InProgress) ++inProgress;
+        }
+        benchmark::DoNotOptimize(inProgress);
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+static void BM_MapScanByAssignee(benchmark::State& state) {
+    MapTaskStorage tasks = makeMapStorage((int)state.range(0));
+    for (auto _ : state) {
+        size_t owned = 0;
+        for (const auto& [id, task] : tasks) {
+            if (task.assignedDeveloper() && *task.assignedDeveloper() == 7) ++owned;
+        }
+        benchmark::DoNotOptimize(owned);
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+static void BM_StoreScanByAssignee(benchmark::State& state) {
+    TaskStore store = makeTaskStore((int)state.range(0));
+    for (auto _ : state) {
+        size_t owned = 0;
+        for (int dev : store.assignees()) {
+            if (dev == 7) ++owned;
+        }
+        benchmark::DoNotOptimize(owned);
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+static void BM_MapLookup(benchmark::State& state) {
+    MapTaskStorage tasks = makeMapStorage((int)state.range(0));
+    std::vector<int> ids = makeLookupIds((int)state.range(0));
+    for (auto _ : state) {
+        int sum = 0;
+        for (int id : ids) sum += (int)tasks.find(id)->second.status();
+        benchmark::DoNotOptimize(sum);
+    }
+    state.SetItemsProcessed(state.iterations() * (int64_t)ids.size());
+}
+
+static void BM_StoreLookup(benchmark::State& state) {
+    TaskStore store = makeTaskStore((int)state.range(0));
+    std::vector<int> ids = makeLookupIds((int)state.range(0));
+    for (auto _ : state) {
+        int sum = 0;
+        for (int id : ids) sum += (int)store.status(store.find(id));
+        benchmark::DoNotOptimize(sum);
+    }
+    state.SetItemsProcessed(state.iterations() * (int64_t)ids.size());
+}
+
+// Текст, похожий на реальные доски: заголовки часто повторяются,
+// у части задач описание шаблонное, у остальных уникальное.
+static std::vector<std::pair<std::string, std::string>> makeTaskTexts(int count) {
+    std::mt19937 rng(3);
+    std::vector<std::pair<std::string, std::string>> texts;
+    texts.reserve((size_t)count);
+    for (int i = 0; i < count; ++i) {
+        std::string title = "Исправить ошибку в модуле " + std::to_string(rng() % 500);
+        std::string description = (rng() % 2)
+            ? std::string("Воспроизвести, исправить, добавить тест")
+            : "Подробности в обращении пользователя номер " + std::to_string(i) + ", приоритет средний";
+        texts.emplace_back(std::move(title), std::move(description));
+    }
+    return texts;
+}
+
+static size_t heapBytes(const std::string& s) {
+    // Короткие строки живут внутри объекта (SSO) и кучу не занимают.
+    return s.capacity() > 15 ? s.capacity() + 1 : 0;
+}
+
+static void BM_TextStdStrings(benchmark::State& state) {
+    auto texts = makeTaskTexts((int)state.range(0));
+    size_t bytes = 0;
+    for (auto _ : state) {
+        std::vector<std::pair<std::string, std::string>> stored;
+        stored.reserve(texts.size());
+        for (const auto& [title, description] : texts) stored.emplace_back(title, description);
+
+        state.PauseTiming();
+        bytes = stored.capacity() * sizeof(stored[0]);
+        for (const auto& [title, description] : stored) bytes += heapBytes(title) + heapBytes(description);
+        state.ResumeTiming();
+    }
+    state.counters["bytes"] = (double)bytes;
+    state.counters["bytes_per_task"] = (double)bytes / (double)state.range(0);
+}
+
+static void BM_TextPool(benchmark::State& state) {
+    auto texts = makeTaskTexts((int)state.range(0));
+    size_t bytes = 0;
+    for (auto _ : state) {
+        TextPool pool;
+        std::vector<std::pair<TextPool::Handle, TextPool::Handle>> stored;
+        stored.reserve(texts.size());
+        for (const auto& [title, description] : texts) {
+            stored.emplace_back(pool.intern(title), pool.intern(description));
+        }
+        bytes = pool.memoryUsage() + stored.capacity() * sizeof(stored[0]);
+    }
+    state.counters["bytes"] = (double)bytes;
+    state.counters["bytes_per_task"] = (double)bytes / (double)state.range(0);
+}
+
+static std::string benchFile(const char* name, int count) {
+    return (std::filesystem::temp_directory_path() / (std::string(name) + std::to_string(count))).string();
+}
+
+static void BM_JsonLoad(benchmark::State& state) {
+    std::string path = benchFile("kanban_bench.json.", (int)state.range(0));
+    saveBoardToFile(makeBoard((int)state.range(0)), path, JsonFormat::Compact);
+    for (auto _ : state) {
+        ScrumBoard board = loadBoardFromFile(path);
+        benchmark::DoNotOptimize(board.getAllTasks().size());
+    }
+    std::remove(path.c_str());
+}
+
+static void BM_JsonSave(benchmark::State& state) {
+    std::string path = benchFile("kanban_bench.json.", (int)state.range(0));
+    ScrumBoard board = makeBoard((int)state.range(0));
+    for (auto _ : state) saveBoardToFile(board, path, JsonFormat::Compact);
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+    std::remove(path.c_str());
+}
+
+// Открытие снимка: отображение файла, проверка заголовка и контрольной суммы.
+static void BM_SnapshotOpen(benchmark::State& state) {
+    std::string path = benchFile("kanban_bench.kbsnap.", (int)state.range(0));
+    saveBoardSnapshot(makeBoard((int)state.range(0)), path);
+    for (auto _ : state) {
+        BoardSnapshot snap = BoardSnapshot::open(path);
+        benchmark::DoNotOptimize(snap.findTask((int)state.range(0) / 2));
+    }
+    std::remove(path.c_str());
+}
+
+static void BM_SnapshotToBoard(benchmark::State& state) {
+    std::string path = benchFile("kanban_bench.kbsnap.", (int)state.range(0));
+    saveBoardSnapshot(makeBoard((int)state.range(0)), path);
+    for (auto _ : state) {
+        ScrumBoard board = loadBoardSnapshot(path);
+        benchmark::DoNotOptimize(board.getAllTasks().size());
+    }
+    std::remove(path.c_str());
+}
+
+static std::string boardJson(int count) {
+    std::ostringstream out;
+    BoardSerializer::write(makeBoard(count), out, JsonFormat::Compact);
+    return out.str();
+}
+
+// Разбор из памяти: последовательный потоковый и параллельный на range(1) потоках.
+static void BM_JsonRead(benchmark::State& state) {
+    std::string json = boardJson((int)state.range(0));
+    for (auto _ : state) {
+        std::istringstream in(json);
+        ScrumBoard board = BoardSerializer::read(in);
+        benchmark::DoNotOptimize(board.getAllTasks().size());
+    }
+    state.SetBytesProcessed(state.iterations() * (int64_t)json.size());
+}
+
+static void BM_JsonReadParallel(benchmark::State& state) {
+    std::string json = boardJson((int)state.range(0));
+    for (auto _ : state) {
+        ScrumBoard board = BoardSerializer::readParallel(json, (unsigned)state.range(1));
+        benchmark::DoNotOptimize(board.getAllTasks().size());
+    }
+    state.SetBytesProcessed(state.iterations() * (int64_t)json.size());
+}
+
+// Переключение между двумя досками рабочего пространства. Второй аргумент:
+// 0 — бюджет памяти нулевой, каждая доска загружается из снимка заново;
+// 1 — обе доски остаются в памяти.
+static void BM_WorkspaceSwitch(benchmark::State& state) {
+    std::string dir = benchFile("kanban_bench_workspace.", (int)state.range(0));
+    std::filesystem::remove_all(dir);
+    std::filesystem::create_directories(dir);
+    for (const char* name : {"a", "b"}) {
+        saveBoardSnapshot(makeBoard((int)state.range(0)), dir + "/" + name + BoardWorkspace::kExtension);
+    }
+    {
+        ScrumBoard active;
+        BoardWorkspace workspace(active, dir, state.range(1) ? BoardWorkspace::kDefaultMemoryBudget : 0);
+        for (std::size_t i : {0, 1}) {
+            if (!workspace.activate(i)) workspace.loadStep();
+        }
+        std::size_t next = 0;
+        for (auto _ : state) {
+            if (!workspace.activate(next)) workspace.loadStep();
+            benchmark::DoNotOptimize(active.getAllTasks().size());
+            next ^= 1;
+        }
+    }
+    std::filesystem::remove_all(dir);
+}
+
+// Загрузка с заменой текущей доски: старая доска разрушается внутри цикла,
+// как при повторной загрузке в MainWindow. Второй аргумент: 0 — память
+// частей, 1 — арена доски.
+static void BM_BoardLoadReplace(benchmark::State& state) {
+    std::string json = boardJson((int)state.range(0));
+    BoardStorage storage = state.range(1) ? BoardStorage::Arena : BoardStorage::Shared;
+    ScrumBoard board;
+    for (auto _ : state) {
+        std::istringstream in(json);
+        board.replaceWith(BoardSerializer::read(in, storage));
+        benchmark::DoNotOptimize(board.getAllTasks().size());
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+static void BM_BoardDestroy(benchmark::State& state) {
+    std::string json = boardJson((int)state.range(0));
+    BoardStorage storage = state.range(1) ? BoardStorage::Arena : BoardStorage::Shared;
+    for (auto _ : state) {
+        state.PauseTiming();
+        std::istringstream in(json);
+        auto board = std::make_unique<ScrumBoard>(BoardSerializer::read(in, storage));
+        state.ResumeTiming();
+        board.reset();
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+static void BM_JsonWrite(benchmark::State& state) {
+    ScrumBoard board = makeBoard((int)state.range(0));
+    size_t bytes = 0;
+    for (auto _ : state) {
+        std::ostringstream out;
+        BoardSerializer::write(board, out, JsonFormat::Compact);
+        bytes = (size_t)out.tellp();
+    }
+    state.SetBytesProcessed(state.iterations() * (int64_t)bytes);
+}
+
+static void BM_JsonWriteParallel(benchmark::State& state) {
+    ScrumBoard board = makeBoard((int)state.range(0));
+    size_t bytes = 0;
+    for (auto _ : state) {
+        std::ostringstream out;
+        BoardSerializer::writeParallel(board, out, JsonFormat::Compact, (unsigned)state.range(1));
+        bytes = (size_t)out.tellp();
+    }
+    state.SetBytesProcessed(state.iterations() * (int64_t)bytes);
+}
+
+// Задачи для импорта; при range(1) != 0 ID идут в случайном порядке.
+static std::vector<Task> makeImportTasks(const benchmark::State& state) {
+    std::mt19937 rng(42);
+    std::vector<Task> tasks;
+    tasks.reserve((size_t)state.range(0));
+    for (int id = 1; id <= (int)state.range(0); ++id) tasks.push_back(makeTask(id, rng));
+    if (state.range(1)) std::shuffle(tasks.begin(), tasks.end(), rng);
+    return tasks;
+}
+
+static ScrumBoard makeImportTarget() {
+    ScrumBoard board;
+    for (int id = 1; id <= 50; ++id) board.addDeveloper(Developer(id, "Разработчик " + std::to_string(id)));
+    return board;
+}
+
+static void BM_AddTaskLoop(benchmark::State& state) {
+    std::vector<Task> tasks = makeImportTasks(state);
+    for (auto _ : state) {
+        ScrumBoard board = makeImportTarget();
+        for (const Task& task : tasks) board.addTask(task);
+        benchmark::DoNotOptimize(board.getAllTasks().size());
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+static void BM_AddTasksBulk(benchmark::State& state) {
+    std::vector<Task> tasks = makeImportTasks(state);
+    for (auto _ : state) {
+        ScrumBoard board = makeImportTarget();
+        board.addTasks(tasks);
+        benchmark::DoNotOptimize(board.getAllTasks().size());
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+// Операции над доской из range(0) задач и range(1) разработчиков. Операции
+// идут пачками по kBoardOps, чтобы паузы таймера на восстановление доски
+// не искажали замер.
+constexpr int kBoardOps = 256;
+
+static std::vector<int> randomTaskIds(const ScrumBoard& board, std::size_t count, unsigned seed) {
+    std::vector<int> ids;
+    for (const TaskView& task : board.getAllTasks()) ids.push_back(task.id());
+    std::shuffle(ids.begin(), ids.end(), std::mt19937(seed));
+    if (ids.size() > count) ids.resize(count);
+    return ids;
+}
+
+static void BM_BoardAddTask(benchmark::State& state) {
+    int count = (int)state.range(0);
+    ScrumBoard board = makeBoard(count, (int)state.range(1));
+    std::mt19937 rng(11);
+    std::vector<Task> added;
+    for (int i = 1; i <= kBoardOps; ++i) added.push_back(makeTask(count + i, rng, (int)state.range(1)));
+
+    for (auto _ : state) {
+        for (const Task& task : added) board.addTask(task);
+        state.PauseTiming();
+        for (const Task& task : added) board.removeTask(task.id());
+        state.ResumeTiming();
+    }
+    state.SetItemsProcessed(state.iterations() * kBoardOps);
+}
+
+static void BM_BoardRemoveTask(benchmark::State& state) {
+    ScrumBoard board = makeBoard((int)state.range(0), (int)state.range(1));
+    std::vector<Task> removed;
+    for (int id : randomTaskIds(board, kBoardOps, 12)) {
+        TaskView view = board.getTask(id);
+        Task& task = removed.emplace_back(id, std::string(view.title()), std::string(view.description()));
+        if (view.assignedDeveloper()) task.assignDeveloper(*view.assignedDeveloper());
+        task.changeStatus(view.status());
+    }
+
+    for (auto _ : state) {
+        for (const Task& task : removed) board.removeTask(task.id());
+        state.PauseTiming();
+        for (const Task& task : removed) board.addTask(task);
+        state.ResumeTiming();
+    }
+    state.SetItemsProcessed(state.iterations() * (int64_t)removed.size());
+}
+
+static void BM_BoardAssignTask(benchmark::State& state) {
+    int developers = (int)state.range(1);
+    ScrumBoard board = makeBoard((int)state.range(0), developers);
+    std::vector<int> ids = randomTaskIds(board, kBoardOps, 13);
+    std::mt19937 rng(14);
+    for (auto _ : state) {
+        for (int id : ids) board.assignTask(id, (int)(rng() % (unsigned)developers) + 1);
+    }
+    state.SetItemsProcessed(state.iterations() * (int64_t)ids.size());
+}
+
+// Задачи ходят между «В работе» и «Заблокирована»: оба перехода разрешены.
+static void BM_BoardChangeStatus(benchmark::State& state) {
+    ScrumBoard board = makeBoard((int)state.range(0), (int)state.range(1));
+    std::vector<int> ids;
+    for (TaskStatus status : {TaskStatus::InProgress, TaskStatus::Blocked}) {
+        for (int id : board.taskIdsByStatus(status)) ids.push_back(id);
+    }
+    std::shuffle(ids.begin(), ids.end(), std::mt19937(15));
+    if (ids.size() > (std::size_t)kBoardOps) ids.resize(kBoardOps);
+
+    for (auto _ : state) {
+        for (int id : ids) {
+            bool blocked = board.getTask(id).status() == TaskStatus::Blocked;
+            board.changeTaskStatus(id, blocked ? TaskStatus::InProgress : TaskStatus::Blocked);
+        }
+    }
+    state.SetItemsProcessed(state.iterations() * (int64_t)ids.size());
+}
+
+static void BM_BoardAddRemoveDeveloper(benchmark::State& state) {
+    ScrumBoard board = makeBoard((int)state.range(0), (int)state.range(1));
+    int first = board.getNextDeveloperId();
+    for (auto _ : state) {
+        for (int i = 0; i < kBoardOps; ++i) board.addDeveloper(Developer(first + i, "Новый разработчик"));
+        for (int i = 0; i < kBoardOps; ++i) board.removeDeveloper(first + i);
+    }
+    state.SetItemsProcessed(state.iterations() * kBoardOps);
+}
+
+// Задачи и разработчики от 100 до 1M.
+static void BoardSizes(benchmark::internal::Benchmark* b) {
+    b->ArgNames({"tasks", "developers"});
+    b->ArgsProduct({{100, 10000, 1000000}, {100, 1000000}});
+}
+
+static std::string importCsv(int count) {
+    std::mt19937 rng(42);
+    std::ostringstream out;
+    out << "id,title,description,status,assignee\n";
+    for (int id = 1; id <= count; ++id) {
+        Task task = makeTask(id, rng);
+        out << id << ",\"" << task.title() << "\",\"" << task.description() << "\","
+            << taskStatusToString(task.status()) << ",";
+        if (task.assignedDeveloper()) out << *task.assignedDeveloper();
+        out << "\n";
+    }
+    return out.str();
+}
+
+static std::string importJsonLines(int count) {
+    std::mt19937 rng(42);
+    std::ostringstream out;
+    for (int id = 1; id <= count; ++id) {
+        Task task = makeTask(id, rng);
+        nlohmann::json line = {
+            {"id", id}, {"title", task.title()}, {"description", task.description()},
+            {"status", taskStatusToString(task.status())}
+        };
+        if (task.assignedDeveloper()) line["assignedDeveloperId"] = *task.assignedDeveloper();
+        out << line.dump() << "\n";
+    }
+    return out.str();
+}
+
+static void BM_ImportCsv(benchmark::State& state) {
+    std::string text = importCsv((int)state.range(0));
+    for (auto _ : state) {
+        ScrumBoard board = makeImportTarget();
+        std::istringstream in(text);
+        benchmark::DoNotOptimize(importTasksFromCsv(board, in));
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+    state.SetBytesProcessed(state.iterations() * (int64_t)text.size());
+}
+
+static void BM_ImportJsonLines(benchmark::State& state) {
+    std::string text = importJsonLines((int)state.range(0));
+    for (auto _ : state) {
+        ScrumBoard board = makeImportTarget();
+        std::istringstream in(text);
+        benchmark::DoNotOptimize(importTasksFromJsonLines(board, in));
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+    state.SetBytesProcessed(state.iterations() * (int64_t)text.size());
+}
+
+// Перетаскивание неназначенных задач в «В работе»: каждый переход отклоняется.
+static ScrumBoard makeUnassignedBoard(int count) {
+    ScrumBoard board;
+    for (int id = 1; id <= count; ++id) board.addTask(Task(id, "Задача " + std::to_string(id), ""));
+    return board;
+}
+
+static void BM_RejectedTransitionThrow(benchmark::State& state) {
+    ScrumBoard board = makeUnassignedBoard((int)state.range(0));
+    for (auto _ : state) {
+        int rejected = 0;
+        for (int id = 1; id <= (int)state.range(0); ++id) {
+            try {
+                board.changeTaskStatus(id, TaskStatus::InProgress);
+            } catch (const std::logic_error&) {
+                ++rejected;
+            }
+        }
+        benchmark::DoNotOptimize(rejected);
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+static void BM_RejectedTransitionTry(benchmark::State& state) {
+    ScrumBoard board = makeUnassignedBoard((int)state.range(0));
+    for (auto _ : state) {
+        int rejected = 0;
+        for (int id = 1; id <= (int)state.range(0); ++id) {
+            if (board.tryChangeTaskStatus(id, TaskStatus::InProgress) != BoardError::None) ++rejected;
+        }
+        benchmark::DoNotOptimize(rejected);
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+static void BM_SearchIndexBuild(benchmark::State& state) {
+    ScrumBoard board = makeBoard((int)state.range(0));
+    std::size_t bytes = 0;
+    for (auto _ : state) {
+        TaskSearchIndex index(board);
+        bytes = index.memoryUsage();
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+    state.counters["index_bytes"] = (double)bytes;
+    state.counters["bytes_per_task"] = (double)bytes / (double)state.range(0);
+}
+
+// Доска и индекс на 1M задач строятся один раз на все замеры поиска.
+static TaskSearchIndex& searchIndex() {
+    static ScrumBoard board = makeBoard(1000000);
+    static TaskSearchIndex index(board);
+    return index;
+}
+
+// Запрос, каким ищут конкретную задачу: общее слово и префикс номера.
+static void BM_SearchSelective(benchmark::State& state) {
+    TaskSearchIndex& index = searchIndex();
+    std::mt19937 rng(1);
+    std::size_t found = 0;
+    for (auto _ : state) {
+        std::string query = "номер " + std::to_string(100000 + rng() % 900000);
+        found += index.search(query)->size();
+    }
+    state.counters["found"] = (double)found / (double)state.iterations();
+    state.counters["index_bytes"] = (double)index.memoryUsage();
+}
+
+// Префикс из первых букв, которые успевает набрать пользователь.
+static void BM_SearchShortPrefix(benchmark::State& state) {
+    TaskSearchIndex& index = searchIndex();
+    const char* queries[] = {"зад 42", "опис 777", "12345"};
+    std::size_t i = 0, found = 0;
+    for (auto _ : state) found += index.search(queries[i++ % 3])->size();
+    state.counters["found"] = (double)found / (double)state.iterations();
+}
+
+// Для сравнения: то же без индекса, проходом по описаниям всех задач.
+static void BM_SearchLinearScan(benchmark::State& state) {
+    static ScrumBoard board = makeBoard(1000000);
+    std::mt19937 rng(1);
+    for (auto _ : state) {
+        std::string number = std::to_string(100000 + rng() % 900000);
+        std::size_t found = 0;
+        for (const TaskView& task : board.getAllTasks()) {
+            if (task.description().find(number) != std::string_view::npos) ++found;
+        }
+        benchmark::DoNotOptimize(found);
+    }
+}
+
+// Шаг правки с историей: снимок доски и смена статуса одной задачи, затем
+// отмена. Время и память шага не должны зависеть от размера доски.
+static void BM_UndoStep(benchmark::State& state) {
+    ScrumBoard board = makeBoard((int)state.range(0));
+    std::vector<int> ids;
+    for (TaskStatus status : {TaskStatus::InProgress, TaskStatus::Blocked}) {
+        std::vector<int> byStatus = board.getTaskIdsByStatus(status);
+        ids.insert(ids.end(), byStatus.begin(), byStatus.end());
+    }
+    std::shuffle(ids.begin(), ids.end(), std::mt19937(3));
+
+    BoardHistory history(board);
+    std::size_t i = 0;
+    for (auto _ : state) {
+        int id = ids[i++ % ids.size()];
+        bool blocked = board.getTask(id).status() == TaskStatus::Blocked;
+        board.changeTaskStatus(id, blocked ? TaskStatus::InProgress : TaskStatus::Blocked);
+        history.undo();
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+
+// Цена участка трассы: 0 — запись выключена (одна атомарная загрузка),
+// 1 — событие пишется в кольцо потока.
+static void BM_TraceScope(benchmark::State& state) {
+    if (state.range(0)) tracing::start();
+    for (auto _ : state) {
+        tracing::Scope scope("BM_TraceScope");
+        benchmark::ClobberMemory();
+    }
+    tracing::stop();
+    state.SetItemsProcessed(state.iterations());
+}
+
+// Показатели включены всегда: цена записи в гистограмму и замера времени.
+static void BM_HistogramRecord(benchmark::State& state) {
+    metrics::Histogram histogram;
+    std::uint64_t value = 1;
+    for (auto _ : state) {
+        histogram.record(value);
+        value = value * 6364136223846793005ull + 1442695040888963407ull;
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+
+static void BM_MetricsTimer(benchmark::State& state) {
+    metrics::Histogram histogram;
+    for (auto _ : state) {
+        metrics::Timer timer(histogram);
+        benchmark::ClobberMemory();
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+
+// Масштабирование: 1, 2, 4, ... потоков до числа ядер.
+static void ThreadScaling(benchmark::internal::Benchmark* b) {
+    unsigned cores = std::max(std::thread::hardware_concurrency(), 1u);
+    for (int tasks : {10000, 200000, 1000000}) {
+        for (unsigned threads = 1; threads < cores; threads *= 2) b->Args({tasks, (int)threads});
+        b->Args({tasks, (int)cores});
+    }
+}
+
+BENCHMARK(BM_MapScanByStatus)->RangeMultiplier(10)->Range(1000, 1000000);
+BENCHMARK(BM_StoreScanByStatus)->RangeMultiplier(10)->Range(1000, 1000000);
+BENCHMARK(BM_MapScanByAssignee)->RangeMultiplier(10)->Range(1000, 1000000);
+BENCHMARK(BM_StoreScanByAssignee)->RangeMultiplier(10)->Range(1000, 1000000);
+BENCHMARK(BM_MapLookup)->RangeMultiplier(10)->Range(1000, 1000000);
+BENCHMARK(BM_StoreLookup)->RangeMultiplier(10)->Range(1000, 1000000);
+BENCHMARK(BM_TextStdStrings)->RangeMultiplier(10)->Range(1000, 1000000)->Unit(benchmark::kMillisecond);
+BENCHMARK(BM_TextPool)->RangeMultiplier(10)->Range(1000, 1000000)->Unit(benchmark::kMillisecond);
+
+BENCHMARK(BM_JsonSave)->RangeMultiplier(10)->Range(100, 1000000)->Unit(benchmark::kMillisecond);
+BENCHMARK(BM_JsonLoad)->RangeMultiplier(10)->Range(100, 1000000)->Unit(benchmark::kMillisecond);
+BENCHMARK(BM_SnapshotOpen)->RangeMultiplier(10)->Range(1000, 1000000)->Unit(benchmark::kMillisecond);
+BENCHMARK(BM_SnapshotToBoard)->RangeMultiplier(10)->Range(1000, 1000000)->Unit(benchmark::kMillisecond);
+
+BENCHMARK(BM_BoardAddTask)->Apply(BoardSizes)->Unit(benchmark::kMicrosecond);
+BENCHMARK(BM_BoardRemoveTask)->Apply(BoardSizes)->Unit(benchmark::kMicrosecond);
+BENCHMARK(BM_BoardAssignTask)->Apply(BoardSizes)->Unit(benchmark::kMicrosecond);
+BENCHMARK(BM_BoardChangeStatus)->Apply(BoardSizes)->Unit(benchmark::kMicrosecond);
+BENCHMARK(BM_BoardAddRemoveDeveloper)->Apply(BoardSizes)->Unit(benchmark::kMicrosecond);
+BENCHMARK(BM_AddTaskLoop)->ArgsProduct({{10000, 100000, 500000}, {0, 1}})->Unit(benchmark::kMillisecond);
+BENCHMARK(BM_AddTasksBulk)->ArgsProduct({{10000, 100000, 500000}, {0, 1}})->Unit(benchmark::kMillisecond);
+BENCHMARK(BM_SearchIndexBuild)->Arg(100000)->Arg(1000000)->Unit(benchmark::kMillisecond);
+BENCHMARK(BM_SearchSelective)->Unit(benchmark::kMicrosecond);
+BENCHMARK(BM_SearchShortPrefix)->Unit(benchmark::kMicrosecond);
+BENCHMARK(BM_SearchLinearScan)->Unit(benchmark::kMillisecond);
+
+BENCHMARK(BM_UndoStep)->RangeMultiplier(10)->Range(10000, 1000000)->Unit(benchmark::kMicrosecond);
+BENCHMARK(BM_TraceScope)->Arg(0)->Arg(1);
+BENCHMARK(BM_HistogramRecord);
+BENCHMARK(BM_MetricsTimer);
+
+BENCHMARK(BM_RejectedTransitionThrow)->Arg(1000)->Arg(100000);
+BENCHMARK(BM_RejectedTransitionTry)->Arg(1000)->Arg(100000);
+BENCHMARK(BM_ImportCsv)->Arg(10000)->Arg(100000)->Unit(benchmark::kMillisecond);
+BENCHMARK(BM_ImportJsonLines)->Arg(10000)->Arg(100000)->Unit(benchmark::kMillisecond);
+
+BENCHMARK(BM_JsonRead)->RangeMultiplier(10)->Range(100, 1000000)->Unit(benchmark::kMillisecond);
+BENCHMARK(BM_JsonReadParallel)->Apply(ThreadScaling)->Unit(benchmark::kMillisecond)->UseRealTime();
+BENCHMARK(BM_WorkspaceSwitch)->ArgsProduct({{10000, 100000}, {0, 1}})->Unit(benchmark::kMillisecond);
+BENCHMARK(BM_BoardLoadReplace)->ArgsProduct({{100000, 1000000}, {0, 1}})->Unit(benchmark::kMillisecond);
+BENCHMARK(BM_BoardDestroy)->ArgsProduct({{100000, 1000000}, {0, 1}})->Unit(benchmark::kMillisecond);
+BENCHMARK(BM_JsonWrite)->RangeMultiplier(10)->Range(100, 1000000)->Unit(benchmark::kMillisecond);
+BENCHMARK(BM_JsonWriteParallel)->Apply(ThreadScaling)->Unit(benchmark::kMillisecond)->UseRealTime();
+
+BENCHMARK_MAIN();
@@ -0,0 +1,106 @@
+#include <benchmark/benchmark.h>
+
+#include "benchboards.h"
+#include "boardcolumnmodel.h"
+#include "taskitemformat.h"
+
+#include <algorithm>
+#include <memory>
+#include <random>
+#include <vector>
+
+// Замеры представления без окна: модели колонок и строки списка работают
+// без QApplication, так что kanban_bench запускается и на сервере сборки.
+
+// Строки запрашиваются для видимой части списка, не для всей колонки.
+constexpr int kVisibleRows = 50;
+
+static std::vector<int> sampleTaskIds(int count) {
+    std::mt19937 rng(7);
+    std::vector<int> ids(4096);
+    for (int& id : ids) id = (int)(rng() % (unsigned)count) + 1;
+    return ids;
+}
+
+static void BM_MakeTitleLine(benchmark::State& state) {
+    ScrumBoard board = makeBoard((int)state.range(0), (int)state.range(1));
+    std::vector<int> ids = sampleTaskIds((int)state.range(0));
+    for (auto _ : state) {
+        for (int id : ids) benchmark::DoNotOptimize(TaskItemFormat::makeTitleLine(board, board.getTask(id)));
+    }
+    state.SetItemsProcessed(state.iterations() * (int64_t)ids.size());
+}
+
+// То же с кешем имён, как строки строит BoardColumnModel.
+static void BM_MakeTitleLineCached(benchmark::State& state) {
+    ScrumBoard board = makeBoard((int)state.range(0), (int)state.range(1));
+    TaskItemFormat::DeveloperNameCache names(board);
+    std::vector<int> ids = sampleTaskIds((int)state.range(0));
+    for (auto _ : state) {
+        for (int id : ids) benchmark::DoNotOptimize(TaskItemFormat::makeTitleLine(names, board.getTask(id)));
+    }
+    state.SetItemsProcessed(state.iterations() * (int64_t)ids.size());
+}
+
+// Колонки главного окна над одной доской.
+struct BoardColumns {
+    explicit BoardColumns(ScrumBoard& board) : names(board) {
+        columns.push_back(std::make_unique<BoardColumnModel>(
+            board, names, std::vector<TaskStatus>{ TaskStatus::Backlog, TaskStatus::Assigned }));
+        columns.push_back(std::make_unique<BoardColumnModel>(
+            board, names, std::vector<TaskStatus>{ TaskStatus::InProgress, TaskStatus::Blocked }));
+        columns.push_back(std::make_unique<BoardColumnModel>(
+            board, names, std::vector<TaskStatus>{ TaskStatus::Done }));
+    }
+
+    // То, что после обновления запросит видимая часть списков.
+    void paint() const {
+        for (const auto& column : columns) {
+            int rows = std::min(column->rowCount(), kVisibleRows);
+            for (int row = 0; row < rows; ++row) {
+                benchmark::DoNotOptimize(column->data(column->index(row)));
+            }
+        }
+    }
+
+    TaskItemFormat::DeveloperNameCache names;
+    std::vector<std::unique_ptr<BoardColumnModel>> columns;
+};
+
+// Полное обновление после загрузки: сброс доски, перестройка колонок
+// и строки для видимых задач.
+static void BM_BoardRefresh(benchmark::State& state) {
+    ScrumBoard loaded = makeBoard((int)state.range(0), (int)state.range(1));
+    ScrumBoard board;
+    BoardColumns columns(board);
+    for (auto _ : state) {
+        board.replaceWith(loaded);
+        columns.paint();
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+// Перетаскивание группы задач между колонками: одно пакетное изменение.
+static void BM_BoardRefreshBatch(benchmark::State& state) {
+    ScrumBoard board = makeBoard((int)state.range(0), (int)state.range(1));
+    std::vector<int> ids = board.getTaskIdsByStatus(TaskStatus::Assigned);
+    if (ids.size() > 256) ids.resize(256);
+    BoardColumns columns(board);
+    bool started = false;
+    for (auto _ : state) {
+        started = !started;
+        board.changeTaskStatuses(ids, started ? TaskStatus::InProgress : TaskStatus::Assigned);
+        columns.paint();
+    }
+    state.SetItemsProcessed(state.iterations() * (int64_t)ids.size());
+}
+
+static void ViewSizes(benchmark::internal::Benchmark* b) {
+    b->ArgNames({"tasks", "developers"});
+    b->ArgsProduct({{100, 10000, 1000000}, {100, 1000000}});
+}
+
+BENCHMARK(BM_MakeTitleLine)->Apply(ViewSizes)->Unit(benchmark::kMicrosecond);
+BENCHMARK(BM_MakeTitleLineCached)->Apply(ViewSizes)->Unit(benchmark::kMicrosecond);
+BENCHMARK(BM_BoardRefresh)->Apply(ViewSizes)->Unit(benchmark::kMillisecond);
+BENCHMARK(BM_BoardRefreshBatch)->Apply(ViewSizes)->Unit(benchmark::kMicrosecond);
@@ -0,0 +1,62 @@
+#pragma once
+#include <functional>
+#include <utility>
+#include <vector>
+#include "taskstatus.h"
+
+struct BoardChange {
+    enum class Kind {
+        TaskAdded,
+        TaskRemoved,
+        TaskStatusChanged,
+        TaskAssigned,
+        DeveloperAdded,
+        DeveloperRemoved,
+        Reset,
+        BatchBegin,     // изменения между BatchBegin и BatchEnd относятся к одной операции
+        BatchEnd
+    };
+
+    Kind kind;
+    int id = 0;                                 // ID задачи или разработчика
+    TaskStatus oldStatus = TaskStatus::Backlog;
+    TaskStatus newStatus = TaskStatus::Backlog;
+};
+
+using BoardChangeListener = std::function<void(const BoardChange&)>;
+
+// Подписчики принадлежат конкретному объекту доски, а не её содержимому:
+// при копировании доски они не копируются, при присваивании остаются прежними.
+class BoardChangeListeners {
+public:
+    BoardChangeListeners() = default;
+    BoardChangeListeners(const BoardChangeListeners&) {}
+    BoardChangeListeners(BoardChangeListeners&&) noexcept {}
+    BoardChangeListeners& operator=(const BoardChangeListeners&) { return *this; }
+    BoardChangeListeners& operator=(BoardChangeListeners&&) noexcept { return *this; }
+
+    int add(BoardChangeListener listener) {
+        int token = nextToken_++;
+        listeners_.emplace_back(token, std::move(listener));
+        return token;
+    }
+
+    void remove(int token) {
+        for (auto it = listeners_.begin(); it != listeners_.end(); ++it) {
+            if (it->first == token) {
+                listeners_.erase(it);
+                return;
+            }
+        }
+    }
+
+    void notify(const BoardChange& change) const {
+        for (const auto& entry : listeners_) {
+            entry.second(change);
+        }
+    }
+
+private:
+    std::vector<std::pair<int, BoardChangeListener>> listeners_;
+    int nextToken_ = 1;
+};
@@ -0,0 +1,332 @@
+#include "boardcolumnmodel.h"
+#include "memoryaccounting.h"
+#include "metrics.h"
+#include "tracing.h"
+
+#include <QDataStream>
+#include <QIODevice>
+#include <QMimeData>
+#include <algorithm>
+
+const char* const BoardColumnModel::TaskIdsMimeType = "application/x-kanban-task-ids";
+
+namespace {
+
+// Полная перестройка колонки: сброс или пакет изменений.
+metrics::Histogram& refreshDuration()
+{
+    static metrics::Histogram& duration = metrics::histogram("view.refresh");
+    return duration;
+}
+
+}
+
+BoardColumnModel::BoardColumnModel(ScrumBoard& board,
+                                   const TaskItemFormat::DeveloperNameCache& developerNames,
+                                   std::vector<TaskStatus> statuses,
+                                   QObject* parent)
+    : QAbstractListModel(parent),
+    m_board(board),
+    m_developerNames(developerNames),
+    m_statuses(std::move(statuses)),
+    m_taskIds(&memory::resource(memory::Component::View)),
+    m_batchTaskIds(m_taskIds.get_allocator())
+{
+    m_subscription = m_board.subscribe([this](const BoardChange& change) {
+        onBoardChanged(change);
+    });
+    reload();
+}
+
+BoardColumnModel::~BoardColumnModel()
+{
+    m_board.unsubscribe(m_subscription);
+}
+
+int BoardColumnModel::rowCount(const QModelIndex& parent) const
+{
+    if (parent.isValid()) return 0;
+    return (int)m_taskIds.size();
+}
+
+QVariant BoardColumnModel::data(const QModelIndex& index, int role) const
+{
+    if (!index.isValid() || index.row() < 0 || index.row() >= rowCount())
+        return QVariant();
+
+    int taskId = m_taskIds[(size_t)index.row()];
+
+    switch (role) {
+    case Qt::DisplayRole:
+        return TaskItemFormat::makeTitleLine(m_developerNames, m_board.getTask(taskId));
+    case Qt::ToolTipRole:
+        return TaskItemFormat::makeTooltip(m_board.getTask(taskId));
+    case TaskIdRole:
+        return taskId;
+    default:
+        return QVariant();
+    }
+}
+
+Qt::ItemFlags BoardColumnModel::flags(const QModelIndex& index) const
+{
+    Qt::ItemFlags f = QAbstractListModel::flags(index);
+    if (index.isValid()) return f | Qt::ItemIsDragEnabled;
+    return f | Qt::ItemIsDropEnabled;
+}
+
+Qt::DropActions BoardColumnModel::supportedDropActions() const
+{
+    return Qt::MoveAction | Qt::CopyAction;
+}
+
+QStringList BoardColumnModel::mimeTypes() const
+{
+    return { TaskIdsMimeType };
+}
+
+QMimeData* BoardColumnModel::mimeData(const QModelIndexList& indexes) const
+{
+    QByteArray encoded;
+    QDataStream stream(&encoded, QIODevice::WriteOnly);
+
+    stream << (qint32)indexes.size();
+    for (const QModelIndex& index : indexes) {
+        stream << (qint32)taskIdAt(index.row());
+    }
+
+    QMimeData* mime = new QMimeData();
+    mime->setData(TaskIdsMimeType, encoded);
+    return mime;
+}
+
+std::vector<int> BoardColumnModel::decodeTaskIds(const QMimeData* mime)
+{
+    std::vector<int> ids;
+    if (!mime || !mime->hasFormat(TaskIdsMimeType)) return ids;
+
+    QByteArray encoded = mime->data(TaskIdsMimeType);
+    QDataStream stream(&encoded, QIODevice::ReadOnly);
+
+    qint32 count = 0;
+    stream >> count;
+    for (qint32 i = 0; i < count && stream.status() == QDataStream::Ok; ++i) {
+        qint32 id = -1;
+        stream >> id;
+        if (stream.status() == QDataStream::Ok && id >= 0) ids.push_back(id);
+    }
+
+    std::sort(ids.begin(), ids.end());
+    ids.erase(std::unique(ids.begin(), ids.end()), ids.end());
+    return ids;
+}
+
+int BoardColumnModel::taskIdAt(int row) const
+{
+    if (row < 0 || row >= rowCount()) return -1;
+    return m_taskIds[(size_t)row];
+}
+
+bool BoardColumnModel::acceptsStatus(TaskStatus status) const
+{
+    return std::find(m_statuses.begin(), m_statuses.end(), status) != m_statuses.end();
+}
+
+void BoardColumnModel::setFilter(const std::vector<int>* taskIds)
+{
+    if (!m_filter && !taskIds) return;
+    m_filter = taskIds;
+    reload();
+}
+
+bool BoardColumnModel::passesFilter(int taskId) const
+{
+    return !m_filter || std::binary_search(m_filter->begin(), m_filter->end(), taskId);
+}
+
+void BoardColumnModel::reload()
+{
+    KANBAN_TRACE_SCOPE("BoardColumnModel::reload");
+    metrics::Timer timer(refreshDuration());
+    beginResetModel();
+    m_taskIds.clear();
+    if (m_filter) {
+        // Результат поиска обычно много меньше колонки: идём по нему.
+        for (int id : *m_filter) {
+            std::optional<TaskView> task = m_board.findTask(id);
+            if (task && acceptsStatus(task->status())) m_taskIds.push_back(id);
+        }
+        endResetModel();
+        return;
+    }
+    for (TaskStatus status : m_statuses) {
+        const PersistentIdSet& ids = m_board.taskIdsByStatus(status);
+        size_t middle = m_taskIds.size();
+        m_taskIds.insert(m_taskIds.end(), ids.begin(), ids.end());
+        std::inplace_merge(m_taskIds.begin(), m_taskIds.begin() + (std::ptrdiff_t)middle, m_taskIds.end());
+    }
+    endResetModel();
+}
+
+int BoardColumnModel::rowOf(int taskId) const
+{
+    auto it = std::lower_bound(m_taskIds.begin(), m_taskIds.end(), taskId);
+    if (it == m_taskIds.end() || *it != taskId) return -1;
+    return (int)(it - m_taskIds.begin());
+}
+
+void BoardColumnModel::insertTask(int taskId)
+{
+    KANBAN_TRACE_SCOPE("BoardColumnModel::insertTask");
+    if (!passesFilter(taskId)) return;
+    if (m_batchDepth > 0) {
+        m_batchTaskIds.push_back(taskId);
+        return;
+    }
+
+    auto it = std::lower_bound(m_taskIds.begin(), m_taskIds.end(), taskId);
+    if (it != m_taskIds.end() && *it == taskId) return;
+
+    int row = (int)(it - m_taskIds.begin());
+    beginInsertRows(QModelIndex(), row, row);
+    m_taskIds.insert(it, taskId);
+    endInsertRows();
+}
+
+void BoardColumnModel::removeTask(int taskId)
+{
+    KANBAN_TRACE_SCOPE("BoardColumnModel::removeTask");
+    if (m_batchDepth > 0) {
+        m_batchTaskIds.push_back(taskId);
+        return;
+    }
+
+    int row = rowOf(taskId);
+    if (row < 0) return;
+
+    beginRemoveRows(QModelIndex(), row, row);
+    m_taskIds.erase(m_taskIds.begin() + row);
+    endRemoveRows();
+}
+
+// Для задач, затронутых пакетом, принадлежность колонке берётся из итогового
+// состояния доски. Небольшой пакет (перетаскивание, отмена) применяется
+// построчно, чтобы представление сохранило выделение и прокрутку; большой
+// (порция загрузки, импорт) — сбросом: выбрасываем затронутые ID из списка
+// и вливаем обратно отсортированными.
+void BoardColumnModel::applyBatch()
+{
+    KANBAN_TRACE_SCOPE_ARG("BoardColumnModel::applyBatch", "tasks", m_batchTaskIds.size());
+    metrics::Timer timer(refreshDuration());
+    std::pmr::vector<int> touched(m_batchTaskIds.get_allocator());
+    touched.swap(m_batchTaskIds);
+    bool dirty = m_batchDirty;
+    m_batchDirty = false;
+
+    if (touched.empty() && !dirty) return;
+
+    std::sort(touched.begin(), touched.end());
+    touched.erase(std::unique(touched.begin(), touched.end()), touched.end());
+
+    if (touched.size() <= BatchRowUpdateLimit) {
+        applyBatchRows(touched);
+        // Изменились имена разработчиков: перерисуются только видимые строки.
+        if (dirty && !m_taskIds.empty()) emit dataChanged(index(0), index(rowCount() - 1), {Qt::DisplayRole});
+        return;
+    }
+
+    beginResetModel();
+
+    m_taskIds.erase(std::remove_if(m_taskIds.begin(), m_taskIds.end(),
+                                   [&touched](int id) {
+                                       return std::binary_search(touched.begin(), touched.end(), id);
+                                   }),
+                    m_taskIds.end());
+
+    size_t middle = m_taskIds.size();
+    for (int id : touched) {
+        std::optional<TaskView> task = m_board.findTask(id);
+        if (task && acceptsStatus(task->status()) && passesFilter(id)) m_taskIds.push_back(id);
+    }
+    std::inplace_merge(m_taskIds.begin(), m_taskIds.begin() + (std::ptrdiff_t)middle, m_taskIds.end());
+
+    endResetModel();
+}
+
+void BoardColumnModel::applyBatchRows(const std::pmr::vector<int>& touched)
+{
+    auto belongs = [this](int id) {
+        std::optional<TaskView> task = m_board.findTask(id);
+        return task && acceptsStatus(task->status()) && passesFilter(id);
+    };
+
+    // С конца, чтобы номера ещё не обработанных строк не сдвигались.
+    for (auto it = touched.rbegin(); it != touched.rend(); ++it) {
+        int row = rowOf(*it);
+        if (row < 0 || belongs(*it)) continue;
+        beginRemoveRows(QModelIndex(), row, row);
+        m_taskIds.erase(m_taskIds.begin() + row);
+        endRemoveRows();
+    }
+    for (int id : touched) {
+        if (!belongs(id)) continue;
+        auto it = std::lower_bound(m_taskIds.begin(), m_taskIds.end(), id);
+        int row = (int)(it - m_taskIds.begin());
+        if (it != m_taskIds.end() && *it == id) {
+            emit dataChanged(index(row), index(row));
+            continue;
+        }
+        beginInsertRows(QModelIndex(), row, row);
+        m_taskIds.insert(it, id);
+        endInsertRows();
+    }
+}
+
+void BoardColumnModel::onBoardChanged(const BoardChange& change)
+{
+    switch (change.kind) {
+    case BoardChange::Kind::TaskAdded:
+        if (acceptsStatus(change.newStatus)) insertTask(change.id);
+        break;
+    case BoardChange::Kind::TaskRemoved:
+        if (acceptsStatus(change.oldStatus)) removeTask(change.id);
+        break;
+    case BoardChange::Kind::TaskStatusChanged:
+    case BoardChange::Kind::TaskAssigned: {
+        bool was = acceptsStatus(change.oldStatus);
+        bool now = acceptsStatus(change.newStatus);
+        if (was && now) {
+            if (m_batchDepth > 0) {
+                m_batchTaskIds.push_back(change.id);
+                break;
+            }
+            int row = rowOf(change.id);
+            if (row >= 0) emit dataChanged(index(row), index(row));
+        } else if (was) {
+            removeTask(change.id);
+        } else if (now) {
+            insertTask(change.id);
+        }
+        break;
+    }
+    case BoardChange::Kind::DeveloperAdded:
+    case BoardChange::Kind::DeveloperRemoved:
+        // Имя разработчика входит в текст строки; перерисуются только видимые строки.
+        if (m_batchDepth > 0)
+            m_batchDirty = true;
+        else if (!m_taskIds.empty())
+            emit dataChanged(index(0), index(rowCount() - 1), {Qt::DisplayRole});
+        break;
+    case BoardChange::Kind::Reset:
+        m_batchTaskIds.clear();
+        m_batchDirty = false;
+        reload();
+        break;
+    case BoardChange::Kind::BatchBegin:
+        ++m_batchDepth;
+        break;
+    case BoardChange::Kind::BatchEnd:
+        if (m_batchDepth > 0 && --m_batchDepth == 0) applyBatch();
+        break;
+    }
+}
@@ -0,0 +1,66 @@
+#pragma once
+#include <QAbstractListModel>
+#include <memory_resource>
+#include <vector>
+#include "scrumboard.h"
+#include "taskitemformat.h"
+
+// Колонка доски: хранит только упорядоченные ID задач, текст строк
+// формируется в data() лишь для тех строк, которые запрашивает представление.
+// Списки ID учитываются в memory::Component::View.
+class BoardColumnModel : public QAbstractListModel {
+    Q_OBJECT
+public:
+    enum Roles {
+        TaskIdRole = Qt::UserRole + 1
+    };
+
+    BoardColumnModel(ScrumBoard& board,
+                     const TaskItemFormat::DeveloperNameCache& developerNames,
+                     std::vector<TaskStatus> statuses,
+                     QObject* parent = nullptr);
+    ~BoardColumnModel() override;
+
+    static const char* const TaskIdsMimeType;
+
+    int rowCount(const QModelIndex& parent = QModelIndex()) const override;
+    QVariant data(const QModelIndex& index, int role = Qt::DisplayRole) const override;
+    Qt::ItemFlags flags(const QModelIndex& index) const override;
+    Qt::DropActions supportedDropActions() const override;
+    QStringList mimeTypes() const override;
+    QMimeData* mimeData(const QModelIndexList& indexes) const override;
+
+    static std::vector<int> decodeTaskIds(const QMimeData* mime);
+
+    int taskIdAt(int row) const;
+    bool acceptsStatus(TaskStatus status) const;
+
+    // Показывать только задачи из списка ID (по возрастанию), nullptr — все.
+    // Список принадлежит вызывающему и должен жить, пока фильтр установлен.
+    void setFilter(const std::vector<int>* taskIds);
+
+private:
+    void onBoardChanged(const BoardChange& change);
+    void reload();
+    void insertTask(int taskId);
+    void removeTask(int taskId);
+    void applyBatch();
+    void applyBatchRows(const std::pmr::vector<int>& touched);
+    int rowOf(int taskId) const;
+    bool passesFilter(int taskId) const;
+
+private:
+    ScrumBoard& m_board;
+    const TaskItemFormat::DeveloperNameCache& m_developerNames;
+    std::vector<TaskStatus> m_statuses;
+    std::pmr::vector<int> m_taskIds;
+    const std::vector<int>* m_filter = nullptr;
+    int m_subscription = 0;
+
+    // Во время пакетной операции затронутые ID копятся; небольшой пакет
+    // применяется построчно, большой — одним сбросом.
+    static constexpr std::size_t BatchRowUpdateLimit = 64;
+    int m_batchDepth = 0;
+    bool m_batchDirty = false;
+    std::pmr::vector<int> m_batchTaskIds;
+};
@@ -0,0 +1,45 @@
+#pragma once
+#include <cstdint>
+#include <stdexcept>
+
+// Причина, по которой доска отказалась от изменения. Методы try* возвращают
+// её вместо исключения: при импорте и перетаскивании отказ — обычный исход,
+// и раскрутка стека на каждом отказе обходится дорого.
+enum class BoardError : std::uint8_t {
+    None,
+    EmptyTitle,
+    EmptyName,
+    DuplicateTask,
+    DuplicateDeveloper,
+    TaskNotFound,
+    DeveloperNotFound,
+    DeveloperRequired
+};
+
+inline const char* boardErrorMessage(BoardError error) {
+    switch (error) {
+    case BoardError::None: return "";
+    case BoardError::EmptyTitle: return "Название задачи не может быть пустым";
+    case BoardError::EmptyName: return "Имя разработчика не может быть пустым";
+    case BoardError::DuplicateTask: return "Задача с этим ID уже существует";
+    case BoardError::DuplicateDeveloper: return "Разработчик с этим ID уже существует";
+    case BoardError::TaskNotFound: return "Задача не найдена";
+    case BoardError::DeveloperNotFound: return "Разработчик не найден";
+    case BoardError::DeveloperRequired:
+        return "Для перемещения задачи в выполнение назначьте сначала разработчика";
+    }
+    return "Неизвестная ошибка доски";
+}
+
+// Бросающие методы доски выбрасывают те же типы исключений, что и раньше.
+inline void throwIfError(BoardError error) {
+    switch (error) {
+    case BoardError::None: return;
+    case BoardError::EmptyTitle:
+    case BoardError::EmptyName: throw std::invalid_argument(boardErrorMessage(error));
+    case BoardError::TaskNotFound:
+    case BoardError::DeveloperNotFound: throw std::out_of_range(boardErrorMessage(error));
+    case BoardError::DeveloperRequired: throw std::logic_error(boardErrorMessage(error));
+    default: throw std::runtime_error(boardErrorMessage(error));
+    }
+}
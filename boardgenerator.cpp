@@ -0,0 +1,148 @@
+#include "boardgenerator.h"
+#include <algorithm>
+#include <climits>
+#include <optional>
+#include <stdexcept>
+
+namespace {
+
+const char* const kWords[] = {
+    "исправить", "ошибку", "в", "модуле", "добавить", "тест", "для", "экспорта",
+    "проверить", "загрузку", "доски", "после", "обновления", "сервер", "отвечает",
+    "медленно", "при", "большом", "числе", "задач", "описание", "пользователь",
+    "не", "может", "сохранить", "файл", "release", "build", "crash", "on", "startup",
+    "перенести", "настройки", "интерфейс", "колонки", "фильтр", "поиск", "по",
+    "названию", "отчёт", "за", "спринт", "согласовать", "с", "командой", "API",
+};
+
+constexpr std::size_t kWordCount = sizeof(kWords) / sizeof(kWords[0]);
+
+// То, что сериализатор обязан экранировать.
+const char* const kEscapes[] = { "\"", "\\", "\n", "\t", "\r", "\x01", "\x1f", "\"цитата\"" };
+
+constexpr std::size_t kEscapeCount = sizeof(kEscapes) / sizeof(kEscapes[0]);
+
+}
+
+BoardGenerator::BoardGenerator(const BoardGeneratorOptions& options)
+    : options_(options), rng_(options.seed)
+{
+    if (options_.tasks < 0 || options_.developers < 0) {
+        throw std::invalid_argument("Число задач и разработчиков не может быть отрицательным");
+    }
+    if (options_.idStride < 1 || options_.tasks > INT_MAX / options_.idStride) {
+        throw std::invalid_argument("ID задач не помещаются в int");
+    }
+    if (options_.titleLength.min < 1 || options_.titleLength.min > options_.titleLength.max
+        || options_.descriptionLength.min > options_.descriptionLength.max) {
+        throw std::invalid_argument("Некорректный диапазон длины текста");
+    }
+    if (options_.assignedShare < 0 || options_.assignedShare > 1) {
+        throw std::invalid_argument("Доля назначенных задач должна быть от 0 до 1");
+    }
+
+    double total = 0;
+    for (double weight : options_.statusWeights) {
+        if (weight < 0) throw std::invalid_argument("Вес статуса не может быть отрицательным");
+        total += weight;
+    }
+    if (total <= 0) throw std::invalid_argument("Нужен хотя бы один статус с ненулевым весом");
+
+    bool needsDevelopers = options_.statusWeights[statusIndex(TaskStatus::Assigned)] > 0
+                           || options_.statusWeights[statusIndex(TaskStatus::InProgress)] > 0;
+    if (options_.developers == 0 && options_.tasks > 0 && needsDevelopers) {
+        throw std::invalid_argument("Статусы Assigned и InProgress требуют разработчиков");
+    }
+
+    double sum = 0;
+    for (std::size_t i = 0; i < kTaskStatusCount; ++i) {
+        sum += options_.statusWeights[i];
+        statusThresholds_[i] = sum / total;
+    }
+}
+
+void BoardGenerator::write(BoardRecordWriter& writer)
+{
+    for (int id = 1; id <= options_.developers; ++id) {
+        writer.developer(id, "Разработчик " + std::to_string(id));
+    }
+
+    // Буферы переиспользуются: в памяти всегда одна задача.
+    std::string title;
+    std::string description;
+    int id = 0;
+    for (std::int64_t i = 0; i < options_.tasks; ++i) {
+        id += 1 + (int)below((std::uint64_t)options_.idStride);
+        TaskStatus status = nextStatus();
+        bool required = Task::checkStatusTransition(status, false) != BoardError::None;
+        bool assigned = options_.developers > 0 && status != TaskStatus::Backlog
+                        && (required || chance(options_.assignedShare));
+        std::optional<int> owner;
+        if (assigned) owner = nextOwner();
+
+        makeText(title, options_.titleLength);
+        makeText(description, options_.descriptionLength);
+        writer.task(TaskView(id, title, description, status, owner));
+        ++tasksWritten_;
+    }
+    writer.finish();
+}
+
+std::uint64_t BoardGenerator::below(std::uint64_t bound)
+{
+    return bound <= 1 ? 0 : rng_() % bound;
+}
+
+bool BoardGenerator::chance(double probability)
+{
+    // 53 старших бита — ровно мантисса double, без округлений.
+    return (double)(rng_() >> 11) * 0x1p-53 < probability;
+}
+
+TaskStatus BoardGenerator::nextStatus()
+{
+    double u = (double)(rng_() >> 11) * 0x1p-53;
+    for (std::size_t i = 0; i + 1 < kTaskStatusCount; ++i) {
+        if (u < statusThresholds_[i]) return static_cast<TaskStatus>(i);
+    }
+    return static_cast<TaskStatus>(kTaskStatusCount - 1);
+}
+
+int BoardGenerator::nextOwner()
+{
+    switch (options_.owners) {
+    case OwnerDistribution::SingleOwner:
+        return 1;
+    case OwnerDistribution::Skewed: {
+        // Сначала равновероятно выбирается диапазон [2^k, 2^(k+1)), затем
+        // разработчик в нём: на каждого из первых приходится в разы больше задач.
+        int bits = 0;
+        while ((2LL << bits) <= options_.developers) ++bits;
+        int low = 1 << below((std::uint64_t)bits + 1);
+        int high = std::min(options_.developers, 2 * low - 1);
+        return low + (int)below((std::uint64_t)(high - low + 1));
+    }
+    case OwnerDistribution::Uniform:
+        break;
+    }
+    return 1 + (int)below((std::uint64_t)options_.developers);
+}
+
+void BoardGenerator::makeText(std::string& text, const TextLength& length)
+{
+    std::size_t target = length.min + (std::size_t)below(length.max - length.min + 1);
+    text.clear();
+    while (text.size() < target) {
+        if (!text.empty()) text += ' ';
+        if (options_.escapedText && below(8) == 0) text += kEscapes[below(kEscapeCount)];
+        text += kWords[below(kWordCount)];
+    }
+    // Последнее слово обрезается по границе символа UTF-8, недостающие
+    // до target байты добиваются точками.
+    if (text.size() > target) {
+        std::size_t cut = target;
+        while (cut > 0 && ((unsigned char)text[cut] & 0xC0) == 0x80) --cut;
+        text.resize(cut);
+        text.append(target - cut, '.');
+    }
+}
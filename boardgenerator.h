@@ -0,0 +1,69 @@
+#pragma once
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <random>
+#include <string>
+#include "boardserializer.h"
+
+// Длина текста в байтах UTF-8, равномерно от min до max. Текст набирается
+// словами, последнее обрезается по границе символа.
+struct TextLength {
+    std::size_t min;
+    std::size_t max;
+};
+
+enum class OwnerDistribution {
+    Uniform,        // исполнитель выбирается равномерно
+    Skewed,         // у первых разработчиков задач на порядки больше, чем у последних
+    SingleOwner     // все назначенные задачи у разработчика 1
+};
+
+struct BoardGeneratorOptions {
+    std::uint64_t seed = 1;
+    std::int64_t tasks = 1000;
+    int developers = 50;
+    // Относительные веса статусов в порядке TaskStatus.
+    std::array<double, kTaskStatusCount> statusWeights{30, 20, 25, 10, 15};
+    // Доля назначенных среди задач, которым исполнитель не обязателен
+    // (Blocked, Done). Задачи в Backlog не назначены никогда.
+    double assignedShare = 0.8;
+    OwnerDistribution owners = OwnerDistribution::Uniform;
+    TextLength titleLength{12, 60};
+    TextLength descriptionLength{0, 400};
+    // Шаг между соседними ID задач — случайный от 1 до idStride.
+    int idStride = 1;
+    // Кавычки, обратные косые черты, переводы строк и управляющие символы
+    // в тексте: всё, что сериализатор должен экранировать.
+    bool escapedText = false;
+};
+
+// Детерминированный генератор досок для нагрузочных тестов: одинаковые
+// параметры и зерно дают побайтно одинаковый файл на любой платформе
+// (используется только mt19937_64 и целочисленная арифметика, без
+// распределений стандартной библиотеки, которые от неё зависят).
+//
+// Записи выдаются по одной через BoardRecordWriter, поэтому память не
+// зависит от числа задач. Результат — корректная доска: исполнители
+// существуют, статусы Assigned и InProgress только у назначенных задач.
+class BoardGenerator {
+public:
+    // Недопустимые параметры — std::invalid_argument.
+    explicit BoardGenerator(const BoardGeneratorOptions& options);
+
+    void write(BoardRecordWriter& writer);
+
+    std::int64_t tasksWritten() const noexcept { return tasksWritten_; }
+
+private:
+    std::uint64_t below(std::uint64_t bound);
+    bool chance(double probability);
+    TaskStatus nextStatus();
+    int nextOwner();
+    void makeText(std::string& text, const TextLength& length);
+
+    BoardGeneratorOptions options_;
+    std::mt19937_64 rng_;
+    std::array<double, kTaskStatusCount> statusThresholds_{};
+    std::int64_t tasksWritten_ = 0;
+};
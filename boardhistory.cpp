@@ -0,0 +1,180 @@
+#include "boardhistory.h"
+#include "metrics.h"
+#include "tracing.h"
+#include <algorithm>
+#include <optional>
+#include <utility>
+
+namespace {
+
+void sortUnique(std::vector<int>& ids)
+{
+    std::sort(ids.begin(), ids.end());
+    ids.erase(std::unique(ids.begin(), ids.end()), ids.end());
+}
+
+// Изменения, которые переводят доску из from в to, по затронутым шагом ID.
+// Порядок годится и для журнала, который их проигрывает: новые разработчики
+// идут до задач, назначенных на них, а удалённые — после.
+std::vector<BoardChange> diffBoards(const ScrumBoard& from, const ScrumBoard& to,
+                                    const std::vector<int>& taskIds,
+                                    const std::vector<int>& developerIds)
+{
+    std::vector<BoardChange> changes;
+    std::vector<BoardChange> removedDevelopers;
+    for (int id : developerIds) {
+        const Developer* before = from.findDeveloper(id);
+        const Developer* after = to.findDeveloper(id);
+        if (before && after && before->name() == after->name()) continue;
+        if (before && after) changes.push_back({BoardChange::Kind::DeveloperRemoved, id});
+        else if (before) removedDevelopers.push_back({BoardChange::Kind::DeveloperRemoved, id});
+        if (after) changes.push_back({BoardChange::Kind::DeveloperAdded, id});
+    }
+
+    for (int id : taskIds) {
+        std::optional<TaskView> before = from.findTask(id);
+        std::optional<TaskView> after = to.findTask(id);
+        if (!before && !after) continue;
+
+        // Назначение и статус выражаются обычными изменениями; снять
+        // исполнителя или сменить текст можно только удалением и добавлением.
+        bool sameTask = before && after
+                        && before->title() == after->title()
+                        && before->description() == after->description()
+                        && (after->assignedDeveloper() || !before->assignedDeveloper());
+        if (sameTask) {
+            TaskStatus status = before->status();
+            if (before->assignedDeveloper() != after->assignedDeveloper()) {
+                TaskStatus assigned = Task::statusAfterAssignment(status);
+                changes.push_back({BoardChange::Kind::TaskAssigned, id, status, assigned});
+                status = assigned;
+            }
+            if (status != after->status()) {
+                changes.push_back({BoardChange::Kind::TaskStatusChanged, id, status, after->status()});
+            }
+            continue;
+        }
+        if (before) changes.push_back({BoardChange::Kind::TaskRemoved, id, before->status(), before->status()});
+        if (after) changes.push_back({BoardChange::Kind::TaskAdded, id, after->status(), after->status()});
+    }
+
+    changes.insert(changes.end(), removedDevelopers.begin(), removedDevelopers.end());
+    return changes;
+}
+
+}
+
+BoardHistory::BoardHistory(ScrumBoard& board)
+    : board_(board), current_(board)
+{
+    subscription_ = board_.subscribe([this](const BoardChange& change) {
+        onBoardChanged(change);
+    });
+}
+
+BoardHistory::~BoardHistory()
+{
+    board_.unsubscribe(subscription_);
+}
+
+void BoardHistory::clear()
+{
+    undo_.clear();
+    redo_.clear();
+    touchedTasks_.clear();
+    touchedDevelopers_.clear();
+    current_ = board_;
+}
+
+void BoardHistory::suspend()
+{
+    suspended_ = true;
+    batchDepth_ = 0;
+    clear();
+}
+
+void BoardHistory::resume()
+{
+    suspended_ = false;
+    batchDepth_ = 0;
+    clear();
+}
+
+bool BoardHistory::undo()
+{
+    if (suspended_ || undo_.empty()) return false;
+    Step step = std::move(undo_.back());
+    undo_.pop_back();
+    restore(step, redo_);
+    return true;
+}
+
+bool BoardHistory::redo()
+{
+    if (suspended_ || redo_.empty()) return false;
+    Step step = std::move(redo_.back());
+    redo_.pop_back();
+    restore(step, undo_);
+    return true;
+}
+
+// Обратный шаг кладётся в opposite до уведомлений: если подписчик бросит
+// исключение, доска и история всё равно останутся согласованными.
+void BoardHistory::restore(Step& step, std::vector<Step>& opposite)
+{
+    KANBAN_TRACE_SCOPE("BoardHistory::restore");
+    static metrics::Histogram& duration = metrics::histogram("history.restore");
+    metrics::Timer timer(duration);
+    std::vector<BoardChange> changes = diffBoards(board_, step.state, step.taskIds, step.developerIds);
+    opposite.push_back({std::move(current_), std::move(step.taskIds), std::move(step.developerIds)});
+    current_ = std::move(step.state);
+
+    restoring_ = true;
+    try {
+        board_.restoreState(current_, changes);
+    } catch (...) {
+        restoring_ = false;
+        throw;
+    }
+    restoring_ = false;
+}
+
+void BoardHistory::onBoardChanged(const BoardChange& change)
+{
+    if (restoring_ || suspended_) return;
+
+    switch (change.kind) {
+    case BoardChange::Kind::TaskAdded:
+    case BoardChange::Kind::TaskRemoved:
+    case BoardChange::Kind::TaskStatusChanged:
+    case BoardChange::Kind::TaskAssigned:
+        touchedTasks_.push_back(change.id);
+        break;
+    case BoardChange::Kind::DeveloperAdded:
+    case BoardChange::Kind::DeveloperRemoved:
+        touchedDevelopers_.push_back(change.id);
+        break;
+    case BoardChange::Kind::Reset:
+        batchDepth_ = 0;
+        clear();
+        return;
+    case BoardChange::Kind::BatchBegin:
+        ++batchDepth_;
+        return;
+    case BoardChange::Kind::BatchEnd:
+        if (batchDepth_ > 0) --batchDepth_;
+        break;
+    }
+
+    if (batchDepth_ > 0 || (touchedTasks_.empty() && touchedDevelopers_.empty())) return;
+
+    // Шаг закончен: состояние до него уходит в историю, новая правка
+    // отменяет возможность повтора.
+    sortUnique(touchedTasks_);
+    sortUnique(touchedDevelopers_);
+    undo_.push_back({std::move(current_), std::move(touchedTasks_), std::move(touchedDevelopers_)});
+    touchedTasks_.clear();
+    touchedDevelopers_.clear();
+    current_ = board_;
+    redo_.clear();
+}
@@ -0,0 +1,65 @@
+#pragma once
+#include <cstddef>
+#include <vector>
+#include "scrumboard.h"
+
+// Неограниченная история отмены и повтора. Шаг — одно изменение доски или
+// один пакет (перетаскивание нескольких задач, импорт). На каждый шаг история
+// хранит копию доски до него: копия стоит O(1), потому что столбцы доски —
+// постоянные структуры, и разделяет с соседними шагами всё, кроме пары
+// листьев, которые шаг изменил.
+//
+// Отмена и повтор сообщают подписчикам доски точечные изменения, а не сброс,
+// поэтому колонки, индекс поиска и журнал обновляются как после обычной правки.
+// Сброс доски (загрузка файла) очищает историю, а на время постепенной
+// загрузки историю приостанавливают: порции загрузки — не шаги пользователя.
+class BoardHistory {
+public:
+    explicit BoardHistory(ScrumBoard& board);
+    ~BoardHistory();
+
+    BoardHistory(const BoardHistory&) = delete;
+    BoardHistory& operator=(const BoardHistory&) = delete;
+
+    bool canUndo() const noexcept { return !undo_.empty(); }
+    bool canRedo() const noexcept { return !redo_.empty(); }
+    std::size_t undoCount() const noexcept { return undo_.size(); }
+    std::size_t redoCount() const noexcept { return redo_.size(); }
+
+    // false, если отменять или повторять нечего.
+    bool undo();
+    bool redo();
+
+    // Забывает все шаги; текущее состояние доски становится началом истории.
+    void clear();
+
+    // Пока история приостановлена, шагов в ней нет и изменения доски не
+    // записываются. resume() начинает историю с текущего состояния доски.
+    void suspend();
+    void resume();
+    bool suspended() const noexcept { return suspended_; }
+
+private:
+    struct Step {
+        ScrumBoard state;               // состояние, к которому шаг возвращает доску
+        std::vector<int> taskIds;       // задачи и разработчики, которые шаг затронул
+        std::vector<int> developerIds;
+    };
+
+    void onBoardChanged(const BoardChange& change);
+    void restore(Step& step, std::vector<Step>& opposite);
+
+    ScrumBoard& board_;
+    int subscription_ = 0;
+    int batchDepth_ = 0;
+    bool restoring_ = false;
+    bool suspended_ = false;
+
+    // Копия доски после последнего шага и то, что затронуто после него.
+    ScrumBoard current_;
+    std::vector<int> touchedTasks_;
+    std::vector<int> touchedDevelopers_;
+
+    std::vector<Step> undo_;
+    std::vector<Step> redo_;
+};
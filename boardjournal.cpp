@@ -0,0 +1,413 @@
+#include "boardjournal.h"
+#include "metrics.h"
+#include "boardsnapshot.h"
+#include "tracing.h"
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+#include <filesystem>
+#include <stdexcept>
+#include <string_view>
+#include <vector>
+
+namespace fs = std::filesystem;
+
+namespace {
+
+enum class Op : std::uint8_t {
+    AddDeveloper = 1,
+    RemoveDeveloper,
+    AddTask,
+    RemoveTask,
+    AssignTask,
+    ChangeStatus
+};
+
+// Запись: [размер полезной нагрузки u32][контрольная сумма u32][нагрузка],
+// нагрузка начинается с номера записи u64 и кода операции u8.
+constexpr std::size_t kRecordHeaderSize = 8;
+constexpr std::uint32_t kMaxPayloadSize = 64 * 1024 * 1024;
+
+template <typename T>
+void put(std::string& out, T value) {
+    out.append(reinterpret_cast<const char*>(&value), sizeof(value));
+}
+
+void putString(std::string& out, std::string_view text) {
+    put<std::uint32_t>(out, (std::uint32_t)text.size());
+    out.append(text.data(), text.size());
+}
+
+std::uint32_t payloadChecksum(const char* data, std::size_t size) {
+    return (std::uint32_t)snapshot::checksum(data, size);
+}
+
+class RecordReader {
+public:
+    RecordReader(const char* data, std::size_t size) : p_(data), end_(data + size) {}
+
+    template <typename T>
+    T get() {
+        T value;
+        need(sizeof(value));
+        std::memcpy(&value, p_, sizeof(value));
+        p_ += sizeof(value);
+        return value;
+    }
+
+    std::string_view getString() {
+        std::uint32_t size = get<std::uint32_t>();
+        need(size);
+        std::string_view text(p_, size);
+        p_ += size;
+        return text;
+    }
+
+private:
+    void need(std::size_t size) {
+        if ((std::size_t)(end_ - p_) < size) {
+            throw std::runtime_error("Журнал доски повреждён");
+        }
+    }
+
+    const char* p_;
+    const char* end_;
+};
+
+struct Segment {
+    std::uint64_t firstSequence;
+    fs::path path;
+};
+
+std::string segmentPrefix(const std::string& snapshotPath) {
+    return fs::path(snapshotPath).filename().string() + ".journal.";
+}
+
+fs::path segmentPath(const std::string& snapshotPath, std::uint64_t firstSequence) {
+    return fs::path(snapshotPath + ".journal." + std::to_string(firstSequence));
+}
+
+std::vector<Segment> listSegments(const std::string& snapshotPath) {
+    std::vector<Segment> segments;
+    fs::path dir = fs::path(snapshotPath).parent_path();
+    if (dir.empty()) dir = ".";
+    std::string prefix = segmentPrefix(snapshotPath);
+
+    std::error_code ec;
+    for (const fs::directory_entry& entry : fs::directory_iterator(dir, ec)) {
+        std::string name = entry.path().filename().string();
+        if (name.size() <= prefix.size() || name.compare(0, prefix.size(), prefix) != 0) continue;
+        std::string number = name.substr(prefix.size());
+        if (!std::all_of(number.begin(), number.end(), [](char c) { return c >= '0' && c <= '9'; })) continue;
+        segments.push_back({std::stoull(number), entry.path()});
+    }
+
+    std::sort(segments.begin(), segments.end(),
+              [](const Segment& a, const Segment& b) { return a.firstSequence < b.firstSequence; });
+    return segments;
+}
+
+void applyRecord(ScrumBoard& board, Op op, RecordReader& in, int& maxDeveloperId, int& maxTaskId) {
+    switch (op) {
+    case Op::AddDeveloper: {
+        int id = in.get<std::int32_t>();
+        board.addDeveloper(Developer(id, std::string(in.getString())));
+        maxDeveloperId = std::max(maxDeveloperId, id);
+        break;
+    }
+    case Op::RemoveDeveloper:
+        board.removeDeveloper(in.get<std::int32_t>());
+        break;
+    case Op::AddTask: {
+        int id = in.get<std::int32_t>();
+        std::uint8_t status = in.get<std::uint8_t>();
+        int assignee = in.get<std::int32_t>();
+        std::string_view title = in.getString();
+        std::string_view description = in.getString();
+        if (status >= kTaskStatusCount) throw std::runtime_error("Журнал доски повреждён");
+        board.addTask(TaskView(id, title, description, (TaskStatus)status,
+                               assignee != snapshot::kNoDeveloper ? std::optional<int>(assignee)
+                                                                  : std::nullopt));
+        maxTaskId = std::max(maxTaskId, id);
+        break;
+    }
+    case Op::RemoveTask:
+        board.removeTask(in.get<std::int32_t>());
+        break;
+    case Op::AssignTask: {
+        int taskId = in.get<std::int32_t>();
+        board.assignTask(taskId, in.get<std::int32_t>());
+        break;
+    }
+    case Op::ChangeStatus: {
+        int taskId = in.get<std::int32_t>();
+        std::uint8_t status = in.get<std::uint8_t>();
+        if (status >= kTaskStatusCount) throw std::runtime_error("Журнал доски повреждён");
+        board.changeTaskStatus(taskId, (TaskStatus)status);
+        break;
+    }
+    default:
+        throw std::runtime_error("Журнал доски повреждён");
+    }
+}
+
+struct LoadedState {
+    ScrumBoard board;
+    std::uint64_t sequence = 0;
+};
+
+// Проигрывает сегменты после state.sequence по порядку. Недописанная или
+// испорченная запись завершает сегмент; пропуск в нумерации завершает
+// проигрывание целиком. Возвращает число применённых записей.
+std::uint64_t replaySegments(LoadedState& state, const std::string& snapshotPath) {
+    std::uint64_t loaded = state.sequence;
+    int maxDeveloperId = 0;
+    int maxTaskId = 0;
+    std::string payload;
+
+    bool gap = false;
+    for (const Segment& segment : listSegments(snapshotPath)) {
+        if (gap) break;
+        std::ifstream in(segment.path, std::ios::binary);
+        std::uint32_t header[2];
+        while (in.read(reinterpret_cast<char*>(header), kRecordHeaderSize)) {
+            if (header[0] > kMaxPayloadSize) break;
+            payload.resize(header[0]);
+            if (!in.read(&payload[0], (std::streamsize)payload.size())) break;
+            if (payloadChecksum(payload.data(), payload.size()) != header[1]) break;
+
+            RecordReader record(payload.data(), payload.size());
+            std::uint64_t sequence = record.get<std::uint64_t>();
+            if (sequence <= state.sequence) continue;
+            if (sequence != state.sequence + 1) {
+                gap = true;
+                break;
+            }
+
+            try {
+                applyRecord(state.board, (Op)record.get<std::uint8_t>(), record, maxDeveloperId, maxTaskId);
+            } catch (const std::exception& e) {
+                throw std::runtime_error(std::string("Журнал доски не согласуется со снимком: ") + e.what());
+            }
+            state.sequence = sequence;
+        }
+    }
+
+    state.board.setNextDeveloperId(std::max(state.board.peekNextDeveloperId(), maxDeveloperId + 1));
+    state.board.setNextTaskId(std::max(state.board.peekNextTaskId(), maxTaskId + 1));
+    return state.sequence - loaded;
+}
+
+LoadedState readState(const std::string& snapshotPath) {
+    LoadedState state;
+    if (fs::exists(snapshotPath)) {
+        BoardSnapshot snap = BoardSnapshot::open(snapshotPath);
+        state.board = snap.toBoard();
+        state.sequence = snap.journalSequence();
+    }
+    replaySegments(state, snapshotPath);
+    return state;
+}
+
+}
+
+BoardJournal::BoardJournal(ScrumBoard& board, std::string snapshotPath)
+    : board_(board), snapshotPath_(std::move(snapshotPath))
+{
+    LoadedState state = readState(snapshotPath_);
+    sequence_ = state.sequence;
+    board_.replaceWith(std::move(state.board));
+
+    subscription_ = board_.subscribe([this](const BoardChange& change) {
+        onBoardChanged(change);
+    });
+}
+
+BoardJournal::BoardJournal(ScrumBoard& board, std::string snapshotPath, std::uint64_t loadedSequence)
+    : board_(board), snapshotPath_(std::move(snapshotPath))
+{
+    // Копия доски стоит O(1); без новых записей доска не сбрасывается.
+    LoadedState state{board_, loadedSequence};
+    if (replaySegments(state, snapshotPath_) > 0) board_.replaceWith(std::move(state.board));
+    sequence_ = state.sequence;
+
+    subscription_ = board_.subscribe([this](const BoardChange& change) {
+        onBoardChanged(change);
+    });
+}
+
+BoardJournal::~BoardJournal()
+{
+    board_.unsubscribe(subscription_);
+    try {
+        if (compaction_.valid()) compaction_.get();
+    } catch (...) {
+        // Журнал остаётся полным, снимок будет записан в следующий раз.
+    }
+}
+
+ScrumBoard BoardJournal::load(const std::string& snapshotPath)
+{
+    return readState(snapshotPath).board;
+}
+
+// Снимок подменяет прежний атомарно, после чего сегменты, целиком
+// вошедшие в него, больше не нужны.
+void BoardJournal::writeSnapshot(const ScrumBoard& state, const std::string& snapshotPath, std::uint64_t sequence)
+{
+    saveBoardSnapshot(state, snapshotPath, sequence);
+
+    for (const Segment& segment : listSegments(snapshotPath)) {
+        if (segment.firstSequence > sequence) break;
+        std::error_code ec;
+        fs::remove(segment.path, ec);
+    }
+}
+
+bool BoardJournal::compactionRunning() const
+{
+    return compaction_.valid()
+           && compaction_.wait_for(std::chrono::seconds(0)) != std::future_status::ready;
+}
+
+void BoardJournal::waitForCompaction()
+{
+    if (compaction_.valid()) compaction_.get();
+}
+
+bool BoardJournal::compact()
+{
+    if (compactionRunning()) return false;
+    waitForCompaction();
+
+    // Новые записи пойдут в следующий сегмент, снимок строится по копии доски.
+    closeSegment();
+    journalBytes_ = 0;
+    ScrumBoard copy = board_;
+    compaction_ = std::async(std::launch::async,
+                             [path = snapshotPath_, sequence = sequence_, copy = std::move(copy)]() {
+                                 writeSnapshot(copy, path, sequence);
+                             });
+    return true;
+}
+
+void BoardJournal::beginBulkChange()
+{
+    bulkChange_ = true;
+}
+
+void BoardJournal::endBulkChange()
+{
+    if (!bulkChange_) return;
+    bulkChange_ = false;
+
+    // Номер sequence_ + 1 достаётся самой замене, её запись — новый снимок.
+    closeSegment();
+    ++sequence_;
+    try {
+        waitForCompaction();
+    } catch (const std::exception&) {
+        // Новый снимок заменит и то, что не записало прошлое уплотнение.
+    }
+    compact();
+}
+
+void BoardJournal::compactNow()
+{
+    waitForCompaction();
+    closeSegment();
+    journalBytes_ = 0;
+    writeSnapshot(board_, snapshotPath_, sequence_);
+}
+
+void BoardJournal::closeSegment()
+{
+    if (segment_.is_open()) segment_.close();
+}
+
+void BoardJournal::append(std::string& record)
+{
+    KANBAN_TRACE_SCOPE("BoardJournal::append");
+    static metrics::Histogram& duration = metrics::histogram("journal.append");
+    static metrics::Counter& bytes = metrics::counter("journal.bytes");
+    metrics::Timer timer(duration);
+    bytes.add(record.size());
+    std::uint32_t header[2] = {
+        (std::uint32_t)(record.size() - kRecordHeaderSize),
+        payloadChecksum(record.data() + kRecordHeaderSize, record.size() - kRecordHeaderSize)
+    };
+    std::memcpy(&record[0], header, kRecordHeaderSize);
+
+    if (!segment_.is_open()) {
+        segment_.open(segmentPath(snapshotPath_, sequence_ + 1), std::ios::binary | std::ios::trunc);
+    }
+    segment_.write(record.data(), (std::streamsize)record.size());
+    segment_.flush();
+    if (!segment_) {
+        throw std::runtime_error("Ошибка записи журнала доски");
+    }
+
+    ++sequence_;
+    journalBytes_ += record.size();
+
+    if (journalBytes_ >= autoCompactBytes_ && !compactionRunning()) {
+        try {
+            compact();
+        } catch (const std::exception&) {
+            // Ошибка прошлого уплотнения не мешает записи: данные целы в журнале.
+        }
+    }
+}
+
+void BoardJournal::onBoardChanged(const BoardChange& change)
+{
+    if (bulkChange_) return;
+
+    std::string record(kRecordHeaderSize, '\0');
+    put<std::uint64_t>(record, sequence_ + 1);
+
+    switch (change.kind) {
+    case BoardChange::Kind::DeveloperAdded:
+        put(record, Op::AddDeveloper);
+        put<std::int32_t>(record, change.id);
+        putString(record, board_.getDeveloper(change.id).name());
+        break;
+    case BoardChange::Kind::DeveloperRemoved:
+        put(record, Op::RemoveDeveloper);
+        put<std::int32_t>(record, change.id);
+        break;
+    case BoardChange::Kind::TaskAdded: {
+        TaskView task = board_.getTask(change.id);
+        put(record, Op::AddTask);
+        put<std::int32_t>(record, task.id());
+        put<std::uint8_t>(record, (std::uint8_t)task.status());
+        put<std::int32_t>(record, task.assignedDeveloper() ? *task.assignedDeveloper() : snapshot::kNoDeveloper);
+        putString(record, task.title());
+        putString(record, task.description());
+        break;
+    }
+    case BoardChange::Kind::TaskRemoved:
+        put(record, Op::RemoveTask);
+        put<std::int32_t>(record, change.id);
+        break;
+    case BoardChange::Kind::TaskAssigned:
+        put(record, Op::AssignTask);
+        put<std::int32_t>(record, change.id);
+        put<std::int32_t>(record, *board_.getTask(change.id).assignedDeveloper());
+        break;
+    case BoardChange::Kind::TaskStatusChanged:
+        put(record, Op::ChangeStatus);
+        put<std::int32_t>(record, change.id);
+        put<std::uint8_t>(record, (std::uint8_t)change.newStatus);
+        break;
+    case BoardChange::Kind::Reset:
+        // Замену доски целиком журнал не выражает: сразу пишем снимок.
+        compactNow();
+        return;
+    case BoardChange::Kind::BatchBegin:
+    case BoardChange::Kind::BatchEnd:
+        return;
+    }
+
+    append(record);
+}
@@ -0,0 +1,74 @@
+#pragma once
+#include <cstdint>
+#include <fstream>
+#include <future>
+#include <string>
+#include "scrumboard.h"
+
+// Журнал изменений доски рядом с двоичным снимком. Каждое изменение доски
+// дописывается короткой записью и сразу сбрасывается в файл, так что при сбое
+// теряется не больше одной недописанной записи. Текущее состояние = снимок +
+// записи журнала после него. Уплотнение пишет новый снимок в фоновом потоке
+// и удаляет вошедшие в него сегменты журнала.
+//
+// Файлы: <snapshot> и сегменты <snapshot>.journal.<номер первой записи>.
+class BoardJournal {
+public:
+    // Загружает в board состояние из снимка и журнала и начинает записывать
+    // её изменения. Если файлов ещё нет, доска становится пустой.
+    BoardJournal(ScrumBoard& board, std::string snapshotPath);
+    // board уже содержит состояние с записями по loadedSequence включительно,
+    // например снимок после постепенной загрузки или доску из кеша: к ней
+    // применяются только более поздние записи журнала.
+    BoardJournal(ScrumBoard& board, std::string snapshotPath, std::uint64_t loadedSequence);
+    ~BoardJournal();
+
+    BoardJournal(const BoardJournal&) = delete;
+    BoardJournal& operator=(const BoardJournal&) = delete;
+
+    // Только чтение: снимок плюс проигранный журнал.
+    static ScrumBoard load(const std::string& snapshotPath);
+    // Записывает state снимком с номером sequence и удаляет вошедшие в него
+    // сегменты; так же пишет снимок уплотнение.
+    static void writeSnapshot(const ScrumBoard& state, const std::string& snapshotPath, std::uint64_t sequence);
+
+    // Запускает фоновое уплотнение; false, если предыдущее ещё не закончилось.
+    // Ошибка прошлого уплотнения выбрасывается здесь или в waitForCompaction().
+    bool compact();
+    void waitForCompaction();
+    bool compactionRunning() const;
+
+    // Массовая замена содержимого доски, например постепенная загрузка файла.
+    // Изменения между вызовами в журнал не пишутся; endBulkChange() пропускает
+    // один номер записи и запускает уплотнение. Пока новый снимок не записан,
+    // пропуск в нумерации не даёт применить новые записи к старому снимку:
+    // после сбоя восстановится состояние до замены.
+    void beginBulkChange();
+    void endBulkChange();
+    bool bulkChange() const noexcept { return bulkChange_; }
+
+    // Порог размера журнала, после которого уплотнение запускается само.
+    void setAutoCompactBytes(std::uint64_t bytes) { autoCompactBytes_ = bytes; }
+
+    std::uint64_t sequence() const noexcept { return sequence_; }
+    std::uint64_t journalBytes() const noexcept { return journalBytes_; }
+    const std::string& snapshotPath() const noexcept { return snapshotPath_; }
+
+private:
+    void onBoardChanged(const BoardChange& change);
+    void append(std::string& record);
+    void closeSegment();
+    void compactNow();
+
+    ScrumBoard& board_;
+    std::string snapshotPath_;
+    int subscription_ = 0;
+
+    std::uint64_t sequence_ = 0;
+    std::ofstream segment_;
+    std::uint64_t journalBytes_ = 0;
+    std::uint64_t autoCompactBytes_ = 4 * 1024 * 1024;
+    bool bulkChange_ = false;
+
+    std::future<void> compaction_;
+};
@@ -1,9 +1,10 @@
 #include "boardlistscontroller.h"
-#include "taskitemformat.h"
+#include "boardcolumnmodel.h"
+#include "metrics.h"
 #include "scrumboard.h"
+#include "tracing.h"
 
-#include <QListWidget>
-#include <QListWidgetItem>
+#include <QListView>
 #include <QEvent>
 #include <QDropEvent>
 #include <QTimer>
@@ -12,29 +13,37 @@
 #include <QMessageBox>
 
 BoardListsController::BoardListsController(ScrumBoard& board,
-                                           QListWidget* assigned,
-                                           QListWidget* inProgress,
-                                           QListWidget* done,
-                                           RefreshFn refresh,
+                                           QListView* assigned,
+                                           QListView* inProgress,
+                                           QListView* done,
                                            QObject* parent)
     : QObject(parent),
     m_board(board),
     m_assigned(assigned),
     m_inProgress(inProgress),
-    m_done(done),
-    m_refresh(std::move(refresh))
+    m_done(done)
 {
-    QListWidget* lists[] = { m_assigned, m_inProgress, m_done };
-    for (QListWidget* l : lists) {
+    QListView* lists[] = { m_assigned, m_inProgress, m_done };
+    for (QListView* l : lists) {
         setupDnD(l);
         setupContextMenu(l);
     }
 }
 
-void BoardListsController::setupDnD(QListWidget* list)
+void BoardListsController::setEditingEnabled(bool enabled)
+{
+    m_editingEnabled = enabled;
+    QListView* lists[] = { m_assigned, m_inProgress, m_done };
+    for (QListView* l : lists) {
+        if (l) l->setAcceptDrops(enabled);
+    }
+}
+
+void BoardListsController::setupDnD(QListView* list)
 {
     if (!list) return;
 
+    list->setSelectionMode(QAbstractItemView::ExtendedSelection);
     list->setDragEnabled(true);
     list->setAcceptDrops(true);
     list->setDropIndicatorShown(true);
@@ -43,28 +52,23 @@ void BoardListsController::setupDnD(QListWidget* list)
     list->viewport()->installEventFilter(this);
 }
 
-void BoardListsController::setupContextMenu(QListWidget* list)
+void BoardListsController::setupContextMenu(QListView* list)
 {
     if (!list) return;
 
     list->setContextMenuPolicy(Qt::CustomContextMenu);
 
-    connect(list, &QListWidget::customContextMenuRequested, this,
+    connect(list, &QListView::customContextMenuRequested, this,
             [this, list](const QPoint& pos) {
-                QListWidgetItem* item = list->itemAt(pos);
-                if (!item) return;
+                if (!m_editingEnabled) return;
+                QModelIndex index = list->indexAt(pos);
+                if (!index.isValid()) return;
+                int taskId = index.data(BoardColumnModel::TaskIdRole).toInt();
 
                 QMenu menu(list);
                 QAction* assignAction = menu.addAction("Назначить разработчика");
                 if (menu.exec(list->viewport()->mapToGlobal(pos)) != assignAction) return;
 
-                int taskId = TaskItemFormat::extractTaskId(item->text());
-                if (taskId < 0) {
-                    QMessageBox::warning(qobject_cast<QWidget*>(parent()),
-                                         "Ошибка", "Не удалось определить ID задачи из строки.");
-                    return;
-                }
-
                 const auto& devs = m_board.getAllDevelopers();
                 if (devs.empty()) {
                     QMessageBox::warning(qobject_cast<QWidget*>(parent()),
@@ -75,29 +79,30 @@ void BoardListsController::setupContextMenu(QListWidget* list)
                 QStringList names;
                 std::vector<int> devIds;
 
-                for (auto it = devs.begin(); it != devs.end(); ++it) {
-                    names << QString::fromStdString(it->second.name());
-                    devIds.push_back(it->first);
+                for (const Developer& dev : devs) {
+                    names << QString::fromUtf8(dev.name().data(), (qsizetype)dev.name().size());
+                    devIds.push_back(dev.id());
                 }
 
                 bool ok = false;
-                int index = names.indexOf(QInputDialog::getItem(
+                int devIndex = names.indexOf(QInputDialog::getItem(
                     qobject_cast<QWidget*>(parent()),
                     "Назначить задачу", "Разработчик:",
                     names, 0, false, &ok));
 
-                if (!ok || index < 0 || index >= (int)devIds.size()) return;
+                // Пока открыт диалог, могла начаться загрузка доски.
+                if (!ok || !m_editingEnabled || devIndex < 0 || devIndex >= (int)devIds.size()) return;
 
-                try {
-                    m_board.assignTask(taskId, devIds[(size_t)index]);
-                    if (m_refresh) m_refresh();
-                } catch (const std::exception& e) {
-                    QMessageBox::critical(qobject_cast<QWidget*>(parent()), "Ошибка", e.what());
+                KANBAN_TRACE_SCOPE("BoardListsController::assignFromMenu");
+                BoardError error = m_board.tryAssignTask(taskId, devIds[(size_t)devIndex]);
+                if (error != BoardError::None) {
+                    QMessageBox::critical(qobject_cast<QWidget*>(parent()), "Ошибка",
+                                          boardErrorMessage(error));
                 }
             });
 }
 
-QListWidget* BoardListsController::listForViewport(QObject* viewport) const
+QListView* BoardListsController::listForViewport(QObject* viewport) const
 {
     if (m_assigned && viewport == m_assigned->viewport()) return m_assigned;
     if (m_inProgress && viewport == m_inProgress->viewport()) return m_inProgress;
@@ -105,7 +110,7 @@ QListWidget* BoardListsController::listForViewport(QObject* viewport) const
     return 0;
 }
 
-TaskStatus BoardListsController::targetStatusForList(QListWidget* list) const
+TaskStatus BoardListsController::targetStatusForList(QListView* list) const
 {
     if (list == m_assigned) return TaskStatus::Backlog;
     if (list == m_inProgress) return TaskStatus::InProgress;
@@ -117,31 +122,57 @@ bool BoardListsController::eventFilter(QObject* obj, QEvent* event)
     if (event->type() != QEvent::Drop)
         return QObject::eventFilter(obj, event);
 
-    QListWidget* targetList = listForViewport(obj);
+    KANBAN_TRACE_SCOPE("BoardListsController::drop");
+    QListView* targetList = listForViewport(obj);
     if (!targetList) return QObject::eventFilter(obj, event);
 
     QDropEvent* dropEvent = (QDropEvent*)event;
-    QPoint dropPos = dropEvent->position().toPoint();
-
-    QTimer::singleShot(0, this, [this, targetList, dropPos]() {
-        QListWidgetItem* item = targetList->itemAt(dropPos);
-        if (!item) item = targetList->currentItem();
-        if (!item && targetList->count() > 0) item = targetList->item(targetList->count() - 1);
-        if (!item) return;
-
-        int taskId = TaskItemFormat::extractTaskId(item->text());
-        if (taskId < 0) return;
-
-        TaskStatus newStatus = targetStatusForList(targetList);
-
-        try {
-            m_board.changeTaskStatus(taskId, newStatus);
-        } catch (const std::exception& e) {
-            QMessageBox::warning(qobject_cast<QWidget*>(parent()), "Нельзя переместить", e.what());
+    if (!m_editingEnabled) {
+        dropEvent->ignore();
+        return true;
+    }
+    std::vector<int> taskIds = BoardColumnModel::decodeTaskIds(dropEvent->mimeData());
+    if (taskIds.empty()) return QObject::eventFilter(obj, event);
+
+    // Перенос выполняем сами через доску: представление обновится по уведомлению.
+    // CopyAction не даёт исходному представлению удалять строки из модели после перетаскивания.
+    dropEvent->setDropAction(Qt::CopyAction);
+    dropEvent->accept();
+
+    TaskStatus newStatus = targetStatusForList(targetList);
+
+    // Между участками drop и applyDrop в трассе видна задержка очереди событий.
+    QTimer::singleShot(0, this, [this, taskIds, newStatus]() {
+        // Загрузка могла начаться, пока перенос ждал в очереди.
+        if (!m_editingEnabled) return;
+        KANBAN_TRACE_SCOPE_ARG("BoardListsController::applyDrop", "tasks", taskIds.size());
+        // Время переноса без окна с отказами: оно ждёт пользователя.
+        std::vector<TaskStatusFailure> failures;
+        {
+            static metrics::Histogram& duration = metrics::histogram("view.drop");
+            metrics::Timer timer(duration);
+            failures = m_board.changeTaskStatuses(taskIds, newStatus);
+        }
+        if (failures.empty()) return;
+
+        const size_t maxShown = 20;
+        QStringList lines;
+        for (size_t i = 0; i < failures.size() && i < maxShown; ++i) {
+            lines << QString("#%1: %2")
+                         .arg(failures[i].taskId)
+                         .arg(QString::fromStdString(failures[i].reason));
+        }
+        if (failures.size() > maxShown) {
+            lines << QString("… и ещё %1").arg((int)(failures.size() - maxShown));
         }
 
-        if (m_refresh) m_refresh();
+        QMessageBox::warning(qobject_cast<QWidget*>(parent()),
+                             "Нельзя переместить",
+                             QString("Не перемещено задач: %1 из %2\n\n%3")
+                                 .arg((int)failures.size())
+                                 .arg((int)taskIds.size())
+                                 .arg(lines.join("\n")));
     });
 
-    return false;
+    return true;
 }
@@ -3,35 +3,35 @@
 #include <QPoint>
 #include "taskstatus.h"
 
-class QListWidget;
+class QListView;
 class QEvent;
 class ScrumBoard;
 
 class BoardListsController : public QObject {
     Q_OBJECT
 public:
-    using RefreshFn = std::function<void()>;
-
     BoardListsController(ScrumBoard& board,
-                         QListWidget* assigned,
-                         QListWidget* inProgress,
-                         QListWidget* done,
-                         RefreshFn refresh,
+                         QListView* assigned,
+                         QListView* inProgress,
+                         QListView* done,
                          QObject* parent = nullptr);
 
+    // Во время загрузки доски перетаскивание и назначение из меню отключены.
+    void setEditingEnabled(bool enabled);
+
     bool eventFilter(QObject* obj, QEvent* event) override;
 
 private:
-    QListWidget* listForViewport(QObject* viewport) const;
-    TaskStatus targetStatusForList(QListWidget* list) const;
+    QListView* listForViewport(QObject* viewport) const;
+    TaskStatus targetStatusForList(QListView* list) const;
 
-    void setupDnD(QListWidget* list);
-    void setupContextMenu(QListWidget* list);
+    void setupDnD(QListView* list);
+    void setupContextMenu(QListView* list);
 
 private:
     ScrumBoard& m_board;
-    QListWidget* m_assigned{};
-    QListWidget* m_inProgress{};
-    QListWidget* m_done{};
-    RefreshFn m_refresh;
+    QListView* m_assigned{};
+    QListView* m_inProgress{};
+    QListView* m_done{};
+    bool m_editingEnabled = true;
 };
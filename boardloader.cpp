@@ -0,0 +1,192 @@
+#include "boardloader.h"
+#include "metrics.h"
+#include "tracing.h"
+#include <filesystem>
+#include <fstream>
+#include <stdexcept>
+
+class BoardLoader::ChunkHandler : public BoardRecordHandler {
+public:
+    ChunkHandler(BoardLoader& loader, std::istream& in) : loader_(loader), in_(in) {}
+
+    void developer(int id, std::string& name) override {
+        chunk_.developers.emplace_back(id, std::move(name));
+    }
+
+    void task(int id, std::string& title, std::string& description,
+              TaskStatus status, std::optional<int> assignee) override {
+        chunk_.tasks.push_back({id, std::move(title), std::move(description), status, assignee});
+        if (chunk_.tasks.size() >= limit_) {
+            flush();
+            limit_ = kChunkTasks;
+        }
+    }
+
+    bool cancelled() const override { return loader_.cancelRequested_.load(std::memory_order_relaxed); }
+
+    void flush() {
+        // Позиция потока, а не буфера разборщика: точности хватает для индикатора.
+        std::streamoff position = in_.tellg();
+        chunk_.bytesRead = position > 0 ? (std::uint64_t)position : loader_.totalBytes_;
+        loader_.publish(std::move(chunk_));
+        chunk_ = Chunk();
+        chunk_.tasks.reserve(kChunkTasks);
+    }
+
+private:
+    BoardLoader& loader_;
+    std::istream& in_;
+    Chunk chunk_;
+    std::size_t limit_ = kFirstChunkTasks;
+};
+
+BoardLoader::BoardLoader(std::string filename)
+    : filename_(std::move(filename))
+{
+    std::error_code ec;
+    std::uintmax_t size = std::filesystem::file_size(filename_, ec);
+    if (!ec) totalBytes_ = size;
+
+    worker_ = std::async(std::launch::async, [this]() { parse(); });
+}
+
+BoardLoader::~BoardLoader()
+{
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        cancelRequested_ = true;
+    }
+    spaceAvailable_.notify_all();
+    if (worker_.valid()) worker_.wait();
+}
+
+void BoardLoader::cancel()
+{
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        cancelRequested_ = true;
+    }
+    spaceAvailable_.notify_all();
+    if (state_ == State::Running) state_ = State::Cancelled;
+}
+
+void BoardLoader::parse()
+{
+    tracing::setThreadName("Разбор доски");
+    std::string error;
+    try {
+        std::ifstream file(filename_.c_str(), std::ios::binary);
+        if (!file) {
+            throw std::runtime_error("Невозможно открыть файл для чтения");
+        }
+
+        ChunkHandler handler(*this, file);
+        if (BoardSerializer::readRecords(file, handler)) {
+            handler.flush();
+        }
+    } catch (const std::exception& e) {
+        error = e.what();
+    }
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    parseError_ = std::move(error);
+    parsed_ = true;
+}
+
+void BoardLoader::publish(Chunk chunk)
+{
+    std::unique_lock<std::mutex> lock(mutex_);
+    spaceAvailable_.wait(lock, [this]() {
+        return chunks_.size() < kMaxQueuedChunks || cancelRequested_;
+    });
+    if (cancelRequested_) return;
+    chunks_.push_back(std::move(chunk));
+}
+
+// Размер доски оценивается по первой порции, чтобы хранилище не
+// перестраивалось посреди загрузки: такие паузы видны в интерфейсе.
+// Первая порция применяется до резервирования и показывается сразу.
+void BoardLoader::reserveFor(ScrumBoard& board)
+{
+    reserved_ = true;
+    if (bytesApplied_ == 0 || bytesApplied_ >= totalBytes_) return;
+    double estimate = (double)totalTasksApplied_ * (double)totalBytes_ / (double)bytesApplied_;
+    board.reserveTasks((std::size_t)(estimate * 1.1));
+}
+
+// Время — от создания загрузчика до последней применённой порции, как его видит пользователь.
+void BoardLoader::recordFinished()
+{
+    static metrics::Histogram& duration = metrics::histogram("file.load");
+    static metrics::Histogram& bytes = metrics::histogram("file.load_bytes", metrics::Unit::Bytes);
+    duration.record((std::uint64_t)std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now() - started_).count());
+    bytes.record(totalBytes_);
+}
+
+bool BoardLoader::applyPending(ScrumBoard& board, std::size_t maxTasks)
+{
+    KANBAN_TRACE_SCOPE("BoardLoader::applyPending");
+    if (state_ != State::Running) return true;
+    if (!builder_) builder_.emplace(board);
+
+    // Всё, что применено за один вызов, подписчики видят одним пакетом.
+    board.beginBatch();
+    try {
+        std::size_t budget = maxTasks;
+        bool finished = false;
+        while (budget > 0) {
+            if (!current_) {
+                std::unique_lock<std::mutex> lock(mutex_);
+                if (chunks_.empty()) {
+                    if (parsed_) {
+                        finished = true;
+                        if (!parseError_.empty()) error_ = parseError_;
+                    }
+                    break;
+                }
+                current_ = std::move(chunks_.front());
+                chunks_.pop_front();
+                lock.unlock();
+                spaceAvailable_.notify_one();
+                developersApplied_ = 0;
+                tasksApplied_ = 0;
+                if (!reserved_ && totalTasksApplied_ > 0) reserveFor(board);
+            }
+
+            for (; developersApplied_ < current_->developers.size(); ++developersApplied_) {
+                const Developer& developer = current_->developers[developersApplied_];
+                builder_->addDeveloper(developer.id(), developer.name());
+            }
+            for (; tasksApplied_ < current_->tasks.size() && budget > 0; ++tasksApplied_, --budget) {
+                const LoadedTask& task = current_->tasks[tasksApplied_];
+                builder_->addTask(task.id, task.title, task.description, task.status, task.assignee);
+                ++totalTasksApplied_;
+            }
+            if (tasksApplied_ == current_->tasks.size()) {
+                bytesApplied_ = current_->bytesRead;
+                current_.reset();
+            }
+        }
+
+        if (finished) {
+            if (error_.empty()) {
+                builder_->finish();
+                bytesApplied_ = totalBytes_;
+                state_ = State::Finished;
+                recordFinished();
+            } else {
+                state_ = State::Failed;
+            }
+        }
+    } catch (const std::exception& e) {
+        error_ = e.what();
+        state_ = State::Failed;
+        std::lock_guard<std::mutex> lock(mutex_);
+        cancelRequested_ = true;
+    }
+    board.endBatch();
+
+    if (state_ == State::Failed) spaceAvailable_.notify_all();
+    return state_ != State::Running;
+}
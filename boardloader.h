@@ -0,0 +1,110 @@
+#pragma once
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <future>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <vector>
+#include "boardserializer.h"
+#include "scrumboard.h"
+
+// Постепенная загрузка JSON доски. Рабочий поток разбирает файл и складывает
+// записи в очередь порциями: первая порция маленькая, чтобы первые задачи
+// появились на экране почти сразу. Поток-владелец доски забирает порции через
+// applyPending() и применяет их к доске пакетами. Записи проходят через тот же
+// BoardBuilder, что и loadBoardFromFile, поэтому итоговая доска совпадает
+// с блокирующей загрузкой.
+class BoardLoader {
+public:
+    enum class State {
+        Running,
+        Finished,
+        Failed,
+        Cancelled
+    };
+
+    struct Progress {
+        std::uint64_t bytesRead = 0;
+        std::uint64_t totalBytes = 0;
+        std::size_t tasksApplied = 0;
+    };
+
+    static constexpr std::size_t kFirstChunkTasks = 256;
+    static constexpr std::size_t kChunkTasks = 8192;
+    // Сколько разобранных порций может ждать применения, прежде чем разбор
+    // приостановится; ограничивает память при медленном потребителе.
+    static constexpr std::size_t kMaxQueuedChunks = 8;
+
+    // Запускает разбор filename в рабочем потоке.
+    explicit BoardLoader(std::string filename);
+    // Отменяет незаконченный разбор и дожидается рабочего потока.
+    ~BoardLoader();
+
+    BoardLoader(const BoardLoader&) = delete;
+    BoardLoader& operator=(const BoardLoader&) = delete;
+
+    // Применяет к board разобранные записи, но не больше maxTasks задач за вызов.
+    // Все вызовы должны получать одну и ту же доску, изначально пустую.
+    // Возвращает true, когда загрузка закончилась: успешно, с ошибкой или отменой.
+    // При ошибке и отмене доска остаётся заполненной частично.
+    bool applyPending(ScrumBoard& board, std::size_t maxTasks = SIZE_MAX);
+
+    // Останавливает разбор; следующий applyPending() вернёт true.
+    void cancel();
+
+    State state() const noexcept { return state_; }
+    const std::string& error() const noexcept { return error_; }
+    // Прогресс по уже применённым записям.
+    Progress progress() const noexcept { return {bytesApplied_, totalBytes_, totalTasksApplied_}; }
+
+private:
+    struct LoadedTask {
+        int id;
+        std::string title;
+        std::string description;
+        TaskStatus status;
+        std::optional<int> assignee;
+    };
+
+    struct Chunk {
+        std::vector<Developer> developers;
+        std::vector<LoadedTask> tasks;
+        std::uint64_t bytesRead = 0;
+    };
+
+    class ChunkHandler;
+
+    void parse();
+    void publish(Chunk chunk);
+    void reserveFor(ScrumBoard& board);
+    void recordFinished();
+
+    std::string filename_;
+    std::uint64_t totalBytes_ = 0;
+    std::chrono::steady_clock::time_point started_ = std::chrono::steady_clock::now();
+
+    mutable std::mutex mutex_;
+    std::condition_variable spaceAvailable_;
+    std::deque<Chunk> chunks_;
+    bool parsed_ = false;
+    std::atomic<bool> cancelRequested_{false};   // меняется под mutex_
+    std::string parseError_;
+
+    // Состояние потока-владельца доски.
+    std::optional<Chunk> current_;
+    std::size_t developersApplied_ = 0;
+    std::size_t tasksApplied_ = 0;
+    std::size_t totalTasksApplied_ = 0;
+    std::uint64_t bytesApplied_ = 0;
+    bool reserved_ = false;
+    std::optional<BoardBuilder> builder_;
+    State state_ = State::Running;
+    std::string error_;
+
+    std::future<void> worker_;
+};
@@ -0,0 +1,158 @@
+#include "boardquery.h"
+#include "taskutils.h"
+#include <algorithm>
+#include <climits>
+#include <cstdlib>
+#include <stdexcept>
+
+bool TaskFilter::matches(const TaskView& task) const
+{
+    if (!statuses.empty() && std::find(statuses.begin(), statuses.end(), task.status()) == statuses.end()) {
+        return false;
+    }
+    if (assignee && task.assignedDeveloper() != assignee) return false;
+    if (unassigned && task.assignedDeveloper()) return false;
+    if (!ids.empty() && !std::binary_search(ids.begin(), ids.end(), task.id())) return false;
+    return true;
+}
+
+namespace {
+
+int parseId(const std::string& text)
+{
+    char* end = nullptr;
+    long long value = std::strtoll(text.c_str(), &end, 10);
+    if (text.empty() || *end != '\0' || value < INT_MIN || value > INT_MAX) {
+        throw std::invalid_argument("Некорректный ID: " + text);
+    }
+    return (int)value;
+}
+
+template <typename Fn>
+void forEachItem(const std::string& text, Fn fn)
+{
+    std::size_t begin = 0;
+    while (begin <= text.size()) {
+        std::size_t end = std::min(text.find(',', begin), text.size());
+        fn(text.substr(begin, end - begin));
+        begin = end + 1;
+    }
+}
+
+}
+
+std::vector<int> parseIdList(const std::string& text)
+{
+    std::vector<int> ids;
+    forEachItem(text, [&](const std::string& item) {
+        std::size_t dash = item.find('-', 1);
+        if (dash == std::string::npos) {
+            ids.push_back(parseId(item));
+            return;
+        }
+        int first = parseId(item.substr(0, dash));
+        int last = parseId(item.substr(dash + 1));
+        if (first > last || (long long)last - first >= 100000000) {
+            throw std::invalid_argument("Некорректный диапазон ID: " + item);
+        }
+        for (long long id = first; id <= last; ++id) ids.push_back((int)id);
+    });
+    std::sort(ids.begin(), ids.end());
+    ids.erase(std::unique(ids.begin(), ids.end()), ids.end());
+    return ids;
+}
+
+std::vector<TaskStatus> parseStatusList(const std::string& text)
+{
+    std::vector<TaskStatus> statuses;
+    forEachItem(text, [&](const std::string& item) {
+        try {
+            statuses.push_back(stringToTaskStatus(item));
+        } catch (const std::runtime_error&) {
+            throw std::invalid_argument("Неизвестный статус: " + item);
+        }
+    });
+    return statuses;
+}
+
+void BoardStats::addTask(const TaskView& task)
+{
+    ++tasks;
+    ++byStatus[statusIndex(task.status())];
+    textBytes += task.title().size() + task.description().size();
+    if (task.assignedDeveloper()) ++byAssignee[*task.assignedDeveloper()];
+    else ++unassigned;
+}
+
+std::vector<std::pair<int, std::size_t>> BoardStats::topAssignees(std::size_t count) const
+{
+    std::vector<std::pair<int, std::size_t>> top(byAssignee.begin(), byAssignee.end());
+    auto busier = [](const auto& a, const auto& b) {
+        return a.second != b.second ? a.second > b.second : a.first < b.first;
+    };
+    count = std::min(count, top.size());
+    std::partial_sort(top.begin(), top.begin() + (std::ptrdiff_t)count, top.end(), busier);
+    top.resize(count);
+    return top;
+}
+
+BoardRecordEditor::BoardRecordEditor(BoardRecordHandler& next, TaskFilter filter, TaskEdit edit)
+    : next_(next), filter_(std::move(filter)), edit_(edit)
+{
+}
+
+void BoardRecordEditor::developer(int id, std::string& name)
+{
+    if (tasksStarted_) {
+        throw std::runtime_error("Потоковая правка требует, чтобы разработчики шли в файле до задач");
+    }
+    developers_.insert(id);
+    next_.developer(id, name);
+}
+
+void BoardRecordEditor::task(int id, std::string& title, std::string& description,
+                             TaskStatus status, std::optional<int> assignee)
+{
+    tasksStarted_ = true;
+    if (!filter_.matches(TaskView(id, title, description, status, assignee))) {
+        next_.task(id, title, description, status, assignee);
+        return;
+    }
+    ++matched_;
+
+    // Правка применяется целиком или не применяется вовсе.
+    std::optional<int> newAssignee = assignee;
+    TaskStatus newStatus = status;
+    if (edit_.assignTo) {
+        if (!developers_.count(*edit_.assignTo)) {
+            reject(id, BoardError::DeveloperNotFound);
+            next_.task(id, title, description, status, assignee);
+            return;
+        }
+        newAssignee = edit_.assignTo;
+        newStatus = Task::statusAfterAssignment(newStatus);
+    }
+    if (edit_.status) {
+        BoardError error = Task::checkStatusTransition(*edit_.status, newAssignee.has_value());
+        if (error != BoardError::None) {
+            reject(id, error);
+            next_.task(id, title, description, status, assignee);
+            return;
+        }
+        newStatus = *edit_.status;
+    }
+
+    if (newAssignee != assignee || newStatus != status) ++changed_;
+    next_.task(id, title, description, newStatus, newAssignee);
+}
+
+bool BoardRecordEditor::cancelled() const
+{
+    return next_.cancelled();
+}
+
+void BoardRecordEditor::reject(int taskId, BoardError error)
+{
+    ++rejected_;
+    if (failures_.size() < kMaxReportedFailures) failures_.push_back({taskId, error});
+}
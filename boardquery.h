@@ -0,0 +1,91 @@
+#pragma once
+#include <array>
+#include <cstddef>
+#include <optional>
+#include <string>
+#include <unordered_map>
+#include <unordered_set>
+#include <utility>
+#include <vector>
+#include "boardserializer.h"
+
+// Отбор, правка и статистика задач прямо по записям файла доски, без сборки
+// доски в памяти: на этом построен kanban_cli. Память не зависит от числа
+// задач, только от числа разработчиков.
+
+struct TaskFilter {
+    std::vector<TaskStatus> statuses;   // пусто — любой статус
+    std::optional<int> assignee;
+    bool unassigned = false;            // только задачи без исполнителя
+    std::vector<int> ids;               // по возрастанию; пусто — любые
+
+    bool matches(const TaskView& task) const;
+};
+
+// "1,2,5-9" -> {1, 2, 5, 6, 7, 8, 9}; ошибки — std::invalid_argument.
+std::vector<int> parseIdList(const std::string& text);
+// "InProgress,Blocked"
+std::vector<TaskStatus> parseStatusList(const std::string& text);
+
+struct BoardStats {
+    std::size_t developers = 0;
+    std::size_t tasks = 0;
+    std::array<std::size_t, kTaskStatusCount> byStatus{};
+    std::size_t unassigned = 0;
+    std::size_t textBytes = 0;
+    std::unordered_map<int, std::size_t> byAssignee;
+
+    void addTask(const TaskView& task);
+    // count исполнителей с наибольшим числом задач, по убыванию.
+    std::vector<std::pair<int, std::size_t>> topAssignees(std::size_t count) const;
+};
+
+// Назначение применяется раньше статуса, как в интерфейсе.
+struct TaskEdit {
+    std::optional<int> assignTo;
+    std::optional<TaskStatus> status;
+};
+
+struct TaskEditFailure {
+    int taskId;
+    BoardError error;
+};
+
+// Передаёт записи в next (BoardRecordWriter при потоковой правке файла),
+// применяя edit к задачам под filter. Правила те же, что у ScrumBoard:
+// назначение переводит Backlog в Assigned, статусы Assigned и InProgress
+// требуют исполнителя. Отклонённая правка оставляет задачу как есть
+// и попадает в отчёт.
+//
+// Разработчики должны идти в файле до задач, как их пишет BoardRecordWriter:
+// назначение проверяется по уже прочитанным. Иначе — std::runtime_error.
+class BoardRecordEditor : public BoardRecordHandler {
+public:
+    static constexpr std::size_t kMaxReportedFailures = 100;
+
+    BoardRecordEditor(BoardRecordHandler& next, TaskFilter filter, TaskEdit edit);
+
+    void developer(int id, std::string& name) override;
+    void task(int id, std::string& title, std::string& description,
+              TaskStatus status, std::optional<int> assignee) override;
+    bool cancelled() const override;
+
+    std::size_t matched() const noexcept { return matched_; }
+    std::size_t changed() const noexcept { return changed_; }
+    std::size_t rejected() const noexcept { return rejected_; }
+    // Первые kMaxReportedFailures отказов.
+    const std::vector<TaskEditFailure>& failures() const noexcept { return failures_; }
+
+private:
+    void reject(int taskId, BoardError error);
+
+    BoardRecordHandler& next_;
+    TaskFilter filter_;
+    TaskEdit edit_;
+    std::unordered_set<int> developers_;
+    bool tasksStarted_ = false;
+    std::size_t matched_ = 0;
+    std::size_t changed_ = 0;
+    std::size_t rejected_ = 0;
+    std::vector<TaskEditFailure> failures_;
+};
@@ -0,0 +1,48 @@
+#include "boardsaver.h"
+#include "boardserializer.h"
+#include "tracing.h"
+
+BoardSaver::BoardSaver()
+    : BoardSaver([](const ScrumBoard& board, const std::string& filename) {
+        // Сохранение и так идёт в фоне, порции задач форматируются на всех ядрах.
+        saveBoardToFile(board, filename, JsonFormat::Pretty, 0);
+    })
+{}
+
+BoardSaver::BoardSaver(SaveFunction save)
+    : save_(std::move(save))
+{}
+
+BoardSaver::~BoardSaver()
+{
+    try {
+        wait();
+    } catch (...) {
+    }
+}
+
+void BoardSaver::wait()
+{
+    if (worker_.valid()) worker_.get();
+}
+
+bool BoardSaver::save(const ScrumBoard& board, const std::string& filename, Completion done)
+{
+    if (busy()) return false;
+    wait();
+
+    running_.store(true, std::memory_order_release);
+    worker_ = std::async(std::launch::async,
+                         [this, copy = ScrumBoard(board), filename, done = std::move(done)]() {
+                             tracing::setThreadName("Сохранение доски");
+                             std::string error;
+                             try {
+                                 save_(copy, filename);
+                             } catch (const std::exception& e) {
+                                 error = e.what();
+                             }
+                             running_.store(false, std::memory_order_release);
+                             if (done) done(error);
+                         });
+    return true;
+}
@@ -0,0 +1,35 @@
+#pragma once
+#include <atomic>
+#include <functional>
+#include <future>
+#include <string>
+#include "scrumboard.h"
+
+// Фоновое сохранение доски. Копия доски снимается в вызывающем потоке и почти
+// ничего не стоит (столбцы копируются при записи), а сериализация, fsync и
+// атомарная подмена файла выполняются в рабочем потоке. Доску можно менять
+// сразу после вызова save(): в файл попадёт состояние на момент вызова.
+class BoardSaver {
+public:
+    using SaveFunction = std::function<void(const ScrumBoard&, const std::string&)>;
+    // Вызывается в рабочем потоке; error пуст при успехе.
+    using Completion = std::function<void(const std::string& error)>;
+
+    BoardSaver();
+    explicit BoardSaver(SaveFunction save);
+    ~BoardSaver();
+
+    BoardSaver(const BoardSaver&) = delete;
+    BoardSaver& operator=(const BoardSaver&) = delete;
+
+    // false, если предыдущее сохранение ещё идёт.
+    bool save(const ScrumBoard& board, const std::string& filename, Completion done = {});
+
+    bool busy() const noexcept { return running_.load(std::memory_order_acquire); }
+    void wait();
+
+private:
+    SaveFunction save_;
+    std::future<void> worker_;
+    std::atomic<bool> running_{false};
+};
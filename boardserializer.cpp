@@ -1,26 +1,35 @@
 #include "boardserializer.h"
+#include "atomicfile.h"
+#include "metrics.h"
+#include "parallel.h"
 #include "taskutils.h"
+#include "tracing.h"
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <filesystem>
 #include <fstream>
+#include <limits>
+#include <optional>
+#include <ostream>
+#include <sstream>
 #include <stdexcept>
+#include <vector>
 
 nlohmann::json BoardSerializer::serialize(const ScrumBoard& board)
 {
     nlohmann::json json;
 
     json["developers"] = nlohmann::json::array();
-    auto devs = board.getAllDevelopers();
-    for (auto it = devs.begin(); it != devs.end(); ++it) {
+    for (const Developer& dev : board.getAllDevelopers()) {
         nlohmann::json devJson;
-        devJson["id"] = it->second.id();
-        devJson["name"] = it->second.name();
-        json["developers"].push_back(devJson);
+        devJson["id"] = dev.id();
+        devJson["name"] = dev.name();
+        json["developers"].push_back(std::move(devJson));
     }
 
     json["tasks"] = nlohmann::json::array();
-    auto tasks = board.getAllTasks();
-    for (auto it = tasks.begin(); it != tasks.end(); ++it) {
-        const Task& task = it->second;
-
+    for (const TaskView& task : board.getAllTasks()) {
         nlohmann::json taskJson;
         taskJson["id"] = task.id();
         taskJson["title"] = task.title();
@@ -33,7 +42,7 @@ nlohmann::json BoardSerializer::serialize(const ScrumBoard& board)
             taskJson["assignedDeveloperId"] = nullptr;
         }
 
-        json["tasks"].push_back(taskJson);
+        json["tasks"].push_back(std::move(taskJson));
     }
 
     return json;
@@ -57,21 +66,20 @@ ScrumBoard BoardSerializer::deserialize(const nlohmann::json& json)
     }
 
     if (json.contains("tasks")) {
-        for (size_t i = 0; i < json["tasks"].size(); ++i) {
-            int id = json["tasks"][i]["id"].get<int>();
-            std::string title = json["tasks"][i]["title"].get<std::string>();
-            std::string description = json["tasks"][i]["description"].get<std::string>();
-            std::string statusStr = json["tasks"][i]["status"].get<std::string>();
+        for (const nlohmann::json& taskJson : json["tasks"]) {
+            int id = taskJson["id"].get<int>();
+            // Строки читаются по ссылке из DOM и копируются сразу в пул текста доски.
+            const std::string& title = taskJson["title"].get_ref<const std::string&>();
+            const std::string& description = taskJson["description"].get_ref<const std::string&>();
+            const std::string& statusStr = taskJson["status"].get_ref<const std::string&>();
             TaskStatus status = stringToTaskStatus(statusStr);
 
-            board.addTask(Task(id, title, description));
+            board.addTask(TaskView(id, title, description, TaskStatus::Backlog, std::nullopt));
             if (id > maxTaskId) maxTaskId = id;
 
-            if (json["tasks"][i].contains("assignedDeveloperId")) {
-                if (!json["tasks"][i]["assignedDeveloperId"].is_null()) {
-                    int devId = json["tasks"][i]["assignedDeveloperId"].get<int>();
-                    board.assignTask(id, devId);
-                }
+            auto dev = taskJson.find("assignedDeveloperId");
+            if (dev != taskJson.end() && !dev->is_null()) {
+                board.assignTask(id, dev->get<int>());
             }
 
             if (status != TaskStatus::Backlog) {
@@ -86,26 +94,998 @@ ScrumBoard BoardSerializer::deserialize(const nlohmann::json& json)
     return board;
 }
 
-void saveBoardToFile(const ScrumBoard& board, const std::string& filename)
+namespace {
+
+std::optional<int> intField(const nlohmann::json& record, const char* key)
 {
-    std::ofstream file(filename.c_str());
-    if (!file) {
-        throw std::runtime_error("Невозможно открыть файл для записи");
+    auto it = record.find(key);
+    if (it == record.end() || !it->is_number_integer()) return std::nullopt;
+    if (it->is_number_unsigned()) {
+        auto v = it->get<std::uint64_t>();
+        if (v > (std::uint64_t)std::numeric_limits<int>::max()) return std::nullopt;
+        return (int)v;
+    }
+    auto v = it->get<std::int64_t>();
+    if (v < std::numeric_limits<int>::min() || v > std::numeric_limits<int>::max()) return std::nullopt;
+    return (int)v;
+}
+
+const std::string* stringField(const nlohmann::json& record, const char* key)
+{
+    auto it = record.find(key);
+    if (it == record.end() || !it->is_string()) return nullptr;
+    return &it->get_ref<const std::string&>();
+}
+
+const nlohmann::json* recordArray(const nlohmann::json& json, const char* key)
+{
+    if (!json.is_object()) return nullptr;
+    auto it = json.find(key);
+    return it != json.end() && it->is_array() ? &*it : nullptr;
+}
+
+}
+
+// Та же сборка, что у read(), поверх готового DOM: каждая запись проверяется
+// отдельно, и ошибка в одной не мешает остальным.
+ScrumBoard BoardSerializer::deserialize(const nlohmann::json& json, BoardLoadReport& report)
+{
+    ScrumBoard board;
+    BoardBuilder builder(board, &report);
+
+    if (const nlohmann::json* developers = recordArray(json, "developers")) {
+        for (const nlohmann::json& record : *developers) {
+            std::optional<int> id = record.is_object() ? intField(record, "id") : std::nullopt;
+            const std::string* name = record.is_object() ? stringField(record, "name") : nullptr;
+            if (!id || !name) {
+                builder.skipRecord(BoardRecordKind::Developer, id, "Некорректная запись разработчика в файле доски");
+                continue;
+            }
+            builder.addDeveloper(*id, *name);
+        }
+    }
+
+    if (const nlohmann::json* tasks = recordArray(json, "tasks")) {
+        for (const nlohmann::json& record : *tasks) {
+            if (!record.is_object()) {
+                builder.skipRecord(BoardRecordKind::Task, std::nullopt, "Некорректная запись задачи в файле доски");
+                continue;
+            }
+            std::optional<int> id = intField(record, "id");
+            const std::string* title = stringField(record, "title");
+            const std::string* description = stringField(record, "description");
+            const std::string* status = stringField(record, "status");
+            auto dev = record.find("assignedDeveloperId");
+            bool hasAssignee = dev != record.end() && !dev->is_null();
+            std::optional<int> assignee = hasAssignee ? intField(record, "assignedDeveloperId") : std::nullopt;
+            if (!id || !title || !description || !status || (hasAssignee && !assignee)) {
+                builder.skipRecord(BoardRecordKind::Task, id, "Некорректная запись задачи в файле доски");
+                continue;
+            }
+
+            TaskStatus taskStatus;
+            try {
+                taskStatus = stringToTaskStatus(*status);
+            } catch (const std::exception&) {
+                builder.skipRecord(BoardRecordKind::Task, id, "Неизвестный статус задачи в файле доски");
+                continue;
+            }
+            builder.addTask(*id, *title, *description, taskStatus, assignee);
+        }
     }
 
-    nlohmann::json json = BoardSerializer::serialize(board);
-    file << json.dump(4);
+    builder.finish();
+    return board;
 }
 
-ScrumBoard loadBoardFromFile(const std::string& filename)
+namespace {
+
+// Длина корректной последовательности UTF-8 с позиции i; 0 — байт
+// некорректен (лишнее продолжение, длинная запись, суррогат, обрыв).
+std::size_t utf8SequenceLength(std::string_view text, std::size_t i)
 {
-    std::ifstream file(filename.c_str());
+    unsigned char c = (unsigned char)text[i];
+    if (c < 0x80) return 1;
+    std::size_t length;
+    char32_t min;
+    if (c >= 0xC2 && c <= 0xDF) {
+        length = 2;
+        min = 0x80;
+    } else if ((c & 0xF0) == 0xE0) {
+        length = 3;
+        min = 0x800;
+    } else if (c >= 0xF0 && c <= 0xF4) {
+        length = 4;
+        min = 0x10000;
+    } else {
+        return 0;
+    }
+    if (text.size() - i < length) return 0;
+    char32_t cp = c & (0x7F >> length);
+    for (std::size_t k = 1; k < length; ++k) {
+        unsigned char next = (unsigned char)text[i + k];
+        if ((next & 0xC0) != 0x80) return 0;
+        cp = (cp << 6) | (next & 0x3F);
+    }
+    if (cp < min || cp > 0x10FFFF || (cp >= 0xD800 && cp <= 0xDFFF)) return 0;
+    return length;
+}
+
+}
+
+bool isValidUtf8(std::string_view text)
+{
+    for (std::size_t i = 0; i < text.size();) {
+        std::size_t length = utf8SequenceLength(text, i);
+        if (length == 0) return false;
+        i += length;
+    }
+    return true;
+}
+
+namespace {
+
+// Пишет JSON в тех же формате и порядке ключей, что и nlohmann::json::dump:
+// ключи объектов отсортированы, отступ — 4 пробела.
+class JsonBoardWriter {
+public:
+    JsonBoardWriter(std::ostream& out, JsonFormat format)
+        : out_(out), pretty_(format == JsonFormat::Pretty) {}
+
+    // Продолжение уже открытого массива на глубине depth: так порции
+    // массива форматируются отдельно и склеиваются без изменений.
+    JsonBoardWriter(std::ostream& out, JsonFormat format, int depth, bool first)
+        : out_(out), pretty_(format == JsonFormat::Pretty), depth_(depth), first_(first) {}
+
+    void beginObject() { element(); out_ << '{'; ++depth_; first_ = true; }
+    void endObject() { --depth_; if (!first_) newline(); out_ << '}'; first_ = false; }
+    void beginArray() { element(); out_ << '['; ++depth_; first_ = true; }
+    void endArray() { --depth_; if (!first_) newline(); out_ << ']'; first_ = false; }
+
+    void key(const char* name) {
+        element();
+        writeString(name);
+        out_ << (pretty_ ? ": " : ":");
+        first_ = true;
+        afterKey_ = true;
+    }
+
+    void value(int v) { element(); out_ << v; first_ = false; }
+    void value(std::string_view v) { element(); writeString(v); first_ = false; }
+    void null() { element(); out_ << "null"; first_ = false; }
+
+    // Элементы массива, отформатированные отдельным писателем.
+    void rawElements(std::string_view text) {
+        if (text.empty()) return;
+        out_.write(text.data(), (std::streamsize)text.size());
+        first_ = false;
+    }
+
+private:
+    void element() {
+        if (depth_ == 0) return;
+        if (afterKey_) {
+            afterKey_ = false;
+            return;
+        }
+        if (!first_) out_ << ',';
+        newline();
+    }
+
+    void newline() {
+        if (!pretty_) return;
+        out_ << '\n';
+        for (int i = 0; i < depth_; ++i) out_ << "    ";
+    }
+
+    void writeString(std::string_view text) {
+        static const char hex[] = "0123456789abcdef";
+        out_ << '"';
+        size_t start = 0;
+        for (size_t i = 0; i < text.size(); ++i) {
+            unsigned char c = (unsigned char)text[i];
+            const char* escaped = nullptr;
+            switch (c) {
+            case '"': escaped = "\\\""; break;
+            case '\\': escaped = "\\\\"; break;
+            case '\b': escaped = "\\b"; break;
+            case '\f': escaped = "\\f"; break;
+            case '\n': escaped = "\\n"; break;
+            case '\r': escaped = "\\r"; break;
+            case '\t': escaped = "\\t"; break;
+            default:
+                if (c >= 0x80) {
+                    // Кириллица — двухбайтовые символы, их проверяем на месте.
+                    if (c >= 0xC2 && c <= 0xDF && i + 1 < text.size()
+                        && ((unsigned char)text[i + 1] & 0xC0) == 0x80) {
+                        ++i;
+                        continue;
+                    }
+                    std::size_t length = utf8SequenceLength(text, i);
+                    if (length > 0) {
+                        i += length - 1;
+                        continue;
+                    }
+                    // Файл с некорректным UTF-8 не прочитался бы: байт заменяется на U+FFFD.
+                    escaped = "\xEF\xBF\xBD";
+                } else if (c >= 0x20) {
+                    continue;
+                }
+            }
+            out_.write(text.data() + start, (std::streamsize)(i - start));
+            if (escaped) {
+                out_ << escaped;
+            } else {
+                char buf[] = { '\\', 'u', '0', '0', hex[c >> 4], hex[c & 0xF] };
+                out_.write(buf, sizeof(buf));
+            }
+            start = i + 1;
+        }
+        out_.write(text.data() + start, (std::streamsize)(text.size() - start));
+        out_ << '"';
+    }
+
+    std::ostream& out_;
+    bool pretty_;
+    int depth_ = 0;
+    bool first_ = true;
+    bool afterKey_ = false;
+};
+
+bool fitsInt(std::int64_t v) {
+    return v >= std::numeric_limits<int>::min() && v <= std::numeric_limits<int>::max();
+}
+
+enum class RecordSection { None, Developers, Tasks };
+
+// Превращает события SAX-парсера в записи доски. Поля текущего
+// разработчика или задачи накапливаются в буферах, которые переиспользуются.
+class BoardSaxReader : public nlohmann::json_sax<nlohmann::json> {
+public:
+    explicit BoardSaxReader(BoardRecordHandler& handler) : handler_(handler) {}
+
+    // Разбор массива записей секции section, вырезанного из документа.
+    BoardSaxReader(BoardRecordHandler& handler, RecordSection section)
+        : handler_(handler), depth_(1), section_(section) {}
+
+    bool null() override { return true; }
+
+    bool boolean(bool) override { return true; }
+
+    bool number_integer(number_integer_t v) override { return integer(v); }
+
+    bool number_unsigned(number_unsigned_t v) override {
+        return integer((std::int64_t)std::min<number_unsigned_t>(v, std::numeric_limits<std::int64_t>::max()));
+    }
+
+    bool number_float(number_float_t, const string_t&) override { return true; }
+
+    bool string(string_t& v) override {
+        if (!inRecordField()) return true;
+        if (field_ == "name" || field_ == "title") {
+            text_.swap(v);
+            hasText_ = true;
+        } else if (field_ == "description") {
+            description_.swap(v);
+            hasDescription_ = true;
+        } else if (field_ == "status") {
+            try {
+                status_ = stringToTaskStatus(v);
+                hasStatus_ = true;
+            } catch (const std::exception&) {
+                recordError_ = "Неизвестный статус задачи в файле доски";
+            }
+        }
+        return true;
+    }
+
+    bool binary(binary_t&) override { return true; }
+
+    bool start_object(std::size_t) override {
+        ++depth_;
+        if (depth_ == 3 && section_ != Section::None) beginRecord();
+        return true;
+    }
+
+    bool key(string_t& k) override {
+        if (depth_ == 1) sectionKey_.swap(k);
+        else if (depth_ == 3) field_.swap(k);
+        return true;
+    }
+
+    bool end_object() override {
+        --depth_;
+        if (depth_ == 2 && section_ != Section::None) {
+            endRecord();
+            if (handler_.cancelled()) {
+                cancelled_ = true;
+                return false;
+            }
+        }
+        return true;
+    }
+
+    bool start_array(std::size_t) override {
+        ++depth_;
+        if (depth_ == 2) {
+            if (sectionKey_ == "developers") section_ = Section::Developers;
+            else if (sectionKey_ == "tasks") section_ = Section::Tasks;
+        }
+        return true;
+    }
+
+    bool end_array() override {
+        if (depth_ == 2) section_ = Section::None;
+        --depth_;
+        return true;
+    }
+
+    bool parse_error(std::size_t, const std::string&, const nlohmann::detail::exception& ex) override {
+        error_ = ex.what();
+        return false;
+    }
+
+    const std::string& error() const { return error_; }
+    bool cancelled() const { return cancelled_; }
+
+private:
+    using Section = RecordSection;
+
+    bool inRecordField() const { return depth_ == 3 && section_ != Section::None; }
+
+    bool integer(std::int64_t v) {
+        if (!inRecordField()) return true;
+        if (field_ != "id" && field_ != "assignedDeveloperId") return true;
+        if (!fitsInt(v)) {
+            recordError_ = "Некорректный ID в файле доски";
+        } else if (field_ == "id") {
+            id_ = (int)v;
+        } else {
+            assignee_ = (int)v;
+        }
+        return true;
+    }
+
+    void beginRecord() {
+        id_.reset();
+        assignee_.reset();
+        hasText_ = hasDescription_ = hasStatus_ = false;
+        status_ = TaskStatus::Backlog;
+        field_.clear();
+        recordError_.clear();
+    }
+
+    void endRecord() {
+        if (section_ == Section::Developers) {
+            if (recordError_.empty() && (!id_ || !hasText_)) {
+                recordError_ = "Некорректная запись разработчика в файле доски";
+            }
+            if (!recordError_.empty()) handler_.invalidRecord(BoardRecordKind::Developer, id_, recordError_);
+            else handler_.developer(*id_, text_);
+            return;
+        }
+
+        if (recordError_.empty() && (!id_ || !hasText_ || !hasDescription_ || !hasStatus_)) {
+            recordError_ = "Некорректная запись задачи в файле доски";
+        }
+        if (!recordError_.empty()) handler_.invalidRecord(BoardRecordKind::Task, id_, recordError_);
+        else handler_.task(*id_, text_, description_, status_, assignee_);
+    }
+
+    BoardRecordHandler& handler_;
+    bool cancelled_ = false;
+
+    int depth_ = 0;
+    Section section_ = Section::None;
+    std::string sectionKey_;
+    std::string field_;
+
+    std::optional<int> id_;
+    std::optional<int> assignee_;
+    std::string text_;
+    std::string description_;
+    TaskStatus status_ = TaskStatus::Backlog;
+    bool hasText_ = false;
+    bool hasDescription_ = false;
+    bool hasStatus_ = false;
+    std::string recordError_;
+
+    std::string error_;
+};
+
+}
+
+namespace {
+
+void writeDeveloper(JsonBoardWriter& w, int id, std::string_view name)
+{
+    w.beginObject();
+    w.key("id");
+    w.value(id);
+    w.key("name");
+    w.value(name);
+    w.endObject();
+}
+
+void writeDevelopers(JsonBoardWriter& w, const ScrumBoard& board)
+{
+    w.key("developers");
+    w.beginArray();
+    for (const Developer& dev : board.getAllDevelopers()) writeDeveloper(w, dev.id(), dev.name());
+    w.endArray();
+}
+
+void writeTask(JsonBoardWriter& w, const TaskView& task)
+{
+    w.beginObject();
+    w.key("assignedDeveloperId");
+    if (task.assignedDeveloper()) w.value(*task.assignedDeveloper());
+    else w.null();
+    w.key("description");
+    w.value(task.description());
+    w.key("id");
+    w.value(task.id());
+    w.key("status");
+    w.value(taskStatusToString(task.status()));
+    w.key("title");
+    w.value(task.title());
+    w.endObject();
+}
+
+// Границы записей в тексте документа.
+struct RecordSpan {
+    const char* begin;
+    const char* end;
+};
+
+struct BoardLayout {
+    std::vector<RecordSpan> developers;
+    std::vector<RecordSpan> tasks;
+};
+
+// Быстрый проход по структуре документа: находит границы записей в массивах
+// developers и tasks, не разбирая их содержимое. Содержимое записей потом
+// проверяет полноценный разборщик, здесь — только скобки, строки и запятые.
+class BoardLayoutScanner {
+public:
+    explicit BoardLayoutScanner(std::string_view json)
+        : p_(json.data()), end_(json.data() + json.size()) {}
+
+    BoardLayout scan() {
+        BoardLayout layout;
+        skipSpace();
+        expect('{');
+        skipSpace();
+        if (peek() == '}') {
+            ++p_;
+        } else {
+            for (;;) {
+                skipSpace();
+                const char* keyBegin = p_;
+                skipString();
+                std::string_view key(keyBegin, (std::size_t)(p_ - keyBegin));
+                skipSpace();
+                expect(':');
+                skipSpace();
+                if (key == "\"developers\"" && peek() == '[') scanRecords(layout.developers);
+                else if (key == "\"tasks\"" && peek() == '[') scanRecords(layout.tasks);
+                else skipValue();
+                skipSpace();
+                if (peek() == ',') {
+                    ++p_;
+                    continue;
+                }
+                expect('}');
+                break;
+            }
+        }
+        skipSpace();
+        if (p_ != end_) fail();
+        return layout;
+    }
+
+private:
+    char peek() const { return p_ < end_ ? *p_ : '\0'; }
+
+    [[noreturn]] void fail() const {
+        throw std::runtime_error("Некорректный JSON доски: нарушена структура документа");
+    }
+
+    void expect(char c) {
+        if (peek() != c) fail();
+        ++p_;
+    }
+
+    void skipSpace() {
+        while (p_ < end_ && (*p_ == ' ' || *p_ == '\n' || *p_ == '\r' || *p_ == '\t')) ++p_;
+    }
+
+    void skipString() {
+        expect('"');
+        for (;;) {
+            const char* quote = (const char*)std::memchr(p_, '"', (std::size_t)(end_ - p_));
+            if (!quote) fail();
+            // Кавычка экранирована, если перед ней нечётное число обратных косых.
+            const char* slash = quote;
+            while (slash > p_ && slash[-1] == '\\') --slash;
+            p_ = quote + 1;
+            if ((quote - slash) % 2 == 0) return;
+        }
+    }
+
+    void skipValue() {
+        char c = peek();
+        if (c == '"') {
+            skipString();
+            return;
+        }
+        if (c != '{' && c != '[') {
+            const char* start = p_;
+            while (p_ < end_ && *p_ != ',' && *p_ != '}' && *p_ != ']'
+                   && *p_ != ' ' && *p_ != '\n' && *p_ != '\r' && *p_ != '\t') ++p_;
+            if (p_ == start) fail();
+            return;
+        }
+        int depth = 0;
+        do {
+            if (p_ >= end_) fail();
+            c = *p_;
+            if (c == '"') {
+                skipString();
+                continue;
+            }
+            if (c == '{' || c == '[') ++depth;
+            else if (c == '}' || c == ']') --depth;
+            ++p_;
+        } while (depth > 0);
+    }
+
+    void scanRecords(std::vector<RecordSpan>& records) {
+        expect('[');
+        skipSpace();
+        if (peek() == ']') {
+            ++p_;
+            return;
+        }
+        for (;;) {
+            skipSpace();
+            if (peek() != '{') fail();
+            const char* begin = p_;
+            skipValue();
+            records.push_back({begin, p_});
+            skipSpace();
+            if (peek() == ',') {
+                ++p_;
+                continue;
+            }
+            expect(']');
+            return;
+        }
+    }
+
+    const char* p_;
+    const char* end_;
+};
+
+// Разбирает записи [first, last) одним проходом: их текст вместе с запятыми
+// между ними обрамляется скобками и становится массивом.
+void parseRecords(const RecordSpan* first, const RecordSpan* last, RecordSection section,
+                  BoardRecordHandler& handler)
+{
+    if (first == last) return;
+    std::string text;
+    text.reserve((std::size_t)(last[-1].end - first->begin) + 2);
+    text += '[';
+    text.append(first->begin, last[-1].end);
+    text += ']';
+
+    handler.reserve((std::size_t)(last - first), text.size());
+    BoardSaxReader reader(handler, section);
+    if (!nlohmann::json::sax_parse(text, &reader)) {
+        throw std::runtime_error("Некорректный JSON доски: " + reader.error());
+    }
+}
+
+// Задачи, разобранные и проверенные одним рабочим потоком. Текст лежит
+// в общем буфере порции, чтобы не выделять по две строки на задачу. Статус
+// уже тот, что получился бы после assignTask и changeTaskStatus при
+// блокирующей загрузке.
+class TaskCollector : public BoardRecordHandler {
+public:
+    void developer(int, std::string&) override {}
+
+    void task(int id, std::string& title, std::string& description,
+              TaskStatus status, std::optional<int> assignee) override {
+        if (title.empty()) {
+            throw std::invalid_argument("Название задачи не может быть пустым");
+        }
+        if (assignee) status = Task::statusAfterAssignment(status);
+        Task::validateStatusTransition(status, assignee.has_value());
+
+        std::size_t titleOffset = text_.size();
+        text_ += title;
+        text_ += description;
+        tasks_.push_back({id, titleOffset, title.size(), description.size(), status, assignee});
+    }
+
+    void reserve(std::size_t records, std::size_t bytes) override {
+        tasks_.reserve(records);
+        text_.reserve(bytes);
+    }
+
+    // Представления действительны, пока жив сборщик.
+    void appendViews(std::vector<TaskView>& views, int& maxTaskId) const {
+        for (const ParsedTask& task : tasks_) {
+            const char* title = text_.data() + task.titleOffset;
+            views.emplace_back(task.id, std::string_view(title, task.titleLength),
+                               std::string_view(title + task.titleLength, task.descriptionLength),
+                               task.status, task.assignee);
+            maxTaskId = std::max(maxTaskId, task.id);
+        }
+    }
+
+private:
+    struct ParsedTask {
+        int id;
+        std::size_t titleOffset;
+        std::size_t titleLength;
+        std::size_t descriptionLength;
+        TaskStatus status;
+        std::optional<int> assignee;
+    };
+
+    std::vector<ParsedTask> tasks_;
+    std::string text_;
+};
+
+class DeveloperCollector : public BoardRecordHandler {
+public:
+    explicit DeveloperCollector(std::vector<Developer>& developers) : developers_(developers) {}
+
+    void developer(int id, std::string& name) override { developers_.emplace_back(id, name); }
+    void task(int, std::string&, std::string&, TaskStatus, std::optional<int>) override {}
+
+private:
+    std::vector<Developer>& developers_;
+};
+
+}
+
+struct BoardRecordWriter::State {
+    enum class Section { Developers, Tasks, Finished };
+
+    State(std::ostream& out, JsonFormat format) : out(out), w(out, format) {}
+
+    void beginTasks() {
+        w.endArray();
+        w.key("tasks");
+        w.beginArray();
+        section = Section::Tasks;
+    }
+
+    std::ostream& out;
+    JsonBoardWriter w;
+    Section section = Section::Developers;
+};
+
+BoardRecordWriter::BoardRecordWriter(std::ostream& out, JsonFormat format)
+    : state_(std::make_unique<State>(out, format))
+{
+    state_->w.beginObject();
+    state_->w.key("developers");
+    state_->w.beginArray();
+}
+
+BoardRecordWriter::~BoardRecordWriter() = default;
+
+void BoardRecordWriter::developer(int id, std::string_view name)
+{
+    if (state_->section != State::Section::Developers) {
+        throw std::logic_error("Разработчики записываются до задач");
+    }
+    writeDeveloper(state_->w, id, name);
+}
+
+void BoardRecordWriter::task(const TaskView& task)
+{
+    if (state_->section == State::Section::Finished) {
+        throw std::logic_error("Файл доски уже закрыт");
+    }
+    if (state_->section == State::Section::Developers) state_->beginTasks();
+    writeTask(state_->w, task);
+}
+
+void BoardRecordWriter::finish()
+{
+    if (state_->section == State::Section::Finished) return;
+    if (state_->section == State::Section::Developers) state_->beginTasks();
+    state_->w.endArray();
+    state_->w.endObject();
+    state_->section = State::Section::Finished;
+
+    if (!state_->out) {
+        throw std::runtime_error("Ошибка записи доски");
+    }
+}
+
+void BoardSerializer::write(const ScrumBoard& board, std::ostream& out, JsonFormat format)
+{
+    KANBAN_TRACE_SCOPE_ARG("BoardSerializer::write", "tasks", board.getAllTasks().size());
+    BoardRecordWriter writer(out, format);
+    for (const Developer& dev : board.getAllDevelopers()) writer.developer(dev.id(), dev.name());
+    for (const TaskView& task : board.getAllTasks()) writer.task(task);
+    writer.finish();
+}
+
+void BoardSerializer::writeParallel(const ScrumBoard& board, std::ostream& out,
+                                    JsonFormat format, unsigned threads)
+{
+    KANBAN_TRACE_SCOPE_ARG("BoardSerializer::writeParallel", "tasks", board.getAllTasks().size());
+    if (resolveThreadCount(threads) == 1) {
+        write(board, out, format);
+        return;
+    }
+
+    const TaskStore& tasks = board.getAllTasks();
+    std::vector<std::string> parts(resolveThreadCount(threads));
+    parallelFor(tasks.size(), threads, [&](std::size_t part, std::size_t begin, std::size_t end) {
+        std::ostringstream buffer;
+        JsonBoardWriter w(buffer, format, 2, begin == 0);
+        for (std::size_t slot = begin; slot < end; ++slot) writeTask(w, tasks.view((TaskStore::Slot)slot));
+        parts[part] = buffer.str();
+    });
+
+    JsonBoardWriter w(out, format);
+    w.beginObject();
+    writeDevelopers(w, board);
+    w.key("tasks");
+    w.beginArray();
+    for (const std::string& part : parts) w.rawElements(part);
+    w.endArray();
+    w.endObject();
+
+    if (!out) {
+        throw std::runtime_error("Ошибка записи доски");
+    }
+}
+
+namespace {
+
+class BuildingHandler : public BoardRecordHandler {
+public:
+    explicit BuildingHandler(ScrumBoard& board, BoardLoadReport* report = nullptr)
+        : builder_(board, report) {}
+
+    void developer(int id, std::string& name) override { builder_.addDeveloper(id, name); }
+
+    void task(int id, std::string& title, std::string& description,
+              TaskStatus status, std::optional<int> assignee) override {
+        builder_.addTask(id, title, description, status, assignee);
+    }
+
+    void invalidRecord(BoardRecordKind kind, std::optional<int> id, const std::string& message) override {
+        builder_.skipRecord(kind, id, message);
+    }
+
+    BoardBuilder& builder() { return builder_; }
+
+private:
+    BoardBuilder builder_;
+};
+
+}
+
+void BoardRecordHandler::invalidRecord(BoardRecordKind, std::optional<int>, const std::string& message)
+{
+    throw std::runtime_error(message);
+}
+
+void BoardBuilder::addDeveloper(int id, std::string_view name)
+{
+    std::size_t index = developers_++;
+    // Конструктор Developer бросает на пустом имени: проверяем до него.
+    BoardError error = name.empty() ? BoardError::EmptyName : board_.tryAddDeveloper(Developer(id, name));
+    if (error != BoardError::None) {
+        report(BoardRecordKind::Developer, index, id, error);
+        return;
+    }
+    if (id > maxDevId_) maxDevId_ = id;
+}
+
+void BoardBuilder::addTask(int id, std::string_view title, std::string_view description,
+                           TaskStatus status, std::optional<int> assignee)
+{
+    std::size_t index = tasks_++;
+    BoardError error = board_.tryAddTask(TaskView(id, title, description, TaskStatus::Backlog, std::nullopt));
+    if (error != BoardError::None) {
+        report(BoardRecordKind::Task, index, id, error);
+        return;
+    }
+    if (id > maxTaskId_) maxTaskId_ = id;
+
+    if (assignee && !board_.findDeveloper(*assignee)) {
+        // Разработчики записаны после задач: назначение откладывается до конца файла.
+        pending_.push_back({id, index, *assignee, status});
+        return;
+    }
+    if (assignee) {
+        applyAssignment(id, index, *assignee, status);
+    } else if (status != TaskStatus::Backlog) {
+        report(BoardRecordKind::Task, index, id, board_.tryChangeTaskStatus(id, status));
+    }
+}
+
+void BoardBuilder::applyAssignment(int taskId, std::size_t index, int developerId, TaskStatus status)
+{
+    report(BoardRecordKind::Task, index, taskId, board_.tryAssignTask(taskId, developerId));
+    if (status != TaskStatus::Backlog) {
+        report(BoardRecordKind::Task, index, taskId, board_.tryChangeTaskStatus(taskId, status));
+    }
+}
+
+void BoardBuilder::skipRecord(BoardRecordKind kind, std::optional<int> id, const std::string& message)
+{
+    std::size_t index = kind == BoardRecordKind::Developer ? developers_++ : tasks_++;
+    if (!report_) throw std::runtime_error(message);
+    report_->issues.push_back({kind, index, id, BoardError::None, message});
+}
+
+void BoardBuilder::report(BoardRecordKind kind, std::size_t index, std::optional<int> id, BoardError error)
+{
+    if (error == BoardError::None) return;
+    if (!report_) throwIfError(error);
+    report_->issues.push_back({kind, index, id, error, boardErrorMessage(error)});
+}
+
+void BoardBuilder::finish()
+{
+    for (const PendingAssignment& p : pending_) applyAssignment(p.taskId, p.index, p.developerId, p.status);
+    pending_.clear();
+    board_.setNextDeveloperId(maxDevId_ + 1);
+    board_.setNextTaskId(maxTaskId_ + 1);
+}
+
+bool BoardSerializer::readRecords(std::istream& in, BoardRecordHandler& handler)
+{
+    KANBAN_TRACE_SCOPE("BoardSerializer::readRecords");
+    BoardSaxReader reader(handler);
+    if (nlohmann::json::sax_parse(in, &reader)) return true;
+    if (reader.cancelled()) return false;
+    throw std::runtime_error("Некорректный JSON доски: " + reader.error());
+}
+
+namespace {
+
+// sizeHint — размер исходного текста, если он известен заранее: первый
+// буфер арены берётся под него, иначе арена растёт по мере разбора.
+ScrumBoard emptyBoard(BoardStorage storage, std::size_t sizeHint)
+{
+    if (storage == BoardStorage::Arena) return ScrumBoard::withArena(sizeHint);
+    return ScrumBoard();
+}
+
+}
+
+ScrumBoard BoardSerializer::read(std::istream& in, BoardStorage storage)
+{
+    ScrumBoard board = emptyBoard(storage, 0);
+    BuildingHandler handler(board);
+    readRecords(in, handler);
+    handler.builder().finish();
+    return board;
+}
+
+ScrumBoard BoardSerializer::read(std::istream& in, BoardLoadReport& report)
+{
+    ScrumBoard board;
+    BuildingHandler handler(board, &report);
+    readRecords(in, handler);
+    handler.builder().finish();
+    return board;
+}
+
+// Разработчиков мало, они разбираются сразу. Задачи делятся на смежные
+// порции по числу потоков; порции склеиваются в исходном порядке и попадают
+// в доску одним addTasks, поэтому доска совпадает с результатом read().
+ScrumBoard BoardSerializer::readParallel(std::string_view json, unsigned threads, BoardStorage storage)
+{
+    KANBAN_TRACE_SCOPE_ARG("BoardSerializer::readParallel", "bytes", json.size());
+    BoardLayout layout = BoardLayoutScanner(json).scan();
+
+    std::vector<Developer> developers;
+    DeveloperCollector developerCollector(developers);
+    const RecordSpan* devs = layout.developers.data();
+    parseRecords(devs, devs + layout.developers.size(), RecordSection::Developers, developerCollector);
+
+    std::vector<TaskCollector> parts(resolveThreadCount(threads));
+    const RecordSpan* spans = layout.tasks.data();
+    parallelFor(layout.tasks.size(), threads, [&](std::size_t part, std::size_t begin, std::size_t end) {
+        parseRecords(spans + begin, spans + end, RecordSection::Tasks, parts[part]);
+    });
+
+    ScrumBoard board = emptyBoard(storage, json.size());
+    int maxDevId = 0;
+    for (const Developer& developer : developers) {
+        board.addDeveloper(developer);
+        maxDevId = std::max(maxDevId, developer.id());
+    }
+
+    std::vector<TaskView> views;
+    views.reserve(layout.tasks.size());
+    int maxTaskId = 0;
+    for (const TaskCollector& part : parts) part.appendViews(views, maxTaskId);
+    board.addTasks(views);
+
+    board.setNextDeveloperId(maxDevId + 1);
+    board.setNextTaskId(maxTaskId + 1);
+    return board;
+}
+
+namespace {
+
+// Загрузка целиком и BoardLoader пишут в одни показатели.
+metrics::Histogram& loadDuration()
+{
+    static metrics::Histogram& duration = metrics::histogram("file.load");
+    return duration;
+}
+
+void recordLoadBytes(const std::string& filename)
+{
+    static metrics::Histogram& bytes = metrics::histogram("file.load_bytes", metrics::Unit::Bytes);
+    std::error_code ec;
+    std::uintmax_t size = std::filesystem::file_size(filename, ec);
+    if (!ec) bytes.record(size);
+}
+
+}
+
+void saveBoardToFile(const ScrumBoard& board, const std::string& filename, JsonFormat format,
+                     unsigned threads)
+{
+    KANBAN_TRACE_SCOPE("saveBoardToFile");
+    static metrics::Histogram& duration = metrics::histogram("file.save");
+    static metrics::Histogram& bytes = metrics::histogram("file.save_bytes", metrics::Unit::Bytes);
+    metrics::Timer timer(duration);
+    std::streamoff written = 0;
+    writeFileAtomically(filename, [&](std::ostream& out) {
+        if (threads == 1) BoardSerializer::write(board, out, format);
+        else BoardSerializer::writeParallel(board, out, format, threads);
+        written = out.tellp();
+    });
+    bytes.record((std::uint64_t)std::max<std::streamoff>(written, 0));
+}
+
+ScrumBoard loadBoardFromFile(const std::string& filename, unsigned threads, BoardStorage storage)
+{
+    KANBAN_TRACE_SCOPE("loadBoardFromFile");
+    metrics::Timer timer(loadDuration());
+    std::ifstream file(filename.c_str(), std::ios::binary);
     if (!file) {
         throw std::runtime_error("Невозможно открыть файл для чтения");
     }
+    recordLoadBytes(filename);
+    if (threads == 1) return BoardSerializer::read(file, storage);
 
-    nlohmann::json json;
-    file >> json;
+    // Параллельному разбору нужен весь текст сразу.
+    std::string json;
+    file.seekg(0, std::ios::end);
+    json.resize((std::size_t)file.tellg());
+    file.seekg(0, std::ios::beg);
+    if (!file.read(&json[0], (std::streamsize)json.size())) {
+        throw std::runtime_error("Ошибка чтения файла доски");
+    }
+    return BoardSerializer::readParallel(json, threads, storage);
+}
 
-    return BoardSerializer::deserialize(json);
+ScrumBoard loadBoardFromFile(const std::string& filename, BoardLoadReport& report)
+{
+    KANBAN_TRACE_SCOPE("loadBoardFromFile");
+    metrics::Timer timer(loadDuration());
+    std::ifstream file(filename.c_str(), std::ios::binary);
+    if (!file) {
+        throw std::runtime_error("Невозможно открыть файл для чтения");
+    }
+    recordLoadBytes(filename);
+    return BoardSerializer::read(file, report);
 }
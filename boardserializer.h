@@ -1,13 +1,162 @@
 #pragma once
 #include <nlohmann/json.hpp>
 #include "scrumboard.h"
+#include <iosfwd>
+#include <memory>
+#include <optional>
 #include <string>
+#include <string_view>
+#include <vector>
+
+enum class JsonFormat {
+    Pretty,     // как json.dump(4)
+    Compact     // как json.dump()
+};
+
+// Где загруженная доска держит память.
+enum class BoardStorage {
+    Shared,     // ресурсы частей, память возвращается по мере правок
+    Arena       // своя арена (ScrumBoard::withArena), освобождается целиком
+};
+
+enum class BoardRecordKind { Developer, Task };
+
+// Запись файла доски, которую терпимая загрузка пропустила или применила
+// не полностью.
+struct BoardLoadIssue {
+    BoardRecordKind kind;
+    std::size_t index;          // номер записи в массиве developers или tasks
+    std::optional<int> id;      // если ID удалось прочитать
+    BoardError error;           // None, если запись нарушает формат файла
+    std::string message;
+};
+
+// Итог терпимой загрузки: все найденные проблемы, а не только первая.
+struct BoardLoadReport {
+    std::vector<BoardLoadIssue> issues;
+
+    bool clean() const noexcept { return issues.empty(); }
+};
+
+// Получатель записей файла доски в порядке их следования. Строки можно
+// забирать себе: после вызова буферы разборщика не используются.
+class BoardRecordHandler {
+public:
+    virtual ~BoardRecordHandler() = default;
+    virtual void developer(int id, std::string& name) = 0;
+    virtual void task(int id, std::string& title, std::string& description,
+                      TaskStatus status, std::optional<int> assignee) = 0;
+    // Проверяется после каждой записи; true прерывает разбор.
+    virtual bool cancelled() const { return false; }
+    // Подсказка перед разбором: примерное число записей и байт текста.
+    virtual void reserve(std::size_t /*records*/, std::size_t /*bytes*/) {}
+    // Запись нарушает формат: нет поля, неизвестный статус, ID не влезает в int.
+    // По умолчанию разбор прерывается исключением.
+    virtual void invalidRecord(BoardRecordKind kind, std::optional<int> id, const std::string& message);
+};
+
+// Пишет файл доски по одной записи, не собирая доску в памяти: так
+// генератор выдаёт доски любого размера. Сначала идут все разработчики,
+// затем задачи; текст тот же, что у BoardSerializer::write(). Как
+// получатель записей переписывает разобранный файл, например после правки.
+class BoardRecordWriter : public BoardRecordHandler {
+public:
+    explicit BoardRecordWriter(std::ostream& out, JsonFormat format = JsonFormat::Pretty);
+    ~BoardRecordWriter();
+
+    BoardRecordWriter(const BoardRecordWriter&) = delete;
+    BoardRecordWriter& operator=(const BoardRecordWriter&) = delete;
+
+    // Разработчик после первой задачи — std::logic_error.
+    void developer(int id, std::string_view name);
+    void task(const TaskView& task);
+
+    void developer(int id, std::string& name) override { developer(id, std::string_view(name)); }
+    void task(int id, std::string& title, std::string& description,
+              TaskStatus status, std::optional<int> assignee) override {
+        task(TaskView(id, title, description, status, assignee));
+    }
+    // Закрывает документ; при ошибке потока выбрасывает исключение.
+    void finish();
+
+private:
+    struct State;
+    std::unique_ptr<State> state_;
+};
+
+// Собирает доску из записей файла. Блокирующая и постепенная загрузка
+// обе идут через него, поэтому дают одинаковую доску.
+//
+// С отчётом сборщик терпим к ошибкам: запись, которую нельзя добавить,
+// пропускается, а у задачи с неверным назначением или статусом остаётся
+// то, что удалось применить. Каждая проблема попадает в отчёт.
+class BoardBuilder {
+public:
+    explicit BoardBuilder(ScrumBoard& board, BoardLoadReport* report = nullptr)
+        : board_(board), report_(report) {}
+
+    void addDeveloper(int id, std::string_view name);
+    void addTask(int id, std::string_view title, std::string_view description,
+                 TaskStatus status, std::optional<int> assignee);
+    // Запись нарушает формат: без отчёта выбрасывает исключение.
+    void skipRecord(BoardRecordKind kind, std::optional<int> id, const std::string& message);
+    // Назначения на разработчиков, записанных после задачи, и следующие ID.
+    void finish();
+
+private:
+    struct PendingAssignment {
+        int taskId;
+        std::size_t index;
+        int developerId;
+        TaskStatus status;
+    };
+
+    void applyAssignment(int taskId, std::size_t index, int developerId, TaskStatus status);
+    // Без отчёта выбрасывает исключение, как бросающие методы доски.
+    void report(BoardRecordKind kind, std::size_t index, std::optional<int> id, BoardError error);
+
+    ScrumBoard& board_;
+    BoardLoadReport* report_;
+    std::size_t developers_ = 0;
+    std::size_t tasks_ = 0;
+    int maxDevId_ = 0;
+    int maxTaskId_ = 0;
+    std::vector<PendingAssignment> pending_;
+};
 
 class BoardSerializer {
 public:
     static nlohmann::json serialize(const ScrumBoard& board);
     static ScrumBoard deserialize(const nlohmann::json& json);
+    // Терпимые варианты: ошибочные записи пропускаются и попадают в report.
+    // Исключение выбрасывается только если сам JSON не разбирается.
+    static ScrumBoard deserialize(const nlohmann::json& json, BoardLoadReport& report);
+
+    // Потоковые варианты без промежуточного DOM: в памяти одновременно
+    // находится не больше одной записи.
+    static void write(const ScrumBoard& board, std::ostream& out,
+                      JsonFormat format = JsonFormat::Pretty);
+    static ScrumBoard read(std::istream& in, BoardStorage storage = BoardStorage::Shared);
+    static ScrumBoard read(std::istream& in, BoardLoadReport& report);
+    // Разбирает поток и отдаёт записи по одной; false, если разбор прерван.
+    static bool readRecords(std::istream& in, BoardRecordHandler& handler);
+
+    // Параллельные варианты: задачи делятся на порции, которые форматируются
+    // или разбираются на threads потоках (0 — по числу ядер). Результат тот же,
+    // что у write() и read().
+    static void writeParallel(const ScrumBoard& board, std::ostream& out,
+                              JsonFormat format = JsonFormat::Pretty, unsigned threads = 0);
+    static ScrumBoard readParallel(std::string_view json, unsigned threads = 0,
+                                   BoardStorage storage = BoardStorage::Shared);
 };
 
-void saveBoardToFile(const ScrumBoard& board, const std::string& filename);
-ScrumBoard loadBoardFromFile(const std::string& filename);
+// Файл доски хранит текст в UTF-8: при записи некорректные байты
+// заменяются на U+FFFD, импорт такой текст отклоняет.
+bool isValidUtf8(std::string_view text);
+
+// threads != 1 включает параллельные варианты.
+void saveBoardToFile(const ScrumBoard& board, const std::string& filename,
+                     JsonFormat format = JsonFormat::Pretty, unsigned threads = 1);
+ScrumBoard loadBoardFromFile(const std::string& filename, unsigned threads = 1,
+                             BoardStorage storage = BoardStorage::Shared);
+ScrumBoard loadBoardFromFile(const std::string& filename, BoardLoadReport& report);
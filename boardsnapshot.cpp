@@ -0,0 +1,485 @@
+#include "boardsnapshot.h"
+#include "atomicfile.h"
+#include "metrics.h"
+#include "boardserializer.h"
+#include "tracing.h"
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+#include <stdexcept>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace {
+
+const char kMagic[8] = { 'K', 'B', 'S', 'N', 'A', 'P', '\0', '\0' };
+
+constexpr std::uint64_t kPrime1 = 0x9E3779B185EBCA87ull;
+constexpr std::uint64_t kPrime2 = 0xC2B2AE3D27D4EB4Full;
+
+std::uint64_t rotl(std::uint64_t x, int r) { return (x << r) | (x >> (64 - r)); }
+
+// Контрольная сумма по 32-байтовым полосам из четырёх независимых слов:
+// цепочки умножений идут параллельно, поэтому проверка снимка на 1М задач
+// занимает миллисекунды.
+class Checksum {
+public:
+    void update(const void* data, std::size_t size) {
+        const unsigned char* p = static_cast<const unsigned char*>(data);
+        length_ += size;
+        if (pending_ > 0) {
+            std::size_t take = std::min(size, kStripe - pending_);
+            std::memcpy(buffer_ + pending_, p, take);
+            pending_ += take;
+            p += take;
+            size -= take;
+            if (pending_ < kStripe) return;
+            mix(buffer_);
+            pending_ = 0;
+        }
+        for (; size >= kStripe; p += kStripe, size -= kStripe) mix(p);
+        std::memcpy(buffer_, p, size);
+        pending_ = size;
+    }
+
+    std::uint64_t value() const {
+        std::uint64_t h = rotl(lanes_[0], 1) + rotl(lanes_[1], 7) + rotl(lanes_[2], 12) + rotl(lanes_[3], 18);
+        for (std::size_t i = 0; i < pending_; i += 8) {
+            unsigned char word[8] = {};
+            std::memcpy(word, buffer_ + i, std::min<std::size_t>(8, pending_ - i));
+            h = round(h, load(word));
+        }
+        h ^= length_;
+        h ^= h >> 33;
+        h *= kPrime2;
+        h ^= h >> 29;
+        return h;
+    }
+
+private:
+    static constexpr std::size_t kStripe = 32;
+
+    static std::uint64_t load(const unsigned char* p) {
+        std::uint64_t w;
+        std::memcpy(&w, p, 8);
+        return w;
+    }
+
+    static std::uint64_t round(std::uint64_t acc, std::uint64_t w) {
+        return rotl(acc ^ (w * kPrime2), 31) * kPrime1;
+    }
+
+    void mix(const unsigned char* stripe) {
+        for (int i = 0; i < 4; ++i) lanes_[i] = round(lanes_[i], load(stripe + 8 * i));
+    }
+
+    std::uint64_t lanes_[4] = { kPrime1, kPrime2, ~kPrime1, ~kPrime2 };
+    std::uint64_t length_ = 0;
+    unsigned char buffer_[kStripe] = {};
+    std::size_t pending_ = 0;
+};
+
+// Сумма снимка: байты после заголовка, затем сам заголовок с обнулённым
+// полем checksum, чтобы испорченные счётчики и смещения тоже находились.
+std::uint64_t snapshotChecksum(Checksum payload, snapshot::Header header)
+{
+    header.checksum = 0;
+    payload.update(&header, sizeof(header));
+    return payload.value();
+}
+
+std::uint64_t alignUp(std::uint64_t offset) { return (offset + 7) & ~std::uint64_t(7); }
+
+// Пишет секции файла и одновременно считает контрольную сумму.
+class SnapshotWriter {
+public:
+    explicit SnapshotWriter(std::ostream& out) : out_(out) {}
+
+    void write(const void* data, std::size_t size) {
+        out_.write(static_cast<const char*>(data), (std::streamsize)size);
+        checksum_.update(data, size);
+        offset_ += size;
+    }
+
+    void padTo(std::uint64_t offset) {
+        static const char zeros[8] = {};
+        write(zeros, (std::size_t)(offset - offset_));
+    }
+
+    std::uint64_t offset() const { return offset_; }
+    std::uint64_t checksum(const snapshot::Header& header) const { return snapshotChecksum(checksum_, header); }
+
+private:
+    std::ostream& out_;
+    Checksum checksum_;
+    std::uint64_t offset_ = sizeof(snapshot::Header);
+};
+
+// Таблица строк: одинаковые строки записываются один раз. Текст задач доски
+// уже интернирован в пуле, поэтому равные строки узнаются по адресу.
+class StringTable {
+public:
+    void reserve(std::size_t count) { offsets_.reserve(count); }
+
+    std::uint32_t add(std::string_view text) {
+        auto it = offsets_.find(text.data());
+        if (it != offsets_.end() && it->second.second == text.size()) return it->second.first;
+        if (size_ + text.size() > UINT32_MAX) {
+            throw std::runtime_error("Таблица строк снимка превышает 4 ГБ");
+        }
+        std::uint32_t offset = (std::uint32_t)size_;
+        offsets_[text.data()] = {offset, text.size()};
+        order_.push_back(text);
+        size_ += text.size();
+        return offset;
+    }
+
+    std::uint64_t size() const { return size_; }
+    const std::vector<std::string_view>& strings() const { return order_; }
+
+private:
+    std::unordered_map<const char*, std::pair<std::uint32_t, std::size_t>> offsets_;
+    std::vector<std::string_view> order_;
+    std::uint64_t size_ = 0;
+};
+
+void writeSnapshot(const ScrumBoard& board, std::ostream& file, std::uint64_t journalSequence)
+{
+    const ScrumBoard::DeveloperList& devs = board.getAllDevelopers();
+    const TaskStore& tasks = board.getAllTasks();
+    if (tasks.size() > UINT32_MAX) {
+        throw std::runtime_error("Слишком много задач для снимка");
+    }
+
+    snapshot::Header header = {};
+    std::memcpy(header.magic, kMagic, sizeof(kMagic));
+    header.version = snapshot::kVersion;
+    header.byteOrder = snapshot::kByteOrderMark;
+    header.developerCount = (std::uint32_t)devs.size();
+    header.taskCount = (std::uint32_t)tasks.size();
+    header.nextDeveloperId = board.peekNextDeveloperId();
+    header.nextTaskId = board.peekNextTaskId();
+    header.journalSequence = journalSequence;
+
+    // Заголовок пишется дважды: сначала место под него, в конце — итоговый.
+    file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+
+    SnapshotWriter out(file);
+    StringTable strings;
+    strings.reserve(devs.size() + tasks.textPool().uniqueStrings());
+
+    header.developersOffset = out.offset();
+    for (const Developer& dev : devs) {
+        snapshot::DeveloperRecord rec = {};
+        rec.id = dev.id();
+        rec.nameOffset = strings.add(dev.name());
+        rec.nameLength = (std::uint32_t)dev.name().size();
+        out.write(&rec, sizeof(rec));
+    }
+
+    out.padTo(alignUp(out.offset()));
+    header.tasksOffset = out.offset();
+    std::vector<snapshot::IndexEntry> index;
+    index.reserve(tasks.size());
+    std::uint32_t record = 0;
+    for (const TaskView& task : tasks) {
+        snapshot::TaskRecord rec = {};
+        rec.id = task.id();
+        rec.assignee = task.assignedDeveloper() ? *task.assignedDeveloper() : snapshot::kNoDeveloper;
+        rec.titleOffset = strings.add(task.title());
+        rec.titleLength = (std::uint32_t)task.title().size();
+        rec.descriptionOffset = strings.add(task.description());
+        rec.descriptionLength = (std::uint32_t)task.description().size();
+        rec.status = (std::uint8_t)task.status();
+        out.write(&rec, sizeof(rec));
+        index.push_back({task.id(), record++});
+    }
+
+    out.padTo(alignUp(out.offset()));
+    header.indexOffset = out.offset();
+    std::sort(index.begin(), index.end(),
+              [](const snapshot::IndexEntry& a, const snapshot::IndexEntry& b) { return a.id < b.id; });
+    if (!index.empty()) out.write(index.data(), index.size() * sizeof(snapshot::IndexEntry));
+
+    header.stringsOffset = out.offset();
+    header.stringsSize = strings.size();
+    for (std::string_view text : strings.strings()) out.write(text.data(), text.size());
+
+    header.fileSize = out.offset();
+    header.checksum = out.checksum(header);
+    file.seekp(0);
+    file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+}
+
+[[noreturn]] void corrupted() {
+    throw std::runtime_error("Файл снимка доски повреждён");
+}
+
+}
+
+std::uint64_t snapshot::checksum(const void* data, std::size_t size)
+{
+    Checksum sum;
+    sum.update(data, size);
+    return sum.value();
+}
+
+void saveBoardSnapshot(const ScrumBoard& board, const std::string& filename,
+                       std::uint64_t journalSequence)
+{
+    KANBAN_TRACE_SCOPE_ARG("saveBoardSnapshot", "tasks", board.getAllTasks().size());
+    static metrics::Histogram& duration = metrics::histogram("snapshot.save");
+    metrics::Timer timer(duration);
+    writeFileAtomically(filename, [&](std::ostream& out) {
+        writeSnapshot(board, out, journalSequence);
+    });
+}
+
+BoardSnapshot BoardSnapshot::open(const std::string& filename, Verify verify)
+{
+    KANBAN_TRACE_SCOPE("BoardSnapshot::open");
+    BoardSnapshot snap;
+
+#ifdef _WIN32
+    HANDLE file = CreateFileA(filename.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr,
+                              OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+    if (file == INVALID_HANDLE_VALUE) {
+        throw std::runtime_error("Невозможно открыть файл для чтения");
+    }
+    snap.file_ = file;
+
+    LARGE_INTEGER size;
+    if (!GetFileSizeEx(file, &size)) corrupted();
+    snap.size_ = (std::size_t)size.QuadPart;
+    if (snap.size_ < sizeof(snapshot::Header)) corrupted();
+
+    HANDLE mapping = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+    if (!mapping) {
+        throw std::runtime_error("Невозможно отобразить файл снимка в память");
+    }
+    snap.mapping_ = mapping;
+    snap.data_ = static_cast<const char*>(MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0));
+    if (!snap.data_) {
+        throw std::runtime_error("Невозможно отобразить файл снимка в память");
+    }
+#else
+    int fd = ::open(filename.c_str(), O_RDONLY);
+    if (fd < 0) {
+        throw std::runtime_error("Невозможно открыть файл для чтения");
+    }
+
+    struct stat st;
+    if (::fstat(fd, &st) != 0 || (std::size_t)st.st_size < sizeof(snapshot::Header)) {
+        ::close(fd);
+        corrupted();
+    }
+
+    void* data = ::mmap(nullptr, (std::size_t)st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    ::close(fd);
+    if (data == MAP_FAILED) {
+        throw std::runtime_error("Невозможно отобразить файл снимка в память");
+    }
+    snap.data_ = static_cast<const char*>(data);
+    snap.size_ = (std::size_t)st.st_size;
+#endif
+
+    snap.validate(verify);
+    return snap;
+}
+
+BoardSnapshot::BoardSnapshot(BoardSnapshot&& other) noexcept
+    : data_(other.data_), size_(other.size_)
+#ifdef _WIN32
+    , file_(other.file_), mapping_(other.mapping_)
+#endif
+{
+    other.data_ = nullptr;
+    other.size_ = 0;
+#ifdef _WIN32
+    other.file_ = nullptr;
+    other.mapping_ = nullptr;
+#endif
+}
+
+BoardSnapshot& BoardSnapshot::operator=(BoardSnapshot&& other) noexcept
+{
+    if (this != &other) {
+        unmap();
+        std::swap(data_, other.data_);
+        std::swap(size_, other.size_);
+#ifdef _WIN32
+        std::swap(file_, other.file_);
+        std::swap(mapping_, other.mapping_);
+#endif
+    }
+    return *this;
+}
+
+BoardSnapshot::~BoardSnapshot()
+{
+    unmap();
+}
+
+void BoardSnapshot::unmap() noexcept
+{
+#ifdef _WIN32
+    if (data_) UnmapViewOfFile(data_);
+    if (mapping_) CloseHandle(mapping_);
+    if (file_) CloseHandle(file_);
+    file_ = nullptr;
+    mapping_ = nullptr;
+#else
+    if (data_) ::munmap(const_cast<char*>(data_), size_);
+#endif
+    data_ = nullptr;
+    size_ = 0;
+}
+
+void BoardSnapshot::validate(Verify verify) const
+{
+    const snapshot::Header& h = header();
+    if (std::memcmp(h.magic, kMagic, sizeof(kMagic)) != 0) {
+        throw std::runtime_error("Файл не является снимком доски");
+    }
+    if (h.byteOrder != snapshot::kByteOrderMark) {
+        throw std::runtime_error("Снимок доски записан с другим порядком байтов");
+    }
+    if (h.version != snapshot::kVersion) {
+        throw std::runtime_error("Неподдерживаемая версия снимка доски");
+    }
+    if (h.fileSize != size_) corrupted();
+
+    auto sectionFits = [this](std::uint64_t offset, std::uint64_t count, std::uint64_t width) {
+        return offset % 4 == 0 && offset >= sizeof(snapshot::Header) && offset <= size_
+               && count <= (size_ - offset) / width;
+    };
+    if (!sectionFits(h.developersOffset, h.developerCount, sizeof(snapshot::DeveloperRecord))
+        || !sectionFits(h.tasksOffset, h.taskCount, sizeof(snapshot::TaskRecord))
+        || !sectionFits(h.indexOffset, h.taskCount, sizeof(snapshot::IndexEntry))
+        || !sectionFits(h.stringsOffset, h.stringsSize, 1)) {
+        corrupted();
+    }
+
+    if (verify == Verify::Checksum) {
+        Checksum payload;
+        payload.update(data_ + sizeof(snapshot::Header), size_ - sizeof(snapshot::Header));
+        if (snapshotChecksum(payload, h) != h.checksum) {
+            corrupted();
+        }
+    }
+}
+
+const snapshot::DeveloperRecord* BoardSnapshot::developers() const noexcept
+{
+    return reinterpret_cast<const snapshot::DeveloperRecord*>(data_ + header().developersOffset);
+}
+
+const snapshot::TaskRecord* BoardSnapshot::tasks() const noexcept
+{
+    return reinterpret_cast<const snapshot::TaskRecord*>(data_ + header().tasksOffset);
+}
+
+const snapshot::IndexEntry* BoardSnapshot::index() const noexcept
+{
+    return reinterpret_cast<const snapshot::IndexEntry*>(data_ + header().indexOffset);
+}
+
+std::string_view BoardSnapshot::stringAt(std::uint32_t offset, std::uint32_t length) const
+{
+    if ((std::uint64_t)offset + length > header().stringsSize) corrupted();
+    return std::string_view(data_ + header().stringsOffset + offset, length);
+}
+
+int BoardSnapshot::developerId(std::size_t index) const
+{
+    if (index >= developerCount()) {
+        throw std::out_of_range("Разработчик не найден");
+    }
+    return developers()[index].id;
+}
+
+std::string_view BoardSnapshot::developerName(std::size_t index) const
+{
+    if (index >= developerCount()) {
+        throw std::out_of_range("Разработчик не найден");
+    }
+    const snapshot::DeveloperRecord& rec = developers()[index];
+    return stringAt(rec.nameOffset, rec.nameLength);
+}
+
+TaskView BoardSnapshot::task(std::size_t index) const
+{
+    if (index >= taskCount()) {
+        throw std::out_of_range("Задача не найдена");
+    }
+    const snapshot::TaskRecord& rec = tasks()[index];
+    if (rec.status >= kTaskStatusCount) corrupted();
+    return TaskView(rec.id,
+                    stringAt(rec.titleOffset, rec.titleLength),
+                    stringAt(rec.descriptionOffset, rec.descriptionLength),
+                    (TaskStatus)rec.status,
+                    rec.assignee != snapshot::kNoDeveloper ? std::optional<int>(rec.assignee)
+                                                            : std::nullopt);
+}
+
+std::optional<TaskView> BoardSnapshot::findTask(int taskId) const
+{
+    const snapshot::IndexEntry* first = index();
+    const snapshot::IndexEntry* last = first + taskCount();
+    const snapshot::IndexEntry* it = std::lower_bound(
+        first, last, taskId,
+        [](const snapshot::IndexEntry& e, int id) { return e.id < id; });
+    if (it == last || it->id != taskId) return std::nullopt;
+    return task(it->record);
+}
+
+ScrumBoard BoardSnapshot::toBoard() const
+{
+    KANBAN_TRACE_SCOPE_ARG("BoardSnapshot::toBoard", "tasks", taskCount());
+    ScrumBoard board;
+
+    for (std::size_t i = 0; i < developerCount(); ++i) {
+        board.addDeveloper(Developer(developerId(i), std::string(developerName(i))));
+    }
+
+    for (std::size_t i = 0; i < taskCount(); ++i) {
+        TaskView task = this->task(i);
+        // Файл цел (сумма сошлась), но доска в нём несогласована.
+        if (task.assignedDeveloper() && !board.findDeveloper(*task.assignedDeveloper())) {
+            throw std::runtime_error("Задача " + std::to_string(task.id()) +
+                                     " назначена несуществующему разработчику " +
+                                     std::to_string(*task.assignedDeveloper()));
+        }
+        Task::validateStatusTransition(task.status(), task.assignedDeveloper().has_value());
+        board.addTask(task);
+    }
+
+    board.setNextDeveloperId(nextDeveloperId());
+    board.setNextTaskId(nextTaskId());
+    return board;
+}
+
+ScrumBoard loadBoardSnapshot(const std::string& filename)
+{
+    return BoardSnapshot::open(filename).toBoard();
+}
+
+void convertJsonToSnapshot(const std::string& jsonFilename, const std::string& snapshotFilename)
+{
+    saveBoardSnapshot(loadBoardFromFile(jsonFilename), snapshotFilename);
+}
+
+void convertSnapshotToJson(const std::string& snapshotFilename, const std::string& jsonFilename)
+{
+    saveBoardToFile(loadBoardSnapshot(snapshotFilename), jsonFilename);
+}
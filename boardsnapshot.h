@@ -0,0 +1,124 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <string>
+#include <string_view>
+#include "scrumboard.h"
+
+// Двоичный снимок доски. Файл состоит из заголовка (версия, контрольная сумма,
+// смещения секций), записей разработчиков и задач фиксированной ширины,
+// отсортированного индекса ID и общей таблицы строк. Все числа — в порядке
+// байтов машины, записавшей файл; чужой порядок распознаётся по заголовку.
+namespace snapshot {
+
+constexpr std::uint32_t kVersion = 3;
+constexpr std::uint32_t kByteOrderMark = 0x01020304;
+constexpr std::int32_t kNoDeveloper = INT32_MIN;
+
+struct Header {
+    char magic[8];
+    std::uint32_t version;
+    std::uint32_t byteOrder;
+    std::uint64_t fileSize;
+    std::uint64_t checksum;         // по байтам после заголовка и заголовку с нулём в этом поле
+    std::uint32_t developerCount;
+    std::uint32_t taskCount;
+    std::int32_t nextDeveloperId;
+    std::int32_t nextTaskId;
+    std::uint64_t developersOffset;
+    std::uint64_t tasksOffset;
+    std::uint64_t indexOffset;
+    std::uint64_t stringsOffset;
+    std::uint64_t stringsSize;
+    std::uint64_t journalSequence;  // последняя запись журнала, вошедшая в снимок
+};
+
+struct DeveloperRecord {
+    std::int32_t id;
+    std::uint32_t nameOffset;       // смещения — внутри таблицы строк
+    std::uint32_t nameLength;
+};
+
+struct TaskRecord {
+    std::int32_t id;
+    std::int32_t assignee;          // kNoDeveloper, если не назначена
+    std::uint32_t titleOffset;
+    std::uint32_t titleLength;
+    std::uint32_t descriptionOffset;
+    std::uint32_t descriptionLength;
+    std::uint8_t status;
+    std::uint8_t reserved[3];
+};
+
+struct IndexEntry {
+    std::int32_t id;
+    std::uint32_t record;
+};
+
+std::uint64_t checksum(const void* data, std::size_t size);
+
+}
+
+// Снимок, отображённый в память: строки отдаются как string_view прямо
+// из файла, без разбора и копирования. Представления действительны,
+// пока жив объект BoardSnapshot.
+class BoardSnapshot {
+public:
+    enum class Verify {
+        Checksum,   // проверить контрольную сумму всего файла
+        HeaderOnly  // только заголовок и границы секций
+    };
+
+    static BoardSnapshot open(const std::string& filename, Verify verify = Verify::Checksum);
+
+    BoardSnapshot(BoardSnapshot&& other) noexcept;
+    BoardSnapshot& operator=(BoardSnapshot&& other) noexcept;
+    BoardSnapshot(const BoardSnapshot&) = delete;
+    BoardSnapshot& operator=(const BoardSnapshot&) = delete;
+    ~BoardSnapshot();
+
+    std::size_t developerCount() const noexcept { return header().developerCount; }
+    std::size_t taskCount() const noexcept { return header().taskCount; }
+    int nextDeveloperId() const noexcept { return header().nextDeveloperId; }
+    int nextTaskId() const noexcept { return header().nextTaskId; }
+    std::uint64_t journalSequence() const noexcept { return header().journalSequence; }
+    std::size_t fileSize() const noexcept { return size_; }
+
+    int developerId(std::size_t index) const;
+    std::string_view developerName(std::size_t index) const;
+
+    // Задачи в порядке записи в файл.
+    TaskView task(std::size_t index) const;
+    std::optional<TaskView> findTask(int taskId) const;
+
+    // Полная загрузка в доску с проверкой ссылок на разработчиков и статусов.
+    ScrumBoard toBoard() const;
+
+private:
+    BoardSnapshot() = default;
+
+    const snapshot::Header& header() const noexcept {
+        return *reinterpret_cast<const snapshot::Header*>(data_);
+    }
+    const snapshot::DeveloperRecord* developers() const noexcept;
+    const snapshot::TaskRecord* tasks() const noexcept;
+    const snapshot::IndexEntry* index() const noexcept;
+    std::string_view stringAt(std::uint32_t offset, std::uint32_t length) const;
+    void validate(Verify verify) const;
+    void unmap() noexcept;
+
+    const char* data_ = nullptr;
+    std::size_t size_ = 0;
+#ifdef _WIN32
+    void* file_ = nullptr;
+    void* mapping_ = nullptr;
+#endif
+};
+
+void saveBoardSnapshot(const ScrumBoard& board, const std::string& filename,
+                       std::uint64_t journalSequence = 0);
+ScrumBoard loadBoardSnapshot(const std::string& filename);
+
+void convertJsonToSnapshot(const std::string& jsonFilename, const std::string& snapshotFilename);
+void convertSnapshotToJson(const std::string& snapshotFilename, const std::string& jsonFilename);
@@ -0,0 +1,294 @@
+#include "boardworkspace.h"
+#include "metrics.h"
+#include "tracing.h"
+#include <algorithm>
+#include <filesystem>
+#include <stdexcept>
+
+namespace fs = std::filesystem;
+
+namespace {
+
+metrics::Counter& evictions()
+{
+    static metrics::Counter& counter = metrics::counter("workspace.evictions");
+    return counter;
+}
+
+}
+
+BoardWorkspace::BoardWorkspace(ScrumBoard& active, std::string directory, std::size_t memoryBudget)
+    : active_(active), directory_(std::move(directory)), memoryBudget_(memoryBudget)
+{
+    KANBAN_TRACE_SCOPE("BoardWorkspace::scan");
+    fs::create_directories(directory_);
+    for (const fs::directory_entry& file : fs::directory_iterator(directory_)) {
+        if (!file.is_regular_file() || file.path().extension() != kExtension) continue;
+        entries_.push_back(makeEntry(file.path().string()));
+    }
+    std::sort(entries_.begin(), entries_.end(),
+              [](const Entry& a, const Entry& b) { return a.info.name < b.info.name; });
+    updateGauges();
+}
+
+BoardWorkspace::~BoardWorkspace()
+{
+    load_.reset();
+    if (journal_) {
+        try {
+            journal_->compact();
+            journal_->waitForCompaction();
+        } catch (const std::exception&) {
+            // Все изменения уже в журнале, снимок будет записан в следующий раз.
+        }
+        journal_.reset();
+    }
+    for (Entry& entry : entries_) {
+        waitForWrite(entry);
+        if (!entry.cached || entry.sequence == entry.savedSequence) continue;
+        try {
+            BoardJournal::writeSnapshot(*entry.cached, entry.info.path, entry.sequence);
+        } catch (const std::exception&) {
+            // То же: журнал доски полон.
+        }
+    }
+}
+
+const BoardWorkspace::BoardInfo& BoardWorkspace::boardInfo(std::size_t index) const
+{
+    return entries_.at(index).info;
+}
+
+std::optional<std::size_t> BoardWorkspace::findBoard(const std::string& name) const
+{
+    for (std::size_t i = 0; i < entries_.size(); ++i) {
+        if (entries_[i].info.name == name) return i;
+    }
+    return std::nullopt;
+}
+
+bool BoardWorkspace::isLoaded(std::size_t index) const
+{
+    if (activeIndex_ == index && !load_) return true;
+    return entries_.at(index).cached.has_value();
+}
+
+std::size_t BoardWorkspace::createBoard(const std::string& name)
+{
+    if (name.empty() || name.find_first_of("/\\:") != std::string::npos || name == "." || name == "..") {
+        throw std::invalid_argument("Недопустимое имя доски: " + name);
+    }
+    if (findBoard(name)) {
+        throw std::invalid_argument("Доска " + name + " уже есть");
+    }
+    std::string path = (fs::path(directory_) / (name + kExtension)).string();
+    saveBoardSnapshot(ScrumBoard(), path);
+    entries_.push_back(makeEntry(path));
+    updateGauges();
+    return entries_.size() - 1;
+}
+
+bool BoardWorkspace::activate(std::size_t index)
+{
+    KANBAN_TRACE_SCOPE("BoardWorkspace::activate");
+    static metrics::Histogram& duration = metrics::histogram("workspace.activate");
+    metrics::Timer timer(duration);
+    if (index >= entries_.size()) {
+        throw std::out_of_range("Нет доски с номером " + std::to_string(index));
+    }
+    if (activeIndex_ == index && !load_) return true;
+
+    deactivate();
+    Entry& entry = entries_[index];
+    entry.lastUsed = ++clock_;
+
+    if (entry.cached) {
+        active_.replaceWith(std::move(*entry.cached));
+        entry.cached.reset();
+        journal_ = std::make_unique<BoardJournal>(active_, entry.info.path, entry.sequence);
+        activeIndex_ = index;
+        trim();
+        return true;
+    }
+
+    // Снимок после вытеснения мог ещё записываться.
+    waitForWrite(entry);
+    std::optional<BoardSnapshot> opened;
+    try {
+        opened.emplace(BoardSnapshot::open(entry.info.path));
+    } catch (...) {
+        // Прежняя доска уже в кеше; без журнала active не должна хранить её правки.
+        active_.replaceWith(ScrumBoard());
+        throw;
+    }
+    BoardSnapshot& snapshot = *opened;
+    entry.info.fileBytes = snapshot.fileSize();
+    entry.info.tasks = snapshot.taskCount();
+    entry.info.developers = snapshot.developerCount();
+
+    // Разработчики и счётчики ID — сразу, задачи — порциями в loadStep().
+    ScrumBoard board = ScrumBoard::withArena((std::size_t)entry.info.fileBytes);
+    for (std::size_t i = 0; i < snapshot.developerCount(); ++i) {
+        board.addDeveloper(Developer(snapshot.developerId(i), snapshot.developerName(i)));
+    }
+    board.reserveTasks(snapshot.taskCount());
+    board.setNextDeveloperId(snapshot.nextDeveloperId());
+    board.setNextTaskId(snapshot.nextTaskId());
+    active_.replaceWith(std::move(board));
+
+    load_.emplace(PendingLoad{index, std::move(snapshot), 0});
+    activeIndex_ = index;
+    return false;
+}
+
+bool BoardWorkspace::loadStep(std::size_t maxTasks)
+{
+    if (!load_) return true;
+    KANBAN_TRACE_SCOPE("BoardWorkspace::loadStep");
+
+    const BoardSnapshot& snapshot = load_->snapshot;
+    std::size_t begin = load_->tasksApplied;
+    std::size_t end = begin + std::min(maxTasks, snapshot.taskCount() - begin);
+    try {
+        std::vector<TaskView> tasks;
+        tasks.reserve(end - begin);
+        for (std::size_t i = begin; i < end; ++i) tasks.push_back(snapshot.task(i));
+        active_.addTasks(tasks);
+        load_->tasksApplied = end;
+        if (end < snapshot.taskCount()) return false;
+
+        Entry& entry = entries_[load_->index];
+        entry.savedSequence = snapshot.journalSequence();
+        load_.reset();
+        journal_ = std::make_unique<BoardJournal>(active_, entry.info.path, entry.savedSequence);
+    } catch (...) {
+        cancelLoad();
+        throw;
+    }
+    trim();
+    return true;
+}
+
+BoardWorkspace::LoadProgress BoardWorkspace::loadProgress() const noexcept
+{
+    if (!load_) return {};
+    return {load_->tasksApplied, load_->snapshot.taskCount()};
+}
+
+void BoardWorkspace::cancelLoad()
+{
+    if (!load_) return;
+    load_.reset();
+    journal_.reset();
+    activeIndex_.reset();
+    active_.replaceWith(ScrumBoard());
+}
+
+void BoardWorkspace::setMemoryBudget(std::size_t bytes)
+{
+    memoryBudget_ = bytes;
+    trim();
+}
+
+std::size_t BoardWorkspace::memoryUsage() const noexcept
+{
+    std::size_t bytes = activeIndex_ ? active_.arenaBytes() : 0;
+    for (const Entry& entry : entries_) {
+        if (entry.cached) bytes += entry.cached->arenaBytes();
+    }
+    return bytes;
+}
+
+void BoardWorkspace::trim()
+{
+    while (memoryUsage() > memoryBudget_) {
+        std::optional<std::size_t> oldest;
+        for (std::size_t i = 0; i < entries_.size(); ++i) {
+            if (!entries_[i].cached) continue;
+            if (!oldest || entries_[i].lastUsed < entries_[*oldest].lastUsed) oldest = i;
+        }
+        if (!oldest) break;
+        evict(*oldest);
+    }
+    updateGauges();
+}
+
+BoardWorkspace::Entry BoardWorkspace::makeEntry(const std::string& path) const
+{
+    Entry entry;
+    entry.info.name = fs::path(path).stem().string();
+    entry.info.path = path;
+    std::error_code ec;
+    std::uintmax_t size = fs::file_size(path, ec);
+    entry.info.fileBytes = ec ? 0 : size;
+    // Испорченный снимок остаётся в списке: ошибка покажется при открытии.
+    try {
+        BoardSnapshot snapshot = BoardSnapshot::open(path, BoardSnapshot::Verify::HeaderOnly);
+        entry.info.tasks = snapshot.taskCount();
+        entry.info.developers = snapshot.developerCount();
+    } catch (const std::exception&) {
+    }
+    return entry;
+}
+
+// Недогруженная доска бросается: её состояние целиком есть в снимке.
+void BoardWorkspace::deactivate()
+{
+    if (load_) {
+        cancelLoad();
+        return;
+    }
+    if (!activeIndex_) return;
+
+    Entry& entry = entries_[*activeIndex_];
+    entry.sequence = journal_->sequence();
+    journal_.reset();
+    entry.cached = active_;
+    updateCounts(entry, active_);
+    activeIndex_.reset();
+}
+
+// Снимок пишется по копии в фоне, арена освобождается вместе с копией.
+void BoardWorkspace::evict(std::size_t index)
+{
+    KANBAN_TRACE_SCOPE("BoardWorkspace::evict");
+    Entry& entry = entries_[index];
+    ScrumBoard state = std::move(*entry.cached);
+    entry.cached.reset();
+    evictions().add();
+    if (entry.sequence == entry.savedSequence) return;
+
+    waitForWrite(entry);
+    entry.write = std::async(std::launch::async,
+                             [path = entry.info.path, sequence = entry.sequence, state = std::move(state)]() {
+                                 BoardJournal::writeSnapshot(state, path, sequence);
+                             });
+    entry.savedSequence = entry.sequence;
+}
+
+void BoardWorkspace::updateGauges() const
+{
+    static metrics::Gauge& bytes = metrics::gauge("workspace.bytes", metrics::Unit::Bytes);
+    static metrics::Gauge& loaded = metrics::gauge("workspace.loaded_boards");
+    std::int64_t count = activeIndex_ ? 1 : 0;
+    for (const Entry& entry : entries_) count += entry.cached ? 1 : 0;
+    bytes.set((std::int64_t)memoryUsage());
+    loaded.set(count);
+}
+
+// Ошибка записи не теряет данных: сегменты журнала удаляются только после
+// успешной записи снимка, и следующая загрузка их проиграет.
+void BoardWorkspace::waitForWrite(Entry& entry)
+{
+    if (!entry.write.valid()) return;
+    try {
+        entry.write.get();
+    } catch (const std::exception&) {
+    }
+}
+
+void BoardWorkspace::updateCounts(Entry& entry, const ScrumBoard& board)
+{
+    entry.info.tasks = board.getAllTasks().size();
+    entry.info.developers = board.getAllDevelopers().size();
+}
@@ -0,0 +1,130 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <future>
+#include <memory>
+#include <optional>
+#include <string>
+#include <vector>
+#include "boardjournal.h"
+#include "boardsnapshot.h"
+#include "scrumboard.h"
+
+// Рабочее пространство из многих досок: каждая доска — двоичный снимок
+// <имя>.kbsnap со своим журналом в одном каталоге. При открытии читаются
+// только заголовки снимков (имя, число задач и разработчиков); сами задачи
+// загружаются, когда доска становится активной.
+//
+// Активная доска одна и живёт в объекте active, к которому привязан
+// интерфейс; журнал пишет её изменения. Доска, с которой ушли, остаётся
+// в памяти копией (O(1)), и возврат к ней мгновенный. Когда память
+// неактивных и активной досок превышает бюджет, самые давно открытые
+// неактивные доски вытесняются: изменённые записываются снимком в фоне,
+// после чего их арены освобождаются. Доска, которой нет в памяти,
+// загружается из снимка порциями через loadStep().
+//
+// Память доски считается по её арене (ScrumBoard::arenaBytes), поэтому
+// доски рабочего пространства всегда загружаются в собственные арены.
+// Копии вне рабочего пространства (история отмены, фоновое сохранение)
+// держат арену вытесненной доски, пока живут сами.
+// Все методы вызываются из одного потока — потока-владельца active.
+class BoardWorkspace {
+public:
+    static constexpr const char* kExtension = ".kbsnap";
+    static constexpr std::size_t kDefaultMemoryBudget = 512 * 1024 * 1024;
+
+    struct BoardInfo {
+        std::string name;           // имя файла без расширения
+        std::string path;
+        // По заголовку снимка, пока доска не загружена; записи журнала
+        // после снимка учитываются только после загрузки.
+        std::size_t tasks = 0;
+        std::size_t developers = 0;
+        std::uint64_t fileBytes = 0;
+    };
+
+    struct LoadProgress {
+        std::size_t tasksApplied = 0;
+        std::size_t totalTasks = 0;
+    };
+
+    // Читает заголовки всех снимков каталога; каталог создаётся, если его нет.
+    // Активной доски ещё нет, active не меняется.
+    BoardWorkspace(ScrumBoard& active, std::string directory,
+                   std::size_t memoryBudget = kDefaultMemoryBudget);
+    // Сжимает журнал активной доски в снимок и записывает изменённые
+    // доски из кеша, чтобы следующее открытие обошлось без журнала.
+    ~BoardWorkspace();
+
+    BoardWorkspace(const BoardWorkspace&) = delete;
+    BoardWorkspace& operator=(const BoardWorkspace&) = delete;
+
+    std::size_t boardCount() const noexcept { return entries_.size(); }
+    const BoardInfo& boardInfo(std::size_t index) const;
+    std::optional<std::size_t> findBoard(const std::string& name) const;
+    // Доска в памяти: активная или в кеше.
+    bool isLoaded(std::size_t index) const;
+
+    // Создаёт пустую доску и сразу записывает её снимок; новая доска
+    // добавляется в конец списка.
+    std::size_t createBoard(const std::string& name);
+
+    // Делает доску активной. true — доска была в памяти и уже в active;
+    // false — началась постепенная загрузка: active пуста, задачи добавляются
+    // вызовами loadStep(). Прежняя активная доска уходит в кеш.
+    bool activate(std::size_t index);
+    std::optional<std::size_t> activeIndex() const noexcept { return activeIndex_; }
+
+    // Добавляет в active не больше maxTasks задач загружаемой доски.
+    // Возвращает true, когда загрузка закончена и к доске подключён журнал.
+    // При ошибке загрузка прерывается, как cancelLoad(), и исключение
+    // выбрасывается дальше.
+    bool loadStep(std::size_t maxTasks = SIZE_MAX);
+    bool loading() const noexcept { return load_.has_value(); }
+    LoadProgress loadProgress() const noexcept;
+    // Бросает недогруженную доску; активной доски не остаётся.
+    void cancelLoad();
+
+    // Журнал активной доски; nullptr во время загрузки и без активной доски.
+    BoardJournal* journal() noexcept { return journal_.get(); }
+
+    void setMemoryBudget(std::size_t bytes);
+    std::size_t memoryBudget() const noexcept { return memoryBudget_; }
+    // Арены активной доски и досок в кеше.
+    std::size_t memoryUsage() const noexcept;
+    // Вытесняет доски из кеша, пока память превышает бюджет. Активная
+    // доска не вытесняется, даже если одна не помещается в бюджет.
+    void trim();
+
+private:
+    struct Entry {
+        BoardInfo info;
+        std::optional<ScrumBoard> cached;
+        std::uint64_t sequence = 0;         // последняя запись журнала в cached
+        std::uint64_t savedSequence = 0;    // последняя запись, вошедшая в снимок
+        std::uint64_t lastUsed = 0;
+        std::future<void> write;            // фоновая запись снимка после вытеснения
+    };
+
+    struct PendingLoad {
+        std::size_t index;
+        BoardSnapshot snapshot;
+        std::size_t tasksApplied = 0;
+    };
+
+    Entry makeEntry(const std::string& path) const;
+    void deactivate();
+    void evict(std::size_t index);
+    void updateGauges() const;
+    static void waitForWrite(Entry& entry);
+    static void updateCounts(Entry& entry, const ScrumBoard& board);
+
+    ScrumBoard& active_;
+    std::string directory_;
+    std::size_t memoryBudget_;
+    std::vector<Entry> entries_;
+    std::optional<std::size_t> activeIndex_;
+    std::unique_ptr<BoardJournal> journal_;
+    std::optional<PendingLoad> load_;
+    std::uint64_t clock_ = 0;
+};
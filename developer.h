@@ -1,21 +1,37 @@
 #pragma once
+#include <memory_resource>
 #include <string>
+#include <string_view>
 #include <stdexcept>
 
+// Имя хранится в ресурсе памяти разработчика: в таблице доски это ресурс
+// доски (uses-allocator), отдельно созданный разработчик — ресурс по умолчанию.
 class Developer {
 public:
-    Developer(int id, const std::string& name) {
-        if (name.empty()) {
+    using allocator_type = std::pmr::polymorphic_allocator<char>;
+
+    Developer(int id, std::string_view name, const allocator_type& allocator = {})
+        : id_(id), name_(name, allocator) {
+        if (name_.empty()) {
             throw std::invalid_argument("Имя разработчика не может быть пустым");
         }
-        id_ = id;
-        name_ = name;
     }
 
+    Developer(const Developer& other, const allocator_type& allocator)
+        : id_(other.id_), name_(other.name_, allocator) {}
+    Developer(Developer&& other, const allocator_type& allocator)
+        : id_(other.id_), name_(std::move(other.name_), allocator) {}
+
+    Developer(const Developer&) = default;
+    Developer(Developer&&) = default;
+    Developer& operator=(const Developer&) = default;
+    Developer& operator=(Developer&&) = default;
+
     int id() const { return id_; }
-    const std::string& name() const { return name_; }
+    const std::pmr::string& name() const { return name_; }
+    allocator_type get_allocator() const { return name_.get_allocator(); }
 
 private:
     int id_;
-    std::string name_;
+    std::pmr::string name_;
 };
@@ -27,14 +27,14 @@ DeveloperWindow::~DeveloperWindow() {
 void DeveloperWindow::refreshDeveloperTable() {
     ui->tableDevelopers->setRowCount(0);
 
-    for (const auto& [id, dev] : board.getAllDevelopers()) {
+    for (const Developer& dev : board.getAllDevelopers()) {
         int row = ui->tableDevelopers->rowCount();
         ui->tableDevelopers->insertRow(row);
 
         auto* item = new QTableWidgetItem(
-            QString::fromStdString(dev.name()));
+            QString::fromUtf8(dev.name().data(), (qsizetype)dev.name().size()));
 
-        item->setData(Qt::UserRole, id);
+        item->setData(Qt::UserRole, dev.id());
 
         ui->tableDevelopers->setItem(row, 0, item);
     }
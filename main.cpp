@@ -1,11 +1,33 @@
 #include "mainwindow.h"
+#include "tracing.h"
 
 #include <QApplication>
 
+#include <cstdlib>
+#include <iostream>
+
 int main(int argc, char *argv[])
 {
-    QApplication a(argc, argv);
-    MainWindow w;
-    w.show();
-    return a.exec();
+    // KANBAN_TRACE=trace.json записывает трассу сеанса; файл пишется при выходе.
+    const char* traceFile = std::getenv("KANBAN_TRACE");
+    tracing::setThreadName("Интерфейс");
+    if (traceFile && *traceFile) tracing::start();
+
+    int result;
+    {
+        QApplication a(argc, argv);
+        MainWindow w;
+        w.show();
+        result = a.exec();
+    }
+
+    if (traceFile && *traceFile) {
+        tracing::stop();
+        try {
+            tracing::saveChromeTrace(traceFile);
+        } catch (const std::exception& e) {
+            std::cerr << "Трасса не записана: " << e.what() << "\n";
+        }
+    }
+    return result;
 }
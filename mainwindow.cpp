@@ -2,87 +2,50 @@
 #include "ui_mainwindow.h"
 #include "developerwindow.h"
 #include "boardserializer.h"
+#include "metrics.h"
 #include "taskutils.h"
-#include "taskitemformat.h"
+#include "tracing.h"
 
+#include <QAction>
+#include <QFileInfo>
+#include <QHBoxLayout>
 #include <QInputDialog>
+#include <QLineEdit>
 #include <QMessageBox>
-#include <QListWidgetItem>
-#include <QEvent>
-#include <QDropEvent>
-#include <QTimer>
-
-static QString developerNameById(const ScrumBoard& board, int devId)
+#include <QProgressBar>
+#include <QPushButton>
+#include <QSignalBlocker>
+#include <QStatusBar>
+#include <QTabBar>
+#include <QToolButton>
+
+#include <cstdlib>
+
+namespace {
+// Доски — снимки *.kbsnap в текущем каталоге; прежний единственный
+// board.kbsnap открывается доской «board».
+const char* const WorkspaceDir = ".";
+const char* const DefaultBoard = "board";
+const char* const MetricsFile = "kanban.metrics.json";
+const int AutosaveIntervalMs = 60 * 1000;
+// Порция загрузки за один тик таймера: интерфейс остаётся отзывчивым.
+const int LoadTickMs = 15;
+const std::size_t LoadTasksPerTick = 20000;
+const int LoadProgressSteps = 1000;
+// Пауза перед повторным поиском: пакет изменений даёт один пересчёт.
+const int SearchRefreshMs = 200;
+
+// KANBAN_MEMORY_BUDGET_MB задаёт бюджет памяти досок в мегабайтах.
+std::size_t workspaceMemoryBudget()
 {
-    auto devs = board.getAllDevelopers();
-    for (auto it = devs.begin(); it != devs.end(); ++it) {
-        if (it->first == devId) return QString::fromStdString(it->second.name());
+    const char* value = std::getenv("KANBAN_MEMORY_BUDGET_MB");
+    if (value && *value) {
+        char* end = nullptr;
+        unsigned long long megabytes = std::strtoull(value, &end, 10);
+        if (*end == '\0') return (std::size_t)megabytes * 1024 * 1024;
     }
-    return QString("ID %1").arg(devId);
-}
-
-static int extractTaskId(const QString& text)
-{
-    int l = text.indexOf('[');
-    int r = text.indexOf(']');
-    if (l == -1 || r == -1) return -1;
-    if (r <= l + 1) return -1;
-
-    bool ok = false;
-    int id = text.mid(l + 1, r - l - 1).toInt(&ok);
-    if (!ok) return -1;
-    return id;
+    return BoardWorkspace::kDefaultMemoryBudget;
 }
-
-QListWidget* MainWindow::listForViewport(QObject* viewport) const
-{
-    if (!ui) return 0;
-    if (ui->listAssigned && viewport == ui->listAssigned->viewport()) return ui->listAssigned;
-    if (ui->listInProgress && viewport == ui->listInProgress->viewport()) return ui->listInProgress;
-    if (ui->listDone && viewport == ui->listDone->viewport()) return ui->listDone;
-    return 0;
-}
-
-TaskStatus MainWindow::targetStatusForList(QListWidget* list) const
-{
-    if (list == ui->listAssigned) return TaskStatus::Backlog;
-    if (list == ui->listInProgress) return TaskStatus::InProgress;
-    return TaskStatus::Done;
-}
-
-bool MainWindow::eventFilter(QObject* obj, QEvent* event)
-{
-    if (event->type() != QEvent::Drop)
-        return QMainWindow::eventFilter(obj, event);
-
-    QListWidget* targetList = listForViewport(obj);
-    if (!targetList)
-        return QMainWindow::eventFilter(obj, event);
-
-    QDropEvent* dropEvent = (QDropEvent*)event;
-    QPoint dropPos = dropEvent->position().toPoint();
-
-    QTimer::singleShot(0, this, [this, targetList, dropPos]() {
-        QListWidgetItem* item = targetList->itemAt(dropPos);
-        if (!item) item = targetList->currentItem();
-        if (!item && targetList->count() > 0) item = targetList->item(targetList->count() - 1);
-        if (!item) return;
-
-        int taskId = extractTaskId(item->text());
-        if (taskId < 0) return;
-
-        TaskStatus newStatus = targetStatusForList(targetList);
-
-        try {
-            board.changeTaskStatus(taskId, newStatus);
-        } catch (const std::exception& e) {
-            QMessageBox::warning(this, "Нельзя переместить", e.what());
-        }
-
-        refreshBoardView();
-    });
-
-    return false;
 }
 
 MainWindow::MainWindow(QWidget* parent)
@@ -95,29 +58,269 @@ MainWindow::MainWindow(QWidget* parent)
     connect(ui->btnDeleteTask, &QPushButton::clicked, this, &MainWindow::onDeleteTask);
     connect(ui->btnSaveBoard, &QPushButton::clicked, this, &MainWindow::onSaveBoard);
     connect(ui->btnLoadBoard, &QPushButton::clicked, this, &MainWindow::onLoadBoard);
+    connect(ui->btnUndo, &QPushButton::clicked, this, &MainWindow::onUndo);
+    connect(ui->btnRedo, &QPushButton::clicked, this, &MainWindow::onRedo);
+
+    m_developerNames = std::make_unique<TaskItemFormat::DeveloperNameCache>(board);
+
+    m_assignedModel = std::make_unique<BoardColumnModel>(
+        board, *m_developerNames, std::vector<TaskStatus>{ TaskStatus::Backlog, TaskStatus::Assigned });
+    m_inProgressModel = std::make_unique<BoardColumnModel>(
+        board, *m_developerNames, std::vector<TaskStatus>{ TaskStatus::InProgress, TaskStatus::Blocked });
+    m_doneModel = std::make_unique<BoardColumnModel>(
+        board, *m_developerNames, std::vector<TaskStatus>{ TaskStatus::Done });
+
+    ui->listAssigned->setModel(m_assignedModel.get());
+    ui->listInProgress->setModel(m_inProgressModel.get());
+    ui->listDone->setModel(m_doneModel.get());
 
     m_listsController = std::make_unique<BoardListsController>(
         board,
         ui->listAssigned,
         ui->listInProgress,
         ui->listDone,
-        [this]() { refreshBoardView(); },
         this
         );
 
-    refreshBoardView();
+    m_boardTabs = new QTabBar(this);
+    m_boardTabs->setExpanding(false);
+    m_boardTabs->setDocumentMode(true);
+    m_newBoard = new QToolButton(this);
+    m_newBoard->setText("+");
+    m_newBoard->setToolTip("Новая доска");
+    QHBoxLayout* tabsLayout = new QHBoxLayout;
+    tabsLayout->addWidget(m_boardTabs, 1);
+    tabsLayout->addWidget(m_newBoard);
+    ui->mainLayout->insertLayout(1, tabsLayout);
+    connect(m_boardTabs, &QTabBar::currentChanged, this, &MainWindow::onBoardTabChanged);
+    connect(m_newBoard, &QToolButton::clicked, this, &MainWindow::onNewBoard);
+
+    // Заголовки снимков читаются сразу, задачи — при открытии доски.
+    try {
+        m_workspace = std::make_unique<BoardWorkspace>(board, WorkspaceDir, workspaceMemoryBudget());
+        if (m_workspace->boardCount() == 0) m_workspace->createBoard(DefaultBoard);
+    } catch (const std::exception& e) {
+        m_workspace.reset();
+        QMessageBox::critical(this, "Ошибка", QString("Доски не загружены: %1").arg(e.what()));
+    }
+
+    // История начинается с открытой доски и сбрасывается при переключении.
+    m_history = std::make_unique<BoardHistory>(board);
+
+    m_revisionSubscription = board.subscribe([this](const BoardChange&) {
+        ++m_revision;
+        updateBoardGauges();
+        updateUndoButtons();
+    });
+    updateUndoButtons();
+    m_autosavedRevision = m_revision;
+
+    connect(&m_autosaveTimer, &QTimer::timeout, this, &MainWindow::onAutosave);
+    m_autosaveTimer.start(AutosaveIntervalMs);
+
+    m_loadProgress = new QProgressBar(this);
+    m_loadProgress->setRange(0, LoadProgressSteps);
+    m_loadProgress->setMaximumWidth(200);
+    m_loadProgress->hide();
+    statusBar()->addPermanentWidget(m_loadProgress);
+
+    m_cancelLoad = new QPushButton("Отмена", this);
+    m_cancelLoad->hide();
+    statusBar()->addPermanentWidget(m_cancelLoad);
+    connect(m_cancelLoad, &QPushButton::clicked, this, &MainWindow::onCancelLoad);
+
+    m_loadTimer.setInterval(LoadTickMs);
+    connect(&m_loadTimer, &QTimer::timeout, this, &MainWindow::onLoadTick);
+
+    m_searchIndex = std::make_unique<TaskSearchIndex>(board);
+    m_searchTimer.setSingleShot(true);
+    m_searchTimer.setInterval(SearchRefreshMs);
+    connect(&m_searchTimer, &QTimer::timeout, this, &MainWindow::onSearch);
+    connect(ui->editSearch, &QLineEdit::textChanged, this, &MainWindow::onSearch);
+    m_searchSubscription = board.subscribe([this](const BoardChange&) {
+        if (m_searchActive && !m_searchTimer.isActive()) m_searchTimer.start();
+    });
+
+    m_metricsOverlay = new MetricsOverlay(this);
+    addDockWidget(Qt::RightDockWidgetArea, m_metricsOverlay);
+    m_metricsOverlay->hide();
+    QAction* toggleMetrics = m_metricsOverlay->toggleViewAction();
+    toggleMetrics->setShortcut(Qt::Key_F12);
+    addAction(toggleMetrics);
+    updateBoardGauges();
+
+    // Без рабочего пространства доска работает, но не сохраняется в журнал.
+    setEditingEnabled(!m_workspace);
+    if (m_workspace) {
+        updateBoardTabs();
+        openBoard((int)m_workspace->findBoard(DefaultBoard).value_or(0));
+    }
 }
 
 MainWindow::~MainWindow()
 {
+    m_autosaveTimer.stop();
+    m_loadTimer.stop();
+    m_searchTimer.stop();
+    board.unsubscribe(m_revisionSubscription);
+    board.unsubscribe(m_searchSubscription);
+    m_saver.wait();
+
+    // Недогруженная доска не сохраняется: возвращаем прежнюю.
+    bool loading = m_loader != nullptr;
+    if (loading) {
+        m_loader.reset();
+        board.replaceWith(std::move(m_boardBeforeLoad));
+    }
+
+    // Рабочее пространство сжимает журнал активной доски и записывает
+    // изменённые доски из памяти.
+    if (m_workspace) {
+        BoardJournal* journal = m_workspace->journal();
+        if (loading && journal) {
+            try {
+                journal->endBulkChange();
+            } catch (const std::exception&) {
+                // Все изменения уже в журнале, снимок будет записан при следующем запуске.
+            }
+        }
+        m_workspace.reset();
+    }
+
+    try {
+        metrics::saveJson(MetricsFile);
+    } catch (const std::exception&) {
+        // Сводка показателей не нужна для работы и при ошибке просто не пишется.
+    }
     delete ui;
 }
 
+int MainWindow::selectedTaskId() const
+{
+    QListView* lists[] = { ui->listAssigned, ui->listInProgress, ui->listDone };
+    for (QListView* list : lists) {
+        QModelIndex index = list ? list->currentIndex() : QModelIndex();
+        if (index.isValid()) return index.data(BoardColumnModel::TaskIdRole).toInt();
+    }
+    return -1;
+}
+
+QString MainWindow::activeBoardName() const
+{
+    if (!m_workspace || !m_workspace->activeIndex()) return DefaultBoard;
+    return QString::fromStdString(m_workspace->boardInfo(*m_workspace->activeIndex()).name);
+}
+
+void MainWindow::onBoardTabChanged(int index)
+{
+    if (index >= 0) openBoard(index);
+}
+
+void MainWindow::onNewBoard()
+{
+    if (!m_workspace) return;
+    bool ok = false;
+    QString name = QInputDialog::getText(this, "Новая доска", "Имя доски:", QLineEdit::Normal, "", &ok);
+    if (!ok) return;
+    if (name.trimmed().isEmpty()) {
+        QMessageBox::warning(this, "Ошибка ввода", "Имя доски не может быть пустым!");
+        return;
+    }
+
+    std::size_t index;
+    try {
+        index = m_workspace->createBoard(name.trimmed().toStdString());
+    } catch (const std::exception& e) {
+        QMessageBox::critical(this, "Ошибка", e.what());
+        return;
+    }
+    updateBoardTabs();
+    openBoard((int)index);
+}
+
+// Доска из памяти открывается сразу, остальные догружаются порциями
+// по таймеру загрузки, как файл JSON.
+void MainWindow::openBoard(int index)
+{
+    if (!m_workspace || m_loader || m_workspace->loading()) return;
+    if (m_workspace->activeIndex() == (std::size_t)index) return;
+    KANBAN_TRACE_SCOPE("MainWindow::openBoard");
+
+    if (m_workspace->activeIndex()) m_previousBoard = (int)*m_workspace->activeIndex();
+    bool ready = false;
+    try {
+        ready = m_workspace->activate((std::size_t)index);
+    } catch (const std::exception& e) {
+        finishBoardOpen(QString("Доска не открыта: %1").arg(e.what()));
+        return;
+    }
+    if (ready) {
+        finishBoardOpen();
+        return;
+    }
+
+    m_history->suspend();
+    setEditingEnabled(false);
+    m_loadProgress->setValue(0);
+    m_loadProgress->show();
+    m_cancelLoad->show();
+    statusBar()->showMessage(QString("Загрузка доски %1...").arg(activeBoardName()));
+    m_loadTimer.start();
+    onLoadTick();
+}
+
+void MainWindow::finishBoardOpen(const QString& error)
+{
+    m_loadTimer.stop();
+    m_loadProgress->hide();
+    m_cancelLoad->hide();
+
+    // Переключение и порции загрузки — не шаги пользователя и не повод
+    // для автосохранения.
+    m_history->resume();
+    m_autosavedRevision = m_revision;
+    bool opened = m_workspace->activeIndex().has_value();
+    setEditingEnabled(opened);
+    updateBoardTabs();
+
+    if (!error.isEmpty()) QMessageBox::critical(this, "Ошибка", error);
+    if (opened) {
+        statusBar()->showMessage(QString("Доска %1").arg(activeBoardName()), 5000);
+        return;
+    }
+    if (m_previousBoard >= 0 && (std::size_t)m_previousBoard < m_workspace->boardCount()) {
+        int previous = m_previousBoard;
+        m_previousBoard = -1;
+        openBoard(previous);
+    }
+}
+
+void MainWindow::updateBoardTabs()
+{
+    if (!m_workspace) return;
+    QSignalBlocker blocker(m_boardTabs);
+    while (m_boardTabs->count() < (int)m_workspace->boardCount()) m_boardTabs->addTab(QString());
+
+    std::optional<std::size_t> active = m_workspace->activeIndex();
+    for (std::size_t i = 0; i < m_workspace->boardCount(); ++i) {
+        const BoardWorkspace::BoardInfo& info = m_workspace->boardInfo(i);
+        bool current = active == i && !m_workspace->loading();
+        std::size_t tasks = current ? board.getAllTasks().size() : info.tasks;
+        std::size_t developers = current ? board.getAllDevelopers().size() : info.developers;
+        m_boardTabs->setTabText((int)i, QString::fromStdString(info.name));
+        m_boardTabs->setTabToolTip((int)i, QString("Задач: %1, разработчиков: %2\nСнимок: %3 МБ\n%4")
+                                               .arg(tasks)
+                                               .arg(developers)
+                                               .arg((double)info.fileBytes / (1024.0 * 1024.0), 0, 'f', 1)
+                                               .arg(m_workspace->isLoaded(i) ? "В памяти" : "Не загружена"));
+    }
+    if (active) m_boardTabs->setCurrentIndex((int)*active);
+}
+
 void MainWindow::onOpenDevelopers()
 {
     DeveloperWindow w(board, this);
     w.exec();
-    refreshBoardView();
 }
 
 void MainWindow::onAddTask()
@@ -140,10 +343,10 @@ void MainWindow::onAddTask()
         return;
     }
 
+    KANBAN_TRACE_SCOPE("MainWindow::addTask");
     try {
         int id = board.getNextTaskId();
         board.addTask(Task(id, title.toStdString(), desc.toStdString()));
-        refreshBoardView();
     } catch (const std::exception& e) {
         QMessageBox::critical(this, "Ошибка", e.what());
     }
@@ -151,20 +354,9 @@ void MainWindow::onAddTask()
 
 void MainWindow::onDeleteTask()
 {
-    QListWidgetItem* item = 0;
-
-    if (ui->listAssigned && ui->listAssigned->currentItem()) item = ui->listAssigned->currentItem();
-    if (!item && ui->listInProgress && ui->listInProgress->currentItem()) item = ui->listInProgress->currentItem();
-    if (!item && ui->listDone && ui->listDone->currentItem()) item = ui->listDone->currentItem();
-
-    if (!item) {
-        QMessageBox::information(this, "Удаление", "Выберите задачу в любой колонке.");
-        return;
-    }
-
-    int taskId = extractTaskId(item->text());
+    int taskId = selectedTaskId();
     if (taskId < 0) {
-        QMessageBox::warning(this, "Ошибка", "Не удалось определить ID задачи из строки.");
+        QMessageBox::information(this, "Удаление", "Выберите задачу в любой колонке.");
         return;
     }
 
@@ -177,9 +369,9 @@ void MainWindow::onDeleteTask()
 
     if (reply != QMessageBox::Yes) return;
 
+    KANBAN_TRACE_SCOPE("MainWindow::deleteTask");
     try {
         board.removeTask(taskId);
-        refreshBoardView();
     } catch (const std::exception& e) {
         QMessageBox::critical(this, "Ошибка", e.what());
     }
@@ -187,49 +379,230 @@ void MainWindow::onDeleteTask()
 
 void MainWindow::onSaveBoard()
 {
+    if (!startSave(activeBoardName() + ".json", true)) {
+        QMessageBox::information(this, "Сохранение", "Предыдущее сохранение ещё не завершено");
+    }
+}
+
+void MainWindow::onAutosave()
+{
+    if (m_loader || m_revision == m_autosavedRevision) return;
+    if (m_workspace && !m_workspace->journal()) return;
+    startSave(activeBoardName() + ".autosave.json", false);
+}
+
+// Доска копируется в рабочий поток мгновенно; результат возвращается
+// в поток интерфейса через очередь событий.
+bool MainWindow::startSave(const QString& filename, bool manual)
+{
+    KANBAN_TRACE_SCOPE("MainWindow::startSave");
+    quint64 revision = m_revision;
+    bool started = m_saver.save(board, filename.toStdString(),
+                                [this, filename, revision, manual](const std::string& error) {
+        QString message = QString::fromStdString(error);
+        QMetaObject::invokeMethod(this, [this, filename, revision, manual, message]() {
+            onSaveFinished(filename, revision, manual, message);
+        }, Qt::QueuedConnection);
+    });
+
+    if (started) statusBar()->showMessage(QString("Сохранение в %1...").arg(filename));
+    return started;
+}
+
+void MainWindow::onSaveFinished(const QString& filename, quint64 revision, bool manual, const QString& error)
+{
+    if (!error.isEmpty()) {
+        statusBar()->showMessage(QString("Ошибка сохранения в %1").arg(filename), 5000);
+        if (manual) QMessageBox::critical(this, "Ошибка", error);
+        return;
+    }
+
+    if (!manual) m_autosavedRevision = revision;
+    statusBar()->showMessage(QString("Доска сохранена в %1").arg(filename), 5000);
+    if (manual) QMessageBox::information(this, "Сохранено", QString("Доска сохранена в %1").arg(filename));
+}
+
+void MainWindow::onSearch()
+{
+    KANBAN_TRACE_SCOPE("MainWindow::onSearch");
+    static metrics::Histogram& duration = metrics::histogram("search.query");
+    metrics::Timer timer(duration);
+    m_searchTimer.stop();
+    std::optional<std::vector<int>> found = m_searchIndex->search(ui->editSearch->text().toStdString());
+    m_searchActive = found.has_value();
+    if (found) m_searchResults = std::move(*found);
+    else m_searchResults.clear();
+
+    const std::vector<int>* filter = m_searchActive ? &m_searchResults : nullptr;
+    m_assignedModel->setFilter(filter);
+    m_inProgressModel->setFilter(filter);
+    m_doneModel->setFilter(filter);
+
+    if (!m_searchActive) {
+        statusBar()->clearMessage();
+        return;
+    }
+    statusBar()->showMessage(QString("Найдено задач: %1 (индекс поиска: %2 МБ)")
+                                 .arg(m_searchResults.size())
+                                 .arg((double)m_searchIndex->memoryUsage() / (1024.0 * 1024.0), 0, 'f', 1));
+}
+
+void MainWindow::onUndo()
+{
+    if (isLoading()) return;
     try {
-        saveBoardToFile(board, "board.json");
-        QMessageBox::information(this, "Сохранено", "Доска сохранена в board.json");
-    } catch (std::exception& e) {
+        m_history->undo();
+    } catch (const std::exception& e) {
         QMessageBox::critical(this, "Ошибка", e.what());
     }
+    updateUndoButtons();
 }
 
-void MainWindow::onLoadBoard()
+void MainWindow::onRedo()
 {
+    if (isLoading()) return;
     try {
-        board = loadBoardFromFile("board.json");
-        QMessageBox::information(this, "Загружено", "Доска загружена из board.json");
-        refreshBoardView();
-    } catch (std::exception& e) {
+        m_history->redo();
+    } catch (const std::exception& e) {
         QMessageBox::critical(this, "Ошибка", e.what());
     }
+    updateUndoButtons();
 }
 
-void MainWindow::refreshBoardView()
+void MainWindow::updateUndoButtons()
 {
-    if (!ui->listAssigned || !ui->listInProgress || !ui->listDone) return;
+    bool editable = !isLoading();
+    ui->btnUndo->setEnabled(editable && m_history && m_history->canUndo());
+    ui->btnRedo->setEnabled(editable && m_history && m_history->canRedo());
+}
+
+void MainWindow::updateBoardGauges()
+{
+    static metrics::Gauge& tasks = metrics::gauge("board.tasks");
+    static metrics::Gauge& developers = metrics::gauge("board.developers");
+    tasks.set((std::int64_t)board.getAllTasks().size());
+    developers.set((std::int64_t)board.getAllDevelopers().size());
+}
 
-    ui->listAssigned->clear();
-    ui->listInProgress->clear();
-    ui->listDone->clear();
+void MainWindow::setEditingEnabled(bool enabled)
+{
+    ui->btnAddTask->setEnabled(enabled);
+    ui->btnDeleteTask->setEnabled(enabled);
+    ui->btnOpenDevelopers->setEnabled(enabled);
+    ui->btnSaveBoard->setEnabled(enabled);
+    ui->btnLoadBoard->setEnabled(enabled);
+    m_listsController->setEditingEnabled(enabled);
+    bool loading = isLoading();
+    m_boardTabs->setEnabled(!loading);
+    m_newBoard->setEnabled(!loading && m_workspace);
+    updateUndoButtons();
+}
+
+bool MainWindow::isLoading() const
+{
+    return m_loader || (m_workspace && m_workspace->loading());
+}
+
+// Доска заполняется по мере разбора файла: первые задачи видны сразу,
+// журнал на время загрузки отключается и в конце получает снимок.
+void MainWindow::onLoadBoard()
+{
+    if (m_loader || (m_workspace && !m_workspace->journal())) return;
+
+    m_loadFile = activeBoardName() + ".json";
+    m_boardBeforeLoad = board;
+    if (m_workspace) m_workspace->journal()->beginBulkChange();
+    // Загруженная доска живёт в своей арене: и загрузка, и замена доски
+    // следующей не ходят в кучу за каждой задачей.
+    board.replaceWith(ScrumBoard::withArena((std::size_t)QFileInfo(m_loadFile).size()));
+    m_loader = std::make_unique<BoardLoader>(m_loadFile.toStdString());
+
+    m_history->suspend();
+    setEditingEnabled(false);
+    m_loadProgress->setValue(0);
+    m_loadProgress->show();
+    m_cancelLoad->show();
+    statusBar()->showMessage(QString("Загрузка %1...").arg(m_loadFile));
+
+    m_loadTimer.start();
+    onLoadTick();
+}
 
-    auto tasks = board.getAllTasks();
-    for (auto it = tasks.begin(); it != tasks.end(); ++it) {
-        const Task& task = it->second;
+void MainWindow::onLoadTick()
+{
+    if (m_workspace && m_workspace->loading()) {
+        BoardWorkspace::LoadProgress progress = m_workspace->loadProgress();
+        if (progress.totalTasks > 0) {
+            m_loadProgress->setValue((int)(progress.tasksApplied * LoadProgressSteps / progress.totalTasks));
+        }
+        try {
+            if (m_workspace->loadStep(LoadTasksPerTick)) finishBoardOpen();
+        } catch (const std::exception& e) {
+            finishBoardOpen(QString("Доска не загружена: %1").arg(e.what()));
+        }
+        return;
+    }
+    if (!m_loader) return;
 
-        QString title = TaskItemFormat::makeTitleLine(board, task);
-        QString tip = TaskItemFormat::makeTooltip(task);
+    bool done = m_loader->applyPending(board, LoadTasksPerTick);
+    BoardLoader::Progress progress = m_loader->progress();
+    if (progress.totalBytes > 0) {
+        m_loadProgress->setValue((int)(progress.bytesRead * LoadProgressSteps / progress.totalBytes));
+    }
+    if (done) finishLoad();
+}
 
-        QListWidget* list = ui->listDone;
+void MainWindow::onCancelLoad()
+{
+    if (m_workspace && m_workspace->loading()) {
+        m_workspace->cancelLoad();
+        finishBoardOpen();
+        statusBar()->showMessage("Загрузка отменена", 5000);
+        return;
+    }
+    if (!m_loader) return;
+    m_loader->cancel();
+    onLoadTick();
+}
 
-        if (task.status() == TaskStatus::Backlog || task.status() == TaskStatus::Assigned)
-            list = ui->listAssigned;
-        else if (task.status() == TaskStatus::InProgress || task.status() == TaskStatus::Blocked)
-            list = ui->listInProgress;
+void MainWindow::finishLoad()
+{
+    KANBAN_TRACE_SCOPE("MainWindow::finishLoad");
+    m_loadTimer.stop();
+    std::unique_ptr<BoardLoader> loader = std::move(m_loader);
+    m_loadProgress->hide();
+    m_cancelLoad->hide();
+
+    BoardLoader::State state = loader->state();
+    if (state != BoardLoader::State::Finished) {
+        board.replaceWith(std::move(m_boardBeforeLoad));
+    }
+    m_boardBeforeLoad = ScrumBoard();
+    // Порции загрузки — не шаги пользователя: история начинается с загруженной доски.
+    m_history->resume();
+    setEditingEnabled(true);
 
-        QListWidgetItem* item = new QListWidgetItem(title);
-        item->setToolTip(tip);
-        list->addItem(item);
+    if (BoardJournal* journal = m_workspace ? m_workspace->journal() : nullptr) {
+        try {
+            journal->endBulkChange();
+        } catch (const std::exception& e) {
+            QMessageBox::critical(this, "Ошибка", QString("Снимок доски не записан: %1").arg(e.what()));
+        }
+    }
+    updateBoardTabs();
+
+    switch (state) {
+    case BoardLoader::State::Finished:
+        statusBar()->showMessage(QString("Доска загружена из %1").arg(m_loadFile), 5000);
+        QMessageBox::information(this, "Загружено", QString("Доска загружена из %1").arg(m_loadFile));
+        break;
+    case BoardLoader::State::Failed:
+        statusBar()->clearMessage();
+        QMessageBox::critical(this, "Ошибка", QString::fromStdString(loader->error()));
+        break;
+    case BoardLoader::State::Cancelled:
+    case BoardLoader::State::Running:
+        statusBar()->showMessage("Загрузка отменена", 5000);
+        break;
     }
 }
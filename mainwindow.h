@@ -2,12 +2,25 @@
 #define MAINWINDOW_H
 
 #include <QMainWindow>
-#include <QListWidget>
+#include <QTimer>
+#include <memory>
 #include "boardlistscontroller.h"
+#include "boardcolumnmodel.h"
+#include "boardhistory.h"
+#include "boardjournal.h"
+#include "boardloader.h"
+#include "boardsaver.h"
+#include "boardworkspace.h"
+#include "metricsoverlay.h"
 #include "scrumboard.h"
+#include "tasksearchindex.h"
 
 QT_BEGIN_NAMESPACE
 namespace Ui { class MainWindow; }
+class QProgressBar;
+class QPushButton;
+class QTabBar;
+class QToolButton;
 QT_END_NAMESPACE
 
 class MainWindow : public QMainWindow
@@ -18,25 +31,82 @@ public:
     explicit MainWindow(QWidget *parent = nullptr);
     ~MainWindow();
 
-protected:
-    bool eventFilter(QObject* obj, QEvent* event) override;
-
 private slots:
     void onOpenDevelopers();
     void onAddTask();
     void onDeleteTask();
     void onSaveBoard();
     void onLoadBoard();
+    void onAutosave();
+    void onLoadTick();
+    void onCancelLoad();
+    void onSearch();
+    void onUndo();
+    void onRedo();
+    void onBoardTabChanged(int index);
+    void onNewBoard();
 
 private:
-    void refreshBoardView();
-    QListWidget* listForViewport(QObject* viewport) const;
-    TaskStatus targetStatusForList(QListWidget* list) const;
+    int selectedTaskId() const;
+    void openBoard(int index);
+    void finishBoardOpen(const QString& error = QString());
+    void updateBoardTabs();
+    QString activeBoardName() const;
+    void finishLoad();
+    void setEditingEnabled(bool enabled);
+    // Идёт загрузка файла JSON или доски рабочего пространства.
+    bool isLoading() const;
+    void updateUndoButtons();
+    void updateBoardGauges();
+    bool startSave(const QString& filename, bool manual);
+    void onSaveFinished(const QString& filename, quint64 revision, bool manual, const QString& error);
 
 private:
     Ui::MainWindow *ui;
     ScrumBoard board;
+    std::unique_ptr<TaskItemFormat::DeveloperNameCache> m_developerNames;
+    std::unique_ptr<BoardColumnModel> m_assignedModel;
+    std::unique_ptr<BoardColumnModel> m_inProgressModel;
+    std::unique_ptr<BoardColumnModel> m_doneModel;
     std::unique_ptr<BoardListsController> m_listsController;
+    std::unique_ptr<BoardHistory> m_history;
+
+    // Доски рабочего пространства показываются вкладками; все виды привязаны
+    // к board, а рабочее пространство подменяет её содержимое при переключении.
+    // Журнал активной доски — m_workspace->journal().
+    std::unique_ptr<BoardWorkspace> m_workspace;
+    QTabBar* m_boardTabs = nullptr;
+    QToolButton* m_newBoard = nullptr;
+    // Куда вернуться, если новая доска не открылась.
+    int m_previousBoard = -1;
+
+    // Сохранение идёт в фоне; ревизия считает изменения доски, чтобы
+    // автосохранение не переписывало файл без надобности.
+    BoardSaver m_saver;
+    QTimer m_autosaveTimer;
+    int m_revisionSubscription = 0;
+    quint64 m_revision = 0;
+    quint64 m_autosavedRevision = 0;
+
+    // Загрузка идёт порциями по таймеру; на время загрузки прежняя доска
+    // хранится копией, чтобы вернуть её при отмене или ошибке.
+    std::unique_ptr<BoardLoader> m_loader;
+    QString m_loadFile;
+    ScrumBoard m_boardBeforeLoad;
+    QTimer m_loadTimer;
+    QProgressBar* m_loadProgress = nullptr;
+    QPushButton* m_cancelLoad = nullptr;
+
+    // Поиск фильтрует колонки по индексу; результат пересчитывается по
+    // таймеру после изменений доски, пока строка поиска не пуста.
+    std::unique_ptr<TaskSearchIndex> m_searchIndex;
+    std::vector<int> m_searchResults;
+    bool m_searchActive = false;
+    QTimer m_searchTimer;
+    int m_searchSubscription = 0;
+
+    // Показатели: док переключается F12, при выходе сводка пишется в файл.
+    MetricsOverlay* m_metricsOverlay = nullptr;
 };
 
 #endif
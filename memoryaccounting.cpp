@@ -0,0 +1,164 @@
+#include "memoryaccounting.h"
+#include "metrics.h"
+#include <algorithm>
+#include <cstdio>
+#include <string>
+
+namespace memory {
+namespace {
+
+const char* const kComponentNames[kComponentCount] = {
+    "Текст задач",
+    "Таблицы пула строк",
+    "Столбцы задач",
+    "Индекс ID задач",
+    "Индекс статусов",
+    "Разработчики",
+    "Поисковый индекс",
+    "Представление",
+    "Арены досок",
+};
+
+// Ширина строки на экране: русские буквы занимают по два байта UTF-8.
+std::size_t displayWidth(const char* text)
+{
+    std::size_t width = 0;
+    for (const char* p = text; *p; ++p) {
+        if (((unsigned char)*p & 0xC0) != 0x80) ++width;
+    }
+    return width;
+}
+
+}
+
+void* CountingResource::do_allocate(std::size_t bytes, std::size_t alignment)
+{
+    void* p = upstream_->allocate(bytes, alignment);
+    std::size_t now = bytes_.fetch_add(bytes, std::memory_order_relaxed) + bytes;
+    std::size_t peak = peakBytes_.load(std::memory_order_relaxed);
+    while (now > peak && !peakBytes_.compare_exchange_weak(peak, now, std::memory_order_relaxed)) {
+    }
+    blocks_.fetch_add(1, std::memory_order_relaxed);
+    allocations_.fetch_add(1, std::memory_order_relaxed);
+    return p;
+}
+
+void CountingResource::do_deallocate(void* p, std::size_t bytes, std::size_t alignment)
+{
+    upstream_->deallocate(p, bytes, alignment);
+    bytes_.fetch_sub(bytes, std::memory_order_relaxed);
+    blocks_.fetch_sub(1, std::memory_order_relaxed);
+}
+
+bool CountingResource::do_is_equal(const std::pmr::memory_resource& other) const noexcept
+{
+    return this == &other;
+}
+
+namespace {
+
+// Блок текста доски (256 КБ) ещё попадает в пул.
+std::pmr::pool_options arenaPoolOptions()
+{
+    std::pmr::pool_options options;
+    options.largest_required_pool_block = 512 * 1024;
+    return options;
+}
+
+}
+
+// Монотонный буфер не синхронизирован, но пул обращается к нему только
+// под своей блокировкой.
+Arena::Arena(std::size_t initialBytes)
+    : counter_(&resource(Component::Arenas)),
+      buffer_(initialBytes, &counter_),
+      pool_(arenaPoolOptions(), &buffer_),
+      largestPooledBlock_(pool_.options().largest_required_pool_block)
+{
+}
+
+void* Arena::do_allocate(std::size_t bytes, std::size_t alignment)
+{
+    // Большой блок из буфера не вернулся бы до разрушения арены.
+    if (bytes > largestPooledBlock_) return counter_.allocate(bytes, alignment);
+    return pool_.allocate(bytes, alignment);
+}
+
+void Arena::do_deallocate(void* p, std::size_t bytes, std::size_t alignment)
+{
+    if (bytes > largestPooledBlock_) {
+        counter_.deallocate(p, bytes, alignment);
+        return;
+    }
+    pool_.deallocate(p, bytes, alignment);
+}
+
+bool Arena::do_is_equal(const std::pmr::memory_resource& other) const noexcept
+{
+    return this == &other;
+}
+
+CountingResource& resource(Component component)
+{
+    // Не разрушаются при выходе: статические доски и потоки сохранения
+    // освобождают память позже статических объектов.
+    static CountingResource* const resources = new CountingResource[kComponentCount];
+    return resources[(std::size_t)component];
+}
+
+const char* componentName(Component component)
+{
+    return kComponentNames[(std::size_t)component];
+}
+
+std::size_t Report::totalBytes() const noexcept
+{
+    std::size_t total = 0;
+    for (const ComponentUsage& usage : components) total += usage.bytes;
+    return total;
+}
+
+Report report()
+{
+    Report result;
+    for (std::size_t i = 0; i < kComponentCount; ++i) {
+        const CountingResource& r = resource((Component)i);
+        result.components[i] = {r.bytes(), r.peakBytes(), r.blocks()};
+    }
+    return result;
+}
+
+void writeText(std::ostream& out, const Report& report, std::size_t tasks)
+{
+    std::size_t width = displayWidth("Всего");
+    for (const char* name : kComponentNames) width = std::max(width, displayWidth(name));
+
+    auto padLeft = [&](const std::string& text, std::size_t columns) {
+        std::size_t w = displayWidth(text.c_str());
+        if (w < columns) out << std::string(columns - w, ' ');
+        out << text;
+    };
+    auto line = [&](const char* name, std::size_t bytes, std::size_t blocks, const std::size_t* peak) {
+        out << name << std::string(width - displayWidth(name), ' ');
+        padLeft(metrics::formatValue((double)bytes, metrics::Unit::Bytes), 12);
+        padLeft(std::to_string(blocks) + " выд.", 14);
+        if (tasks > 0) {
+            char text[32];
+            std::snprintf(text, sizeof(text), "%.1f Б/задачу", (double)bytes / (double)tasks);
+            padLeft(text, 18);
+        }
+        if (peak) out << "  пик " << metrics::formatValue((double)*peak, metrics::Unit::Bytes);
+        out << '\n';
+    };
+
+    std::size_t blocks = 0;
+    for (std::size_t i = 0; i < kComponentCount; ++i) {
+        const ComponentUsage& usage = report.components[i];
+        line(kComponentNames[i], usage.bytes, usage.blocks, &usage.peakBytes);
+        blocks += usage.blocks;
+    }
+    // Пики частей приходятся на разное время, поэтому их сумма не пишется.
+    line("Всего", report.totalBytes(), blocks, nullptr);
+}
+
+}
@@ -0,0 +1,172 @@
+#pragma once
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory_resource>
+#include <ostream>
+#include <type_traits>
+#include <utility>
+
+// Учёт памяти доски по составным частям. Контейнеры доски, индексов и
+// представления берут память у ресурса своей части:
+//
+//     PersistentVector<int> ids(memory::resource(memory::Component::TaskColumns));
+//
+// Ресурс считает байты, которые реально выделены и ещё не освобождены,
+// поэтому узлы, общие у доски и её снимков, учитываются один раз. Счёт
+// общий на процесс: в него входят и снимки истории, и копии для сохранения.
+// Размер служебных заголовков кучи в счёт не входит.
+namespace memory {
+
+enum class Component {
+    TaskText,       // байты строк в блоках пула текста
+    TextTables,     // дескрипторы строк и таблица интернирования пула
+    TaskColumns,    // столбцы хранилища: ID, статусы, исполнители, ссылки на текст
+    TaskIndex,      // ID задачи -> позиция в хранилище
+    StatusIndex,    // упорядоченные ID задач каждого статуса
+    Developers,     // разработчики и таблица ID -> позиция
+    SearchIndex,    // полнотекстовый индекс
+    View,           // строки колонок и кеш имён в интерфейсе
+    Arenas,         // буферы арен досок (ScrumBoard::withArena) целиком
+};
+
+constexpr std::size_t kComponentCount = 9;
+
+// Ресурс-счётчик поверх upstream. Счётчики атомарные: ресурсом могут
+// пользоваться несколько потоков, если им разрешает upstream.
+class CountingResource : public std::pmr::memory_resource {
+public:
+    explicit CountingResource(std::pmr::memory_resource* upstream = std::pmr::new_delete_resource()) noexcept
+        : upstream_(upstream) {}
+
+    CountingResource(const CountingResource&) = delete;
+    CountingResource& operator=(const CountingResource&) = delete;
+
+    std::size_t bytes() const noexcept { return bytes_.load(std::memory_order_relaxed); }
+    std::size_t peakBytes() const noexcept { return peakBytes_.load(std::memory_order_relaxed); }
+    // Живые выделения.
+    std::size_t blocks() const noexcept { return blocks_.load(std::memory_order_relaxed); }
+    // Все выделения с начала работы.
+    std::uint64_t allocations() const noexcept { return allocations_.load(std::memory_order_relaxed); }
+
+    void resetPeak() noexcept { peakBytes_.store(bytes(), std::memory_order_relaxed); }
+
+    std::pmr::memory_resource* upstream() const noexcept { return upstream_; }
+
+protected:
+    void* do_allocate(std::size_t bytes, std::size_t alignment) override;
+    void do_deallocate(void* p, std::size_t bytes, std::size_t alignment) override;
+    bool do_is_equal(const std::pmr::memory_resource& other) const noexcept override;
+
+private:
+    std::pmr::memory_resource* upstream_;
+    std::atomic<std::size_t> bytes_{0};
+    std::atomic<std::size_t> peakBytes_{0};
+    std::atomic<std::size_t> blocks_{0};
+    std::atomic<std::uint64_t> allocations_{0};
+};
+
+// Арена доски (ScrumBoard::withArena). Буферы берутся у
+// resource(Component::Arenas) через собственный счётчик, поэтому размер
+// известен и для каждой арены отдельно. Блоки выдаёт пул поверх
+// монотонного буфера: освобождённые правками узлы и блоки текста идут
+// в списки свободных блоков пула и используются снова, а сам буфер
+// возвращается целиком при разрушении арены. Блоки больше
+// largestPooledBlock() берутся прямо у счётчика и освобождаются сразу.
+// Арена потокобезопасна: копии доски разрушаются и в фоновых потоках.
+class Arena : public std::pmr::memory_resource {
+public:
+    explicit Arena(std::size_t initialBytes);
+
+    Arena(const Arena&) = delete;
+    Arena& operator=(const Arena&) = delete;
+
+    // Байты буферов арены, включая ещё не занятый хвост и свободные блоки пула.
+    std::size_t bytes() const noexcept { return counter_.bytes(); }
+    std::size_t largestPooledBlock() const noexcept { return largestPooledBlock_; }
+
+protected:
+    void* do_allocate(std::size_t bytes, std::size_t alignment) override;
+    void do_deallocate(void* p, std::size_t bytes, std::size_t alignment) override;
+    bool do_is_equal(const std::pmr::memory_resource& other) const noexcept override;
+
+private:
+    CountingResource counter_;
+    std::pmr::monotonic_buffer_resource buffer_;
+    std::pmr::synchronized_pool_resource pool_;
+    std::size_t largestPooledBlock_;
+};
+
+// polymorphic_allocator, который переходит к контейнеру вместе с содержимым
+// при копировании, присваивании и обмене. Так память по-прежнему
+// возвращается тому ресурсу, из которого взята, а копия доски остаётся
+// в ресурсе оригинала, а не в ресурсе по умолчанию.
+template <typename T>
+class PropagatingAllocator {
+public:
+    using value_type = T;
+    using propagate_on_container_copy_assignment = std::true_type;
+    using propagate_on_container_move_assignment = std::true_type;
+    using propagate_on_container_swap = std::true_type;
+
+    PropagatingAllocator(std::pmr::memory_resource* resource) noexcept : resource_(resource) {}
+
+    template <typename U>
+    PropagatingAllocator(const PropagatingAllocator<U>& other) noexcept : resource_(other.resource()) {}
+
+    T* allocate(std::size_t n) {
+        return static_cast<T*>(resource_->allocate(n * sizeof(T), alignof(T)));
+    }
+    void deallocate(T* p, std::size_t n) noexcept {
+        resource_->deallocate(p, n * sizeof(T), alignof(T));
+    }
+
+    // Элементам с allocator_type (Developer, pmr::string) передаётся тот же
+    // ресурс, как у polymorphic_allocator.
+    template <typename U, typename... Args>
+    void construct(U* p, Args&&... args) {
+        std::pmr::polymorphic_allocator<T>(resource_).construct(p, std::forward<Args>(args)...);
+    }
+
+    PropagatingAllocator select_on_container_copy_construction() const noexcept { return *this; }
+    std::pmr::memory_resource* resource() const noexcept { return resource_; }
+
+    template <typename U>
+    bool operator==(const PropagatingAllocator<U>& other) const noexcept {
+        return *resource_ == *other.resource();
+    }
+    template <typename U>
+    bool operator!=(const PropagatingAllocator<U>& other) const noexcept { return !(*this == other); }
+
+private:
+    std::pmr::memory_resource* resource_;
+};
+
+// Ресурс части; живёт до конца процесса.
+CountingResource& resource(Component component);
+
+// "Текст задач", "Индекс статусов".
+const char* componentName(Component component);
+
+struct ComponentUsage {
+    std::size_t bytes = 0;
+    std::size_t peakBytes = 0;
+    std::size_t blocks = 0;
+};
+
+struct Report {
+    std::array<ComponentUsage, kComponentCount> components{};
+
+    const ComponentUsage& operator[](Component component) const {
+        return components[(std::size_t)component];
+    }
+    std::size_t totalBytes() const noexcept;
+};
+
+Report report();
+
+// Таблица: байты и выделения по частям; при tasks > 0 — ещё и байты на задачу.
+void writeText(std::ostream& out, const Report& report, std::size_t tasks = 0);
+
+}
@@ -0,0 +1,253 @@
+#include "metrics.h"
+#include "atomicfile.h"
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <stdexcept>
+#include <nlohmann/json.hpp>
+
+#ifdef _MSC_VER
+#include <intrin.h>
+#endif
+
+namespace metrics {
+namespace {
+
+int highestBit(std::uint64_t value)
+{
+#ifdef _MSC_VER
+    unsigned long index;
+    _BitScanReverse64(&index, value);
+    return (int)index;
+#else
+    return 63 - __builtin_clzll(value);
+#endif
+}
+
+struct Entry {
+    Sample::Kind kind;
+    Unit unit;
+    std::unique_ptr<Counter> counter;
+    std::unique_ptr<Gauge> gauge;
+    std::unique_ptr<Histogram> histogram;
+};
+
+// Показатели живут до конца процесса: ссылки на них хранятся в статических
+// переменных, и потоки могут писать в них при выходе.
+struct Registry {
+    std::mutex mutex;
+    std::map<std::string, Entry> entries;
+};
+
+Registry& registry()
+{
+    static Registry* instance = new Registry;
+    return *instance;
+}
+
+Entry& entry(const std::string& name, Sample::Kind kind, Unit unit)
+{
+    Registry& r = registry();
+    std::lock_guard<std::mutex> lock(r.mutex);
+    auto [it, inserted] = r.entries.try_emplace(name);
+    Entry& e = it->second;
+    if (inserted) {
+        e.kind = kind;
+        e.unit = unit;
+        switch (kind) {
+        case Sample::Kind::Counter: e.counter = std::make_unique<Counter>(); break;
+        case Sample::Kind::Gauge: e.gauge = std::make_unique<Gauge>(); break;
+        case Sample::Kind::Histogram: e.histogram = std::make_unique<Histogram>(unit); break;
+        }
+    } else if (e.kind != kind) {
+        throw std::logic_error("Показатель " + name + " уже зарегистрирован с другим видом");
+    }
+    return e;
+}
+
+const char* unitName(Unit unit)
+{
+    switch (unit) {
+    case Unit::Nanoseconds: return "ns";
+    case Unit::Bytes: return "bytes";
+    case Unit::None: break;
+    }
+    return "";
+}
+
+const double kPercentiles[] = { 0.5, 0.9, 0.99 };
+const char* const kPercentileNames[] = { "p50", "p90", "p99" };
+
+}
+
+std::uint64_t HistogramSnapshot::percentile(double q) const
+{
+    if (count == 0) return 0;
+    std::uint64_t target = (std::uint64_t)std::ceil(std::clamp(q, 0.0, 1.0) * (double)count);
+    target = std::max<std::uint64_t>(target, 1);
+    std::uint64_t seen = 0;
+    for (std::size_t i = 0; i < buckets.size(); ++i) {
+        seen += buckets[i];
+        if (seen >= target) return std::min(Histogram::bucketUpperBound(i), max);
+    }
+    return max;
+}
+
+std::size_t Histogram::bucketOf(std::uint64_t value) noexcept
+{
+    if (value < kSubBuckets) return (std::size_t)value;
+    int bit = highestBit(value);
+    std::size_t sub = (std::size_t)(value >> (bit - kSubBucketBits)) - kSubBuckets;
+    return (std::size_t)(bit - kSubBucketBits + 1) * kSubBuckets + sub;
+}
+
+std::uint64_t Histogram::bucketUpperBound(std::size_t bucket) noexcept
+{
+    if (bucket < kSubBuckets) return bucket;
+    int shift = (int)(bucket / kSubBuckets) - 1;
+    std::uint64_t lower = (std::uint64_t)(kSubBuckets + bucket % kSubBuckets) << shift;
+    return lower + ((std::uint64_t(1) << shift) - 1);
+}
+
+void Histogram::record(std::uint64_t value) noexcept
+{
+    buckets_[bucketOf(value)].fetch_add(1, std::memory_order_relaxed);
+    sum_.fetch_add(value, std::memory_order_relaxed);
+    std::uint64_t max = max_.load(std::memory_order_relaxed);
+    while (value > max && !max_.compare_exchange_weak(max, value, std::memory_order_relaxed)) {
+    }
+}
+
+HistogramSnapshot Histogram::snapshot() const
+{
+    HistogramSnapshot snap;
+    snap.buckets.resize(kBuckets);
+    for (std::size_t i = 0; i < kBuckets; ++i) {
+        snap.buckets[i] = buckets_[i].load(std::memory_order_relaxed);
+        snap.count += snap.buckets[i];
+    }
+    snap.sum = sum_.load(std::memory_order_relaxed);
+    snap.max = max_.load(std::memory_order_relaxed);
+    return snap;
+}
+
+Counter& counter(const std::string& name)
+{
+    return *entry(name, Sample::Kind::Counter, Unit::None).counter;
+}
+
+Gauge& gauge(const std::string& name, Unit unit)
+{
+    return *entry(name, Sample::Kind::Gauge, unit).gauge;
+}
+
+Histogram& histogram(const std::string& name, Unit unit)
+{
+    return *entry(name, Sample::Kind::Histogram, unit).histogram;
+}
+
+std::vector<Sample> snapshot()
+{
+    Registry& r = registry();
+    std::lock_guard<std::mutex> lock(r.mutex);
+    std::vector<Sample> samples;
+    samples.reserve(r.entries.size());
+    for (const auto& [name, e] : r.entries) {
+        Sample sample{name, e.kind, e.unit, 0, {}};
+        switch (e.kind) {
+        case Sample::Kind::Counter: sample.value = (std::int64_t)e.counter->value(); break;
+        case Sample::Kind::Gauge: sample.value = e.gauge->value(); break;
+        case Sample::Kind::Histogram: sample.histogram = e.histogram->snapshot(); break;
+        }
+        samples.push_back(std::move(sample));
+    }
+    return samples;
+}
+
+std::string formatValue(double value, Unit unit)
+{
+    static const char* const kTimeUnits[] = { "нс", "мкс", "мс", "с" };
+    static const char* const kByteUnits[] = { "Б", "КБ", "МБ", "ГБ", "ТБ" };
+
+    char text[64];
+    if (unit == Unit::None) {
+        if (value == std::floor(value)) std::snprintf(text, sizeof(text), "%.0f", value);
+        else std::snprintf(text, sizeof(text), "%.2f", value);
+        return text;
+    }
+
+    const char* const* names = unit == Unit::Nanoseconds ? kTimeUnits : kByteUnits;
+    std::size_t last = unit == Unit::Nanoseconds ? 3 : 4;
+    double step = unit == Unit::Nanoseconds ? 1000.0 : 1024.0;
+    std::size_t i = 0;
+    while (i < last && std::fabs(value) >= step) {
+        value /= step;
+        ++i;
+    }
+    if (i == 0) std::snprintf(text, sizeof(text), "%.0f %s", value, names[i]);
+    else std::snprintf(text, sizeof(text), "%.2f %s", value, names[i]);
+    return text;
+}
+
+void writeText(std::ostream& out, const std::vector<Sample>& samples)
+{
+    std::size_t width = 0;
+    for (const Sample& sample : samples) width = std::max(width, sample.name.size());
+
+    for (const Sample& sample : samples) {
+        out << sample.name << std::string(width - sample.name.size() + 2, ' ');
+        if (sample.kind != Sample::Kind::Histogram) {
+            out << formatValue((double)sample.value, sample.unit) << '\n';
+            continue;
+        }
+        const HistogramSnapshot& h = sample.histogram;
+        out << "n=" << h.count;
+        for (std::size_t i = 0; i < 3; ++i) {
+            out << "  " << kPercentileNames[i] << '=' << formatValue((double)h.percentile(kPercentiles[i]), sample.unit);
+        }
+        out << "  max=" << formatValue((double)h.max, sample.unit) << '\n';
+    }
+}
+
+void writeJson(std::ostream& out, const std::vector<Sample>& samples)
+{
+    nlohmann::json list = nlohmann::json::array();
+    for (const Sample& sample : samples) {
+        nlohmann::json item = {{"name", sample.name}, {"unit", unitName(sample.unit)}};
+        switch (sample.kind) {
+        case Sample::Kind::Counter:
+            item["kind"] = "counter";
+            item["value"] = sample.value;
+            break;
+        case Sample::Kind::Gauge:
+            item["kind"] = "gauge";
+            item["value"] = sample.value;
+            break;
+        case Sample::Kind::Histogram: {
+            const HistogramSnapshot& h = sample.histogram;
+            item["kind"] = "histogram";
+            item["count"] = h.count;
+            item["sum"] = h.sum;
+            for (std::size_t i = 0; i < 3; ++i) item[kPercentileNames[i]] = h.percentile(kPercentiles[i]);
+            item["max"] = h.max;
+            break;
+        }
+        }
+        list.push_back(std::move(item));
+    }
+    out << nlohmann::json{{"metrics", std::move(list)}}.dump(2) << '\n';
+    if (!out) {
+        throw std::runtime_error("Ошибка записи показателей");
+    }
+}
+
+void saveJson(const std::string& filename)
+{
+    std::vector<Sample> samples = snapshot();
+    writeFileAtomically(filename, [&](std::ostream& out) { writeJson(out, samples); });
+}
+
+}
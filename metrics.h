@@ -0,0 +1,127 @@
+#pragma once
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <ostream>
+#include <string>
+#include <vector>
+
+// Постоянно включённые сводные показатели: счётчики, текущие значения и
+// гистограммы с логарифмическими корзинами. Показатель регистрируется по
+// имени один раз, обычно в статической переменной у места измерения:
+//
+//     static metrics::Histogram& refresh = metrics::histogram("view.refresh");
+//     metrics::Timer timer(refresh);
+//
+// Регистрация берёт мьютекс, а запись — только атомарные операции без
+// блокировок, так что показатели можно менять из любого потока. Снимок
+// читается без остановки записи и внутри гистограммы может разойтись
+// на несколько только что записанных значений.
+namespace metrics {
+
+enum class Unit { None, Nanoseconds, Bytes };
+
+class Counter {
+public:
+    void add(std::uint64_t n = 1) noexcept { value_.fetch_add(n, std::memory_order_relaxed); }
+    std::uint64_t value() const noexcept { return value_.load(std::memory_order_relaxed); }
+
+private:
+    std::atomic<std::uint64_t> value_{0};
+};
+
+class Gauge {
+public:
+    void set(std::int64_t value) noexcept { value_.store(value, std::memory_order_relaxed); }
+    void add(std::int64_t delta) noexcept { value_.fetch_add(delta, std::memory_order_relaxed); }
+    std::int64_t value() const noexcept { return value_.load(std::memory_order_relaxed); }
+
+private:
+    std::atomic<std::int64_t> value_{0};
+};
+
+struct HistogramSnapshot {
+    std::uint64_t count = 0;
+    std::uint64_t sum = 0;
+    std::uint64_t max = 0;
+    std::vector<std::uint64_t> buckets;
+
+    // Верхняя граница корзины, в которую попадает доля q значений (не больше max).
+    std::uint64_t percentile(double q) const;
+    double mean() const { return count ? (double)sum / (double)count : 0.0; }
+};
+
+// Значения до 8 хранятся точно, дальше каждая степень двойки делится на
+// 8 корзин: относительная ошибка процентилей не больше 12,5%.
+class Histogram {
+public:
+    static constexpr int kSubBucketBits = 3;
+    static constexpr std::size_t kSubBuckets = std::size_t(1) << kSubBucketBits;
+    static constexpr std::size_t kBuckets = (64 - kSubBucketBits + 1) * kSubBuckets;
+
+    explicit Histogram(Unit unit = Unit::Nanoseconds) : unit_(unit) {}
+
+    void record(std::uint64_t value) noexcept;
+    HistogramSnapshot snapshot() const;
+    Unit unit() const noexcept { return unit_; }
+
+    static std::size_t bucketOf(std::uint64_t value) noexcept;
+    static std::uint64_t bucketUpperBound(std::size_t bucket) noexcept;
+
+private:
+    Unit unit_;
+    std::array<std::atomic<std::uint64_t>, kBuckets> buckets_{};
+    std::atomic<std::uint64_t> sum_{0};
+    std::atomic<std::uint64_t> max_{0};
+};
+
+// Повторный вызов с тем же именем возвращает тот же показатель; имя,
+// занятое показателем другого вида, — std::logic_error.
+Counter& counter(const std::string& name);
+Gauge& gauge(const std::string& name, Unit unit = Unit::None);
+Histogram& histogram(const std::string& name, Unit unit = Unit::Nanoseconds);
+
+// Длительность от создания до разрушения, в наносекундах.
+class Timer {
+public:
+    explicit Timer(Histogram& histogram) noexcept
+        : histogram_(histogram), start_(std::chrono::steady_clock::now()) {}
+
+    ~Timer() {
+        auto elapsed = std::chrono::steady_clock::now() - start_;
+        histogram_.record((std::uint64_t)std::chrono::duration_cast<std::chrono::nanoseconds>(elapsed).count());
+    }
+
+    Timer(const Timer&) = delete;
+    Timer& operator=(const Timer&) = delete;
+
+private:
+    Histogram& histogram_;
+    std::chrono::steady_clock::time_point start_;
+};
+
+struct Sample {
+    enum class Kind { Counter, Gauge, Histogram };
+
+    std::string name;
+    Kind kind;
+    Unit unit;
+    std::int64_t value;             // счётчик и текущее значение
+    HistogramSnapshot histogram;
+};
+
+// Все показатели по возрастанию имени.
+std::vector<Sample> snapshot();
+
+// "1.25 мс", "3.4 МБ".
+std::string formatValue(double value, Unit unit);
+
+// Таблица для чтения человеком: гистограммы — число, p50, p90, p99 и максимум.
+void writeText(std::ostream& out, const std::vector<Sample>& samples);
+// JSON с теми же полями; значения — в исходных единицах.
+void writeJson(std::ostream& out, const std::vector<Sample>& samples);
+void saveJson(const std::string& filename);
+
+}
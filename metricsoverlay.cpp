@@ -0,0 +1,57 @@
+#include "metricsoverlay.h"
+#include "memoryaccounting.h"
+#include "metrics.h"
+
+#include <QFontDatabase>
+#include <QPlainTextEdit>
+#include <QScrollBar>
+#include <algorithm>
+#include <sstream>
+
+namespace {
+const int RefreshIntervalMs = 500;
+}
+
+MetricsOverlay::MetricsOverlay(QWidget* parent)
+    : QDockWidget("Показатели", parent)
+{
+    setObjectName("metricsOverlay");
+
+    m_text = new QPlainTextEdit(this);
+    m_text->setReadOnly(true);
+    m_text->setLineWrapMode(QPlainTextEdit::NoWrap);
+    m_text->setFont(QFontDatabase::systemFont(QFontDatabase::FixedFont));
+    setWidget(m_text);
+
+    m_refreshTimer.setInterval(RefreshIntervalMs);
+    connect(&m_refreshTimer, &QTimer::timeout, this, &MetricsOverlay::refresh);
+}
+
+void MetricsOverlay::showEvent(QShowEvent* event)
+{
+    QDockWidget::showEvent(event);
+    refresh();
+    m_refreshTimer.start();
+}
+
+void MetricsOverlay::hideEvent(QHideEvent* event)
+{
+    m_refreshTimer.stop();
+    QDockWidget::hideEvent(event);
+}
+
+void MetricsOverlay::refresh()
+{
+    std::ostringstream text;
+    metrics::writeText(text, metrics::snapshot());
+
+    // Память на задачу считается по числу задач открытой доски.
+    static metrics::Gauge& tasks = metrics::gauge("board.tasks");
+    text << "\nПамять\n";
+    memory::writeText(text, memory::report(), (std::size_t)std::max<std::int64_t>(tasks.value(), 0));
+
+    // Прокрутка сохраняется: текст заменяется целиком дважды в секунду.
+    int scroll = m_text->verticalScrollBar()->value();
+    m_text->setPlainText(QString::fromStdString(text.str()));
+    m_text->verticalScrollBar()->setValue(scroll);
+}
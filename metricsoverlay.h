@@ -0,0 +1,23 @@
+#pragma once
+#include <QDockWidget>
+#include <QTimer>
+
+class QPlainTextEdit;
+
+// Док с показателями metrics и отчётом о памяти по частям доски. Пока док
+// скрыт, таймер стоит и ничего не стоит.
+class MetricsOverlay : public QDockWidget {
+    Q_OBJECT
+public:
+    explicit MetricsOverlay(QWidget* parent = nullptr);
+
+protected:
+    void showEvent(QShowEvent* event) override;
+    void hideEvent(QHideEvent* event) override;
+
+private:
+    void refresh();
+
+    QPlainTextEdit* m_text = nullptr;
+    QTimer m_refreshTimer;
+};
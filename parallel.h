@@ -0,0 +1,51 @@
+#pragma once
+#include <algorithm>
+#include <cstddef>
+#include <exception>
+#include <future>
+#include <thread>
+#include <vector>
+
+// Число рабочих потоков: 0 — по числу ядер.
+inline unsigned resolveThreadCount(unsigned threads) {
+    if (threads == 0) threads = std::thread::hardware_concurrency();
+    return std::max(threads, 1u);
+}
+
+// Делит [0, count) на не больше чем threads смежных частей и вызывает
+// fn(part, begin, end) для каждой; часть 0 выполняется в вызывающем потоке.
+// Возвращает число частей. Первое исключение из частей выбрасывается
+// после завершения всех остальных.
+template <typename Fn>
+std::size_t parallelFor(std::size_t count, unsigned threads, Fn&& fn) {
+    std::size_t parts = std::min<std::size_t>(resolveThreadCount(threads), count);
+    if (parts <= 1) {
+        if (count > 0) fn(std::size_t(0), std::size_t(0), count);
+        return count > 0 ? 1 : 0;
+    }
+
+    auto bound = [count, parts](std::size_t part) { return count * part / parts; };
+    std::vector<std::future<void>> workers;
+    workers.reserve(parts - 1);
+    for (std::size_t part = 1; part < parts; ++part) {
+        workers.push_back(std::async(std::launch::async, [&fn, part, &bound]() {
+            fn(part, bound(part), bound(part + 1));
+        }));
+    }
+
+    std::exception_ptr error;
+    try {
+        fn(std::size_t(0), std::size_t(0), bound(1));
+    } catch (...) {
+        error = std::current_exception();
+    }
+    for (std::future<void>& worker : workers) {
+        try {
+            worker.get();
+        } catch (...) {
+            if (!error) error = std::current_exception();
+        }
+    }
+    if (error) std::rethrow_exception(error);
+    return parts;
+}
@@ -0,0 +1,224 @@
+#pragma once
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <iterator>
+#include <memory>
+#include <memory_resource>
+#include <utility>
+#include <vector>
+
+// Упорядоченное множество ID кусками до kChunkSize: таблица кусков общая
+// у копий, как и сами куски. Вставка или удаление копирует таблицу (по
+// указателю на кусок) и один кусок, а не всё множество. ID, который больше
+// всех прежних, дописывается в последний кусок без сдвигов.
+//
+// Правила потоков и ресурса памяти те же, что у PersistentVector.
+class PersistentIdSet {
+    static constexpr std::size_t kChunkSize = 1024;
+
+    using Chunk = std::pmr::vector<int>;
+
+    struct Table {
+        explicit Table(std::pmr::memory_resource* resource) : chunks(resource), firsts(resource) {}
+        Table(const Table& other, std::pmr::memory_resource* resource)
+            : chunks(other.chunks, resource), firsts(other.firsts, resource) {}
+
+        std::pmr::vector<std::shared_ptr<Chunk>> chunks;
+        std::pmr::vector<int> firsts;   // первый ID каждого куска, для двоичного поиска
+    };
+
+public:
+    class const_iterator {
+    public:
+        using iterator_category = std::forward_iterator_tag;
+        using value_type = int;
+        using difference_type = std::ptrdiff_t;
+        using pointer = const int*;
+        using reference = const int&;
+
+        const_iterator(const Table* table, std::size_t chunk, std::size_t item)
+            : table_(table), chunk_(chunk), item_(item) {}
+
+        const int& operator*() const noexcept { return (*table_->chunks[chunk_])[item_]; }
+
+        const_iterator& operator++() {
+            if (++item_ == table_->chunks[chunk_]->size()) {
+                ++chunk_;
+                item_ = 0;
+            }
+            return *this;
+        }
+
+        const_iterator operator++(int) { const_iterator tmp = *this; ++*this; return tmp; }
+        bool operator==(const const_iterator& other) const noexcept {
+            return chunk_ == other.chunk_ && item_ == other.item_;
+        }
+        bool operator!=(const const_iterator& other) const noexcept { return !(*this == other); }
+
+    private:
+        const Table* table_;
+        std::size_t chunk_;
+        std::size_t item_;
+    };
+
+    PersistentIdSet() = default;
+    explicit PersistentIdSet(std::pmr::memory_resource* resource) noexcept : resource_(resource) {}
+    PersistentIdSet(const PersistentIdSet&) = default;
+    PersistentIdSet& operator=(const PersistentIdSet&) = default;
+
+    PersistentIdSet(PersistentIdSet&& other) noexcept
+        : table_(std::move(other.table_)), size_(other.size_), resource_(other.resource_) {
+        other.size_ = 0;
+    }
+
+    PersistentIdSet& operator=(PersistentIdSet&& other) noexcept {
+        table_.swap(other.table_);
+        std::swap(size_, other.size_);
+        std::swap(resource_, other.resource_);
+        other.clear();
+        return *this;
+    }
+
+    std::pmr::memory_resource* resource() const noexcept { return resource_; }
+
+    std::size_t size() const noexcept { return size_; }
+    bool empty() const noexcept { return size_ == 0; }
+
+    const_iterator begin() const { return const_iterator(table_.get(), 0, 0); }
+    const_iterator end() const { return const_iterator(table_.get(), table_ ? table_->chunks.size() : 0, 0); }
+
+    std::vector<int> toVector() const {
+        std::vector<int> ids;
+        ids.reserve(size_);
+        if (table_) {
+            for (const auto& chunk : table_->chunks) ids.insert(ids.end(), chunk->begin(), chunk->end());
+        }
+        return ids;
+    }
+
+    bool contains(int id) const {
+        if (!table_) return false;
+        const Chunk& chunk = *table_->chunks[chunkFor(id)];
+        return std::binary_search(chunk.begin(), chunk.end(), id);
+    }
+
+    bool insert(int id) {
+        Table& table = mutableTable();
+        if (table.chunks.empty() || (table.chunks.back()->size() >= kChunkSize && id > table.chunks.back()->back())) {
+            table.chunks.push_back(makeChunk());
+            table.chunks.back()->reserve(kChunkSize);
+            table.firsts.push_back(id);
+        }
+
+        std::size_t c = chunkFor(id);
+        const Chunk& shared = *table.chunks[c];
+        auto pos = std::lower_bound(shared.begin(), shared.end(), id);
+        if (pos != shared.end() && *pos == id) return false;
+        std::size_t offset = (std::size_t)(pos - shared.begin());
+
+        Chunk& chunk = mutableChunk(table, c);
+        chunk.insert(chunk.begin() + (std::ptrdiff_t)offset, id);
+        table.firsts[c] = chunk.front();
+        ++size_;
+
+        // Переполненный кусок делится пополам.
+        if (chunk.size() > 2 * kChunkSize) {
+            auto tail = makeChunk(chunk.begin() + (std::ptrdiff_t)kChunkSize, chunk.end());
+            chunk.resize(kChunkSize);
+            table.chunks.insert(table.chunks.begin() + (std::ptrdiff_t)c + 1, std::move(tail));
+            table.firsts.insert(table.firsts.begin() + (std::ptrdiff_t)c + 1, table.chunks[c + 1]->front());
+        }
+        return true;
+    }
+
+    bool erase(int id) {
+        if (!table_) return false;
+        std::size_t c = chunkFor(id);
+        const Chunk& shared = *table_->chunks[c];
+        auto pos = std::lower_bound(shared.begin(), shared.end(), id);
+        if (pos == shared.end() || *pos != id) return false;
+        std::size_t offset = (std::size_t)(pos - shared.begin());
+
+        Table& table = mutableTable();
+        --size_;
+        if (table.chunks[c]->size() == 1) {
+            table.chunks.erase(table.chunks.begin() + (std::ptrdiff_t)c);
+            table.firsts.erase(table.firsts.begin() + (std::ptrdiff_t)c);
+            if (table.chunks.empty()) table_.reset();
+            return true;
+        }
+        Chunk& chunk = mutableChunk(table, c);
+        chunk.erase(chunk.begin() + (std::ptrdiff_t)offset);
+        table.firsts[c] = chunk.front();
+        return true;
+    }
+
+    // Вливает отсортированные ID без повторов, которых ещё нет в множестве.
+    void insertSorted(const std::vector<int>& ids) {
+        if (ids.empty()) return;
+        if (table_ && ids.front() <= table_->chunks.back()->back()) {
+            for (int id : ids) insert(id);
+            return;
+        }
+        // Обычный случай — новые ID больше старых: дописываем кусками.
+        Table& table = mutableTable();
+        for (int id : ids) {
+            if (table.chunks.empty() || table.chunks.back()->size() >= kChunkSize) {
+                table.chunks.push_back(makeChunk());
+                table.chunks.back()->reserve(kChunkSize);
+                table.firsts.push_back(id);
+            }
+            mutableChunk(table, table.chunks.size() - 1).push_back(id);
+        }
+        size_ += ids.size();
+    }
+
+    void clear() noexcept {
+        table_.reset();
+        size_ = 0;
+    }
+
+private:
+    std::size_t chunkFor(int id) const {
+        const std::pmr::vector<int>& firsts = table_->firsts;
+        auto it = std::upper_bound(firsts.begin(), firsts.end(), id);
+        return it == firsts.begin() ? 0 : (std::size_t)(it - firsts.begin()) - 1;
+    }
+
+    // Chunk получает ресурс от аллокатора сам, Table — явным аргументом.
+    template <typename... Args>
+    std::shared_ptr<Chunk> makeChunk(Args&&... args) const {
+        return std::allocate_shared<Chunk>(std::pmr::polymorphic_allocator<Chunk>(resource_),
+                                           std::forward<Args>(args)...);
+    }
+
+    Table& mutableTable() {
+        std::pmr::polymorphic_allocator<Table> allocator(resource_);
+        if (!table_) {
+            table_ = std::allocate_shared<Table>(allocator, resource_);
+        } else if (table_.use_count() != 1) {
+            table_ = std::allocate_shared<Table>(allocator, *table_, resource_);
+        } else {
+            std::atomic_thread_fence(std::memory_order_acquire);
+        }
+        return *table_;
+    }
+
+    Chunk& mutableChunk(Table& table, std::size_t c) const {
+        std::shared_ptr<Chunk>& chunk = table.chunks[c];
+        if (chunk.use_count() != 1) {
+            auto copy = makeChunk();
+            copy->reserve(std::max(chunk->size() + 1, kChunkSize));
+            copy->assign(chunk->begin(), chunk->end());
+            chunk = std::move(copy);
+        } else {
+            std::atomic_thread_fence(std::memory_order_acquire);
+        }
+        return *chunk;
+    }
+
+    std::shared_ptr<Table> table_;
+    std::size_t size_ = 0;
+    std::pmr::memory_resource* resource_ = std::pmr::get_default_resource();
+};
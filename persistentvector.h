@@ -0,0 +1,277 @@
+#pragma once
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <iterator>
+#include <memory>
+#include <memory_resource>
+#include <type_traits>
+#include <utility>
+
+// Постоянный вектор: дерево с ветвлением 64 и листьями примерно по 4 КБ.
+// Копия разделяет с оригиналом все узлы и стоит O(1); запись копирует только
+// разделённые узлы на пути от корня к своему листу, то есть пару килобайт
+// и один лист вместо всего массива. Так снимки доски для фонового сохранения
+// и для истории отмены не стоят полной копии столбцов.
+//
+// Читать разделённые узлы можно из разных потоков; изменять объект
+// PersistentVector — только из того потока, которому он принадлежит.
+//
+// Узлы берутся у ресурса памяти вектора. Ресурс переходит вместе с узлами
+// при копировании и перемещении: каждый узел сам помнит, кому его вернуть,
+// поэтому векторы с разными ресурсами можно свободно присваивать друг другу.
+// Ресурс должен пережить все узлы, выделенные из него.
+template <typename T>
+class PersistentVector {
+    static constexpr unsigned kBranchBits = 6;
+    static constexpr std::size_t kBranch = std::size_t(1) << kBranchBits;
+
+    static constexpr unsigned leafBits() {
+        unsigned bits = 4;
+        while ((std::size_t(2) << bits) * sizeof(T) <= 4096) ++bits;
+        return bits;
+    }
+
+    static constexpr unsigned kLeafBits = leafBits();
+    static constexpr std::size_t kLeafSize = std::size_t(1) << kLeafBits;
+
+    struct Leaf {
+        std::array<T, kLeafSize> items{};
+    };
+
+    // Тип потомка определяется уровнем, поэтому указатели нетипизированные.
+    struct Inner {
+        std::array<std::shared_ptr<void>, kBranch> children;
+    };
+
+public:
+    class const_iterator {
+    public:
+        using iterator_category = std::forward_iterator_tag;
+        using value_type = T;
+        using difference_type = std::ptrdiff_t;
+        using pointer = const T*;
+        using reference = const T&;
+
+        const_iterator(const PersistentVector* vector, std::size_t index) : vector_(vector) {
+            if (index < vector->size_) {
+                seek(index);
+            } else if (index > 0) {
+                // Конец — позиция за последним элементом в его листе.
+                item_ = vector->leafAt(index - 1) + ((index - 1) & (kLeafSize - 1)) + 1;
+                nextLeaf_ = ((index - 1) | (kLeafSize - 1)) + 1;
+            }
+        }
+
+        const T& operator*() const noexcept { return *item_; }
+        const T* operator->() const noexcept { return item_; }
+
+        // Внутри листа — просто сдвиг указателя, спуск по дереву раз на лист.
+        const_iterator& operator++() {
+            if (++item_ == leafEnd_) seek(nextLeaf_);
+            return *this;
+        }
+
+        const_iterator operator++(int) { const_iterator tmp = *this; ++*this; return tmp; }
+        // Один лист может стоять в нескольких местах дерева (после assign),
+        // поэтому позицию задаёт пара «элемент, номер листа».
+        bool operator==(const const_iterator& other) const noexcept {
+            return item_ == other.item_ && nextLeaf_ == other.nextLeaf_;
+        }
+        bool operator!=(const const_iterator& other) const noexcept { return !(*this == other); }
+
+    private:
+        void seek(std::size_t index) {
+            if (index >= vector_->size_) return;
+            const T* leaf = vector_->leafAt(index);
+            item_ = leaf + (index & (kLeafSize - 1));
+            leafEnd_ = leaf + kLeafSize;
+            nextLeaf_ = (index | (kLeafSize - 1)) + 1;
+        }
+
+        const PersistentVector* vector_;
+        const T* item_ = nullptr;
+        const T* leafEnd_ = nullptr;
+        std::size_t nextLeaf_ = 0;
+    };
+
+    PersistentVector() = default;
+    explicit PersistentVector(std::pmr::memory_resource* resource) noexcept : resource_(resource) {}
+    PersistentVector(const PersistentVector&) = default;
+    PersistentVector& operator=(const PersistentVector&) = default;
+
+    PersistentVector(PersistentVector&& other) noexcept
+        : root_(std::move(other.root_)), size_(other.size_), depth_(other.depth_), resource_(other.resource_) {
+        other.size_ = 0;
+        other.depth_ = 0;
+    }
+
+    PersistentVector& operator=(PersistentVector&& other) noexcept {
+        root_.swap(other.root_);
+        std::swap(size_, other.size_);
+        std::swap(depth_, other.depth_);
+        std::swap(resource_, other.resource_);
+        other.clear();
+        return *this;
+    }
+
+    std::pmr::memory_resource* resource() const noexcept { return resource_; }
+
+    std::size_t size() const noexcept { return size_; }
+    bool empty() const noexcept { return size_ == 0; }
+
+    const T& operator[](std::size_t i) const noexcept { return leafAt(i)[i & (kLeafSize - 1)]; }
+    const T& back() const noexcept { return (*this)[size_ - 1]; }
+
+    const_iterator begin() const { return const_iterator(this, 0); }
+    const_iterator end() const { return const_iterator(this, size_); }
+    // Элементы с i до конца листа (но не дальше size()) лежат подряд:
+    // возвращает указатель на i-й и их число. Для пробирования хеш-таблиц.
+    const T* run(std::size_t i, std::size_t& count) const noexcept {
+        std::size_t offset = i & (kLeafSize - 1);
+        count = std::min(kLeafSize - offset, size_ - i);
+        return leafAt(i) + offset;
+    }
+
+    // Элемент для записи; разделённый с копиями путь к нему копируется.
+    T& mutate(std::size_t i) {
+        std::shared_ptr<void>* node = &root_;
+        for (unsigned level = depth_; level > 0; --level) {
+            makeUnique(*node, level);
+            node = &static_cast<Inner*>(node->get())->children[childIndex(i, level)];
+        }
+        makeUnique(*node, 0);
+        return static_cast<Leaf*>(node->get())->items[i & (kLeafSize - 1)];
+    }
+
+    void push_back(const T& value) {
+        if (root_ && size_ == capacity(depth_)) {
+            auto root = makeNode<Inner>();
+            root->children[0] = std::move(root_);
+            root_ = std::move(root);
+            ++depth_;
+        }
+        mutate(size_++) = value;
+    }
+
+    void pop_back() {
+        --size_;
+        if (size_ == 0) {
+            clear();
+            return;
+        }
+        if ((size_ & (kLeafSize - 1)) != 0) {
+            if constexpr (!std::is_trivially_destructible_v<T>) mutate(size_) = T();
+            return;
+        }
+        dropFrom(size_);
+        while (depth_ > 0 && size_ <= capacity(depth_ - 1)) {
+            std::shared_ptr<void> child = static_cast<Inner*>(root_.get())->children[0];
+            root_ = std::move(child);
+            --depth_;
+        }
+    }
+
+    // count копий value. Все листья и узлы поначалу общие, так что заполнение
+    // стоит O(глубины), а память выделяется по мере записи.
+    void assign(std::size_t count, const T& value) {
+        clear();
+        if (count == 0) return;
+        auto leaf = makeNode<Leaf>();
+        leaf->items.fill(value);
+        std::shared_ptr<void> node = std::move(leaf);
+        while (capacity(depth_) < count) {
+            auto inner = makeNode<Inner>();
+            inner->children.fill(node);
+            node = std::move(inner);
+            ++depth_;
+        }
+        root_ = std::move(node);
+        size_ = count;
+    }
+
+    void clear() noexcept {
+        root_.reset();
+        size_ = 0;
+        depth_ = 0;
+    }
+
+    // Память узлов без учёта того, что часть их разделена с копиями.
+    std::size_t memoryUsage() const noexcept {
+        if (!root_) return 0;
+        std::size_t leaves = (size_ + kLeafSize - 1) >> kLeafBits;
+        std::size_t bytes = leaves * sizeof(Leaf);
+        for (std::size_t nodes = leaves; nodes > 1;) {
+            nodes = (nodes + kBranch - 1) >> kBranchBits;
+            bytes += nodes * sizeof(Inner);
+        }
+        return bytes;
+    }
+
+private:
+    static constexpr std::size_t capacity(unsigned depth) noexcept {
+        return kLeafSize << (kBranchBits * depth);
+    }
+
+    static constexpr std::size_t childIndex(std::size_t i, unsigned level) noexcept {
+        return (i >> (kLeafBits + kBranchBits * (level - 1))) & (kBranch - 1);
+    }
+
+    const T* leafAt(std::size_t i) const noexcept {
+        const void* node = root_.get();
+        // Доски до десятков миллионов задач укладываются в два уровня.
+        switch (depth_) {
+        case 2: node = child(node, i, 2); [[fallthrough]];
+        case 1: node = child(node, i, 1); [[fallthrough]];
+        case 0: break;
+        default:
+            for (unsigned level = depth_; level > 0; --level) node = child(node, i, level);
+        }
+        return static_cast<const Leaf*>(node)->items.data();
+    }
+
+    static const void* child(const void* node, std::size_t i, unsigned level) noexcept {
+        return static_cast<const Inner*>(node)->children[childIndex(i, level)].get();
+    }
+
+    // Узел вместе со счётчиком ссылок — одно выделение из resource_.
+    template <typename Node, typename... Args>
+    std::shared_ptr<Node> makeNode(Args&&... args) const {
+        return std::allocate_shared<Node>(std::pmr::polymorphic_allocator<Node>(resource_),
+                                          std::forward<Args>(args)...);
+    }
+
+    void makeUnique(std::shared_ptr<void>& node, unsigned level) const {
+        if (!node) {
+            if (level == 0) node = makeNode<Leaf>();
+            else node = makeNode<Inner>();
+        } else if (node.use_count() != 1) {
+            if (level == 0) node = makeNode<Leaf>(*static_cast<const Leaf*>(node.get()));
+            else node = makeNode<Inner>(*static_cast<const Inner*>(node.get()));
+        } else {
+            // Последний совладелец мог только что отпустить узел в другом потоке.
+            std::atomic_thread_fence(std::memory_order_acquire);
+        }
+    }
+
+    // Отпускает поддерево, которое начинается с позиции first (она кратна листу).
+    void dropFrom(std::size_t first) {
+        std::shared_ptr<void>* node = &root_;
+        for (unsigned level = depth_; level > 0; --level) {
+            makeUnique(*node, level);
+            std::shared_ptr<void>& child = static_cast<Inner*>(node->get())->children[childIndex(first, level)];
+            std::size_t childSpan = capacity(level - 1);
+            if ((first & (childSpan - 1)) == 0) {
+                child.reset();
+                return;
+            }
+            node = &child;
+        }
+    }
+
+    std::shared_ptr<void> root_;
+    std::size_t size_ = 0;
+    unsigned depth_ = 0;
+    std::pmr::memory_resource* resource_ = std::pmr::get_default_resource();
+};
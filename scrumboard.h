@@ -1,57 +1,346 @@
 #pragma once
-#include <map>
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <iterator>
+#include <memory>
+#include <memory_resource>
+#include <optional>
 #include <stdexcept>
+#include <string>
+#include <type_traits>
 #include <unordered_map>
+#include <utility>
+#include <vector>
+#include "boarderror.h"
+#include "persistentidset.h"
 #include "task.h"
+#include "taskstore.h"
 #include "developer.h"
+#include "boardchange.h"
+#include "memoryaccounting.h"
+#include "metrics.h"
+#include "tracing.h"
 
+struct TaskStatusFailure {
+    int taskId;
+    std::string reason;
+    BoardError error = BoardError::None;
+};
+
+// Память доски. Доска по умолчанию берёт память у ресурсов частей из
+// memoryaccounting.h и возвращает её по мере правок. Доска с allocator
+// берёт всю память у его ресурса, а withArena() — у собственной арены:
+// загрузка не тратит время на кучу, разрушение освобождает арену целиком,
+// а узлы, освобождённые правками, арена выдаёт снова.
+//
+// Ресурс переходит вместе с содержимым: копия и присваивание разделяют узлы
+// с источником, так что копия доски из арены держит арену живой, а
+// дальнейшие правки берут память там же, где лежат узлы. Конструкторы
+// с allocator, наоборот, переписывают содержимое в новый ресурс, если он
+// отличается от ресурса источника. Арена потокобезопасна, поэтому копию
+// доски можно разрушить в фоновом потоке сохранения.
 class ScrumBoard {
 public:
-    ScrumBoard() : nextDeveloperId(1), nextTaskId(1) {}
+    using allocator_type = std::pmr::polymorphic_allocator<std::byte>;
+    using DeveloperList = std::vector<Developer, memory::PropagatingAllocator<Developer>>;
+
+    ScrumBoard()
+        : developers_(&memory::resource(memory::Component::Developers)),
+          developerSlots_(developers_.get_allocator()),
+          sparseDeveloperSlots_(developers_.get_allocator()),
+          nextDeveloperId(1),
+          tasksByStatus_(makeStatusIndexes(&memory::resource(memory::Component::StatusIndex))),
+          nextTaskId(1) {}
+
+    explicit ScrumBoard(const allocator_type& allocator)
+        : developers_(allocator.resource()),
+          developerSlots_(allocator.resource()),
+          sparseDeveloperSlots_(allocator.resource()),
+          nextDeveloperId(1),
+          tasks_(allocator.resource()),
+          tasksByStatus_(makeStatusIndexes(allocator.resource())),
+          nextTaskId(1) {}
+
+    ScrumBoard(const ScrumBoard& other, const allocator_type& allocator) : ScrumBoard(allocator) {
+        copyContents(other);
+    }
+
+    ScrumBoard(ScrumBoard&& other, const allocator_type& allocator) : ScrumBoard(allocator) {
+        if (other.get_allocator() == allocator) assignContents(std::move(other));
+        else copyContents(other);
+    }
+
+    ScrumBoard(const ScrumBoard&) = default;
+    ScrumBoard(ScrumBoard&&) = default;
+
+    ScrumBoard& operator=(const ScrumBoard& other) {
+        if (this != &other) assignContents(other);
+        return *this;
+    }
+
+    ScrumBoard& operator=(ScrumBoard&& other) {
+        if (this != &other) assignContents(std::move(other));
+        return *this;
+    }
+
+    // Пустая доска в собственной арене; initialBytes — первый буфер арены,
+    // например размер загружаемого файла.
+    static ScrumBoard withArena(std::size_t initialBytes = 0) {
+        auto arena = std::make_shared<memory::Arena>(std::max<std::size_t>(initialBytes, kMinArenaBytes));
+        ScrumBoard board{allocator_type(arena.get())};
+        board.arena_ = std::move(arena);
+        return board;
+    }
+
+    // Ресурс, у которого доска берёт память разработчиков; у доски
+    // по умолчанию задачи и индексы лежат в ресурсах своих частей.
+    allocator_type get_allocator() const noexcept { return allocator_type(developers_.get_allocator().resource()); }
+    bool usesArena() const noexcept { return arena_ != nullptr; }
+    // Размер арены доски; 0 у доски без арены. Копии делят арену с оригиналом.
+    std::size_t arenaBytes() const noexcept { return arena_ ? arena_->bytes() : 0; }
 
     void setNextDeveloperId(int next) { nextDeveloperId = next; }
     void setNextTaskId(int next) { nextTaskId = next; }
 
-    void addDeveloper(const Developer& developer) {
-        if (developers_.find(developer.id()) != developers_.end()) {
-            throw std::runtime_error("Разработчик с этим ID уже существует");
-        }
-        developers_.emplace(developer.id(), developer);
+    int subscribe(BoardChangeListener listener) { return listeners_.add(std::move(listener)); }
+    void unsubscribe(int token) { listeners_.remove(token); }
+
+    // Заменяет содержимое доски, сохраняя подписчиков, и сообщает им о сбросе.
+    void replaceWith(ScrumBoard other) {
+        KANBAN_TRACE_SCOPE_ARG("ScrumBoard::replaceWith", "tasks", other.tasks_.size());
+        *this = std::move(other);
+        notify({BoardChange::Kind::Reset});
+    }
+
+    // Возвращает доске сохранённое ранее состояние (копия стоит O(1)) и сообщает
+    // подписчикам changes одним пакетом вместо сброса: changes должны описывать
+    // переход к state. Счётчики ID не убывают, чтобы ID не выдавались повторно.
+    void restoreState(const ScrumBoard& state, const std::vector<BoardChange>& changes) {
+        KANBAN_TRACE_SCOPE_ARG("ScrumBoard::restoreState", "changes", changes.size());
+        int developerId = std::max(nextDeveloperId, state.nextDeveloperId);
+        int taskId = std::max(nextTaskId, state.nextTaskId);
+        *this = state;
+        nextDeveloperId = developerId;
+        nextTaskId = taskId;
+        beginBatch();
+        for (const BoardChange& change : changes) notify(change);
+        endBatch();
+    }
+
+    // Изменения между beginBatch() и endBatch() подписчики могут применить
+    // разом, например одним сбросом модели. Пары можно вкладывать.
+    void beginBatch() { notify({BoardChange::Kind::BatchBegin}); }
+    void endBatch() { notify({BoardChange::Kind::BatchEnd}); }
+
+    // Готовит хранилище под count задач, чтобы массовая загрузка
+    // не перестраивала его по мере роста.
+    void reserveTasks(std::size_t count) { tasks_.reserve(count); }
+
+    // Методы try* делают то же, что одноимённые методы без префикса, но
+    // вместо исключения возвращают причину отказа; при отказе доска
+    // не меняется и подписчики ничего не получают.
+
+    void addDeveloper(const Developer& developer) { throwIfError(tryAddDeveloper(developer)); }
+
+    BoardError tryAddDeveloper(const Developer& developer) {
+        KANBAN_TRACE_SCOPE("ScrumBoard::addDeveloper");
+        if (findDeveloper(developer.id())) return BoardError::DuplicateDeveloper;
+        developers_.push_back(developer);
+        setDeveloperSlot(developer.id(), (int)developers_.size() - 1);
+        notify({BoardChange::Kind::DeveloperAdded, developer.id()});
+        return BoardError::None;
     }
 
-    void addTask(const Task& task) {
-        if (tasks_.find(task.id()) != tasks_.end()) {
-            throw std::runtime_error("Задача с этим ID уже существует");
+    // Принимает и Task, и TaskView: текст копируется сразу в пул строк доски.
+    void addTask(const TaskView& task) { throwIfError(tryAddTask(task)); }
+
+    BoardError tryAddTask(const TaskView& task) {
+        BoardError error = checkNewTask(task, true);
+        if (error != BoardError::None) return error;
+        tasks_.insert(task);
+        indexInsert(task.status(), task.id());
+        notify({BoardChange::Kind::TaskAdded, task.id(), task.status(), task.status()});
+        return BoardError::None;
+    }
+
+    // Добавляет группу задач (Task или TaskView) одним шагом: все проверки,
+    // включая поиск дубликатов, идут одним проходом до первого изменения,
+    // так что при ошибке доска остаётся прежней. Текст копируется в пул
+    // доски, исходные задачи можно освободить сразу после вызова.
+    // Подписчики получают уведомления TaskAdded одним пакетом.
+    template <typename Range>
+    void addTasks(const Range& tasks) { addTasks(std::begin(tasks), std::end(tasks)); }
+
+    // Диапазон обходится несколько раз, итераторы должны быть прямыми.
+    template <typename Iterator>
+    void addTasks(Iterator first, Iterator last) {
+        KANBAN_TRACE_SCOPE("ScrumBoard::addTasks");
+        // Дубликаты внутри группы: возрастающие ID (обычный случай) видны
+        // сразу, иначе ID сортируются. Пустую доску не о чем спрашивать.
+        std::vector<int> ids;
+        bool ascending = true;
+        bool checkExisting = !tasks_.empty();
+        for (Iterator it = first; it != last; ++it) {
+            const TaskView task(*it);
+            throwIfError(checkNewTask(task, checkExisting));
+            if (task.assignedDeveloper()) ensureDeveloperExists(*task.assignedDeveloper());
+            Task::validateStatusTransition(task.status(), task.assignedDeveloper().has_value());
+            if (!ids.empty() && ids.back() >= task.id()) ascending = false;
+            ids.push_back(task.id());
         }
-        tasks_.emplace(task.id(), task);
+        if (ids.empty()) return;
+        if (!ascending) {
+            std::sort(ids.begin(), ids.end());
+            if (std::adjacent_find(ids.begin(), ids.end()) != ids.end()) {
+                throwIfError(BoardError::DuplicateTask);
+            }
+        }
+        std::size_t count = ids.size();
+
+        // Импорт порциями не должен перевыделять хранилище на каждой порции.
+        std::size_t needed = tasks_.size() + count;
+        if (needed > tasks_.capacity()) tasks_.reserve(std::max(needed, tasks_.capacity() * 2));
+
+        std::array<std::vector<int>, kTaskStatusCount> added;
+        for (Iterator it = first; it != last; ++it) {
+            const TaskView task(*it);
+            tasks_.insert(task);
+            added[statusIndex(task.status())].push_back(task.id());
+        }
+        for (std::size_t i = 0; i < kTaskStatusCount; ++i) {
+            if (!added[i].empty()) indexMerge(i, added[i]);
+        }
+
+        beginBatch();
+        for (Iterator it = first; it != last; ++it) {
+            const TaskView task(*it);
+            notify({BoardChange::Kind::TaskAdded, task.id(), task.status(), task.status()});
+        }
+        endBatch();
     }
 
-    void assignTask(int taskId, int developerId) {
-        auto& task = getTask(taskId);
-        ensureDeveloperExists(developerId);
-        task.assignDeveloper(developerId);
+    void assignTask(int taskId, int developerId) { throwIfError(tryAssignTask(taskId, developerId)); }
+
+    BoardError tryAssignTask(int taskId, int developerId) {
+        static metrics::Counter& calls = metrics::counter("board.assign.calls");
+        static metrics::Counter& rejected = metrics::counter("board.assign.rejected");
+        calls.add();
+        TaskStore::Slot slot = tasks_.find(taskId);
+        BoardError error = slot == TaskStore::npos ? BoardError::TaskNotFound
+                           : !findDeveloper(developerId) ? BoardError::DeveloperNotFound
+                           : BoardError::None;
+        if (error != BoardError::None) {
+            rejected.add();
+            return error;
+        }
+        TaskStatus oldStatus = tasks_.status(slot);
+        TaskStatus newStatus = Task::statusAfterAssignment(oldStatus);
+        tasks_.setAssignee(slot, developerId);
+        tasks_.setStatus(slot, newStatus);
+        indexMove(taskId, oldStatus, newStatus);
+        notify({BoardChange::Kind::TaskAssigned, taskId, oldStatus, newStatus});
+        return BoardError::None;
     }
 
     void changeTaskStatus(int taskId, TaskStatus newStatus) {
-        auto& task = getTask(taskId);
-        task.changeStatus(newStatus);
+        throwIfError(tryChangeTaskStatus(taskId, newStatus));
     }
 
-    const Task& getTask(int taskId) const {
-        return tasks_.at(taskId);
+    BoardError tryChangeTaskStatus(int taskId, TaskStatus newStatus) {
+        static metrics::Counter& calls = metrics::counter("board.status_change.calls");
+        static metrics::Counter& rejected = metrics::counter("board.status_change.rejected");
+        calls.add();
+        TaskStore::Slot slot = tasks_.find(taskId);
+        BoardError error = slot == TaskStore::npos ? BoardError::TaskNotFound
+                           : Task::checkStatusTransition(newStatus, tasks_.hasAssignee(slot));
+        if (error != BoardError::None) {
+            rejected.add();
+            return error;
+        }
+        TaskStatus oldStatus = tasks_.status(slot);
+        tasks_.setStatus(slot, newStatus);
+        indexMove(taskId, oldStatus, newStatus);
+        notify({BoardChange::Kind::TaskStatusChanged, taskId, oldStatus, newStatus});
+        return BoardError::None;
+    }
+
+    // Переводит группу задач в один статус. Отклонённые переходы не прерывают
+    // операцию, а возвращаются списком.
+    std::vector<TaskStatusFailure> changeTaskStatuses(const std::vector<int>& taskIds,
+                                                      TaskStatus newStatus) {
+        KANBAN_TRACE_SCOPE_ARG("ScrumBoard::changeTaskStatuses", "tasks", taskIds.size());
+        std::vector<TaskStatusFailure> failures;
+        beginBatch();
+        for (int taskId : taskIds) {
+            BoardError error = tryChangeTaskStatus(taskId, newStatus);
+            if (error != BoardError::None) failures.push_back({taskId, boardErrorMessage(error), error});
+        }
+        endBatch();
+        return failures;
+    }
+
+    std::optional<TaskView> findTask(int taskId) const {
+        TaskStore::Slot slot = tasks_.find(taskId);
+        if (slot == TaskStore::npos) return std::nullopt;
+        return tasks_.view(slot);
+    }
+
+    TaskView getTask(int taskId) const {
+        return tasks_.view(requireTaskSlot(taskId));
     }
 
     const Developer& getDeveloper(int developerId) const {
-        return developers_.at(developerId);
+        const Developer* developer = findDeveloper(developerId);
+        if (!developer) {
+            throw std::out_of_range("Разработчик не найден");
+        }
+        return *developer;
+    }
+
+    const Developer* findDeveloper(int developerId) const {
+        int slot = developerSlot(developerId);
+        return slot >= 0 ? &developers_[(size_t)slot] : nullptr;
     }
 
+    // Задачи удаляемого разработчика остаются без исполнителя: назначенные
+    // и начатые возвращаются в Backlog, остальные сохраняют статус. Снимок
+    // и журнал не должны ссылаться на несуществующего разработчика.
     void removeDeveloper(int id) {
-        auto it = developers_.find(id);
-        if (it != developers_.end()) {
-            developers_.erase(it);
-        } else {
+        KANBAN_TRACE_SCOPE("ScrumBoard::removeDeveloper");
+        int slot = developerSlot(id);
+        if (slot < 0) {
             throw std::runtime_error("Разработчик не найден");
         }
+
+        std::vector<TaskStore::Slot> owned;
+        TaskStore::Slot task = 0;
+        for (int assignee : tasks_.assignees()) {
+            if (assignee == id) owned.push_back(task);
+            ++task;
+        }
+
+        beginBatch();
+        for (TaskStore::Slot owner : owned) {
+            TaskStatus oldStatus = tasks_.status(owner);
+            TaskStatus newStatus = Task::checkStatusTransition(oldStatus, false) == BoardError::None
+                                       ? oldStatus : TaskStatus::Backlog;
+            tasks_.setAssignee(owner, TaskStore::kNoDeveloper);
+            tasks_.setStatus(owner, newStatus);
+            indexMove(tasks_.id(owner), oldStatus, newStatus);
+            // И при прежнем статусе: история отмены вернёт задаче исполнителя.
+            notify({BoardChange::Kind::TaskStatusChanged, tasks_.id(owner), oldStatus, newStatus});
+        }
+
+        // Удаление перестановкой последнего элемента на место удаляемого.
+        if ((size_t)slot + 1 != developers_.size()) {
+            developers_[(size_t)slot] = std::move(developers_.back());
+            setDeveloperSlot(developers_[(size_t)slot].id(), slot);
+        }
+        developers_.pop_back();
+        setDeveloperSlot(id, -1);
+        notify({BoardChange::Kind::DeveloperRemoved, id});
+        endBatch();
     }
 
     int getNextDeveloperId() {
@@ -63,36 +352,160 @@ public:
     }
 
     void removeTask(int taskId) {
-        auto it = tasks_.find(taskId);
-        if (it == tasks_.end()) {
+        if (tryRemoveTask(taskId) != BoardError::None) {
             throw std::runtime_error("Задача не найдена");
         }
-        tasks_.erase(it);
     }
 
-    Task& getTask(int taskId) {
-        auto it = tasks_.find(taskId);
-        if (it == tasks_.end()) {
-            throw std::out_of_range("Задача не найдена");
-        }
-        return it->second;
+    BoardError tryRemoveTask(int taskId) {
+        TaskStore::Slot slot = tasks_.find(taskId);
+        if (slot == TaskStore::npos) return BoardError::TaskNotFound;
+        TaskStatus oldStatus = tasks_.status(slot);
+        tasks_.erase(slot);
+        indexErase(oldStatus, taskId);
+        notify({BoardChange::Kind::TaskRemoved, taskId, oldStatus, oldStatus});
+        return BoardError::None;
+    }
+
+    const DeveloperList& getAllDevelopers() const { return developers_; }
+    // Обход в порядке хранения, не по ID.
+    const TaskStore& getAllTasks() const { return tasks_; }
+
+    // ID задач с данным статусом в порядке возрастания (копия).
+    std::vector<int> getTaskIdsByStatus(TaskStatus status) const {
+        return tasksByStatus_[statusIndex(status)].toVector();
+    }
+
+    // То же без копии: обход по возрастанию ID.
+    const PersistentIdSet& taskIdsByStatus(TaskStatus status) const {
+        return tasksByStatus_[statusIndex(status)];
+    }
+
+    std::size_t countTasks(TaskStatus status) const {
+        return tasksByStatus_[statusIndex(status)].size();
     }
 
-    const std::unordered_map<int, Developer>& getAllDevelopers() const { return developers_; }
-    const std::map<int, Task>& getAllTasks() const { return tasks_; }
     int peekNextDeveloperId() const { return nextDeveloperId; }
     int peekNextTaskId() const { return nextTaskId; }
 
 private:
-    std::unordered_map<int, Developer> developers_;
+    static constexpr std::size_t kMinArenaBytes = 64 * 1024;
+
+    // Объявлена первой, чтобы разрушаться последней: её память нужна
+    // всем остальным полям.
+    std::shared_ptr<memory::Arena> arena_;
+
+    // Разработчики лежат подряд; ID -> позиция ищется в плотном массиве,
+    // а редкие большие или отрицательные ID уходят в хеш-таблицу.
+    DeveloperList developers_;
+    std::vector<int, memory::PropagatingAllocator<int>> developerSlots_;
+    std::unordered_map<int, int, std::hash<int>, std::equal_to<int>,
+                       memory::PropagatingAllocator<std::pair<const int, int>>> sparseDeveloperSlots_;
     int nextDeveloperId;
 
-    std::map<int, Task> tasks_;
+    TaskStore tasks_;
+    std::array<PersistentIdSet, kTaskStatusCount> tasksByStatus_;
     int nextTaskId;
 
-    void ensureDeveloperExists(int developerId) const {
-        if (developers_.find(developerId) == developers_.end()) {
-            throw std::out_of_range("Разработчик не найден");
+    BoardChangeListeners listeners_;
+
+    void notify(const BoardChange& change) const { listeners_.notify(change); }
+
+    static std::array<PersistentIdSet, kTaskStatusCount> makeStatusIndexes(std::pmr::memory_resource* resource) {
+        std::array<PersistentIdSet, kTaskStatusCount> indexes;
+        for (PersistentIdSet& index : indexes) index = PersistentIdSet(resource);
+        return indexes;
+    }
+
+    // Всё, кроме подписчиков. Старое содержимое возвращает память своей
+    // арене, поэтому прежняя арена отпускается только после него; при
+    // перемещении содержимое может уйти в other и арена уходит следом.
+    template <typename Board>
+    void assignContents(Board&& other) {
+        std::shared_ptr<memory::Arena> previous = arena_;
+        arena_ = other.arena_;
+        developers_ = std::forward<Board>(other).developers_;
+        developerSlots_ = std::forward<Board>(other).developerSlots_;
+        sparseDeveloperSlots_ = std::forward<Board>(other).sparseDeveloperSlots_;
+        nextDeveloperId = other.nextDeveloperId;
+        tasks_ = std::forward<Board>(other).tasks_;
+        tasksByStatus_ = std::forward<Board>(other).tasksByStatus_;
+        nextTaskId = other.nextTaskId;
+        if constexpr (!std::is_lvalue_reference_v<Board>) other.arena_ = std::move(previous);
+    }
+
+    // Переписывает содержимое в ресурсы этой доски, узлы не разделяются.
+    void copyContents(const ScrumBoard& other) {
+        developers_.reserve(other.developers_.size());
+        for (const Developer& developer : other.developers_) developers_.push_back(developer);
+        developerSlots_.assign(other.developerSlots_.begin(), other.developerSlots_.end());
+        sparseDeveloperSlots_.insert(other.sparseDeveloperSlots_.begin(), other.sparseDeveloperSlots_.end());
+        nextDeveloperId = other.nextDeveloperId;
+
+        tasks_.reserve(other.tasks_.size());
+        for (const TaskView& task : other.tasks_) tasks_.insert(task);
+        for (std::size_t i = 0; i < kTaskStatusCount; ++i) {
+            tasksByStatus_[i].insertSorted(other.tasksByStatus_[i].toVector());
         }
+        nextTaskId = other.nextTaskId;
+    }
+
+    TaskStore::Slot requireTaskSlot(int taskId) const {
+        TaskStore::Slot slot = tasks_.find(taskId);
+        if (slot == TaskStore::npos) {
+            throw std::out_of_range("Задача не найдена");
+        }
+        return slot;
+    }
+
+    void indexInsert(TaskStatus status, int taskId) {
+        tasksByStatus_[statusIndex(status)].insert(taskId);
+    }
+
+    void indexMerge(std::size_t status, std::vector<int>& ids) {
+        if (!std::is_sorted(ids.begin(), ids.end())) std::sort(ids.begin(), ids.end());
+        tasksByStatus_[status].insertSorted(ids);
+    }
+
+    void indexErase(TaskStatus status, int taskId) {
+        tasksByStatus_[statusIndex(status)].erase(taskId);
+    }
+
+    void indexMove(int taskId, TaskStatus from, TaskStatus to) {
+        if (from == to) return;
+        indexErase(from, taskId);
+        indexInsert(to, taskId);
+    }
+
+    int developerSlot(int id) const {
+        if (id >= 0 && (size_t)id < developerSlots_.size() && developerSlots_[(size_t)id] >= 0) {
+            return developerSlots_[(size_t)id];
+        }
+        if (sparseDeveloperSlots_.empty()) return -1;
+        auto it = sparseDeveloperSlots_.find(id);
+        return it != sparseDeveloperSlots_.end() ? it->second : -1;
+    }
+
+    void setDeveloperSlot(int id, int slot) {
+        size_t denseLimit = 4 * (developers_.size() + 16);
+        if (id >= 0 && ((size_t)id < developerSlots_.size() || (size_t)id < denseLimit)) {
+            if ((size_t)id >= developerSlots_.size()) developerSlots_.resize((size_t)id + 1, -1);
+            developerSlots_[(size_t)id] = slot;
+            sparseDeveloperSlots_.erase(id);
+        } else if (slot >= 0) {
+            sparseDeveloperSlots_[id] = slot;
+        } else {
+            sparseDeveloperSlots_.erase(id);
+        }
+    }
+
+    void ensureDeveloperExists(int developerId) const {
+        if (!findDeveloper(developerId)) throwIfError(BoardError::DeveloperNotFound);
+    }
+
+    BoardError checkNewTask(const TaskView& task, bool checkExisting) const {
+        if (task.title().empty()) return BoardError::EmptyTitle;
+        if (checkExisting && tasks_.contains(task.id())) return BoardError::DuplicateTask;
+        return BoardError::None;
     }
 };
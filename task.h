@@ -1,15 +1,22 @@
 #pragma once
+#include <memory_resource>
 #include <string>
+#include <string_view>
 #include <optional>
 #include <stdexcept>
+#include "boarderror.h"
 #include "taskstatus.h"
 
+// Задача вне доски: для импорта и пакетного добавления. Текст лежит
+// в ресурсе памяти задачи, например в арене пакета.
 class Task {
 public:
-    Task(int id, std::string title, std::string description)
+    using allocator_type = std::pmr::polymorphic_allocator<char>;
+
+    Task(int id, std::string_view title, std::string_view description, const allocator_type& allocator = {})
         : id_(id),
-        title_(std::move(title)),
-        description_(std::move(description)),
+        title_(title, allocator),
+        description_(description, allocator),
         status_(TaskStatus::Backlog)
     {
         if (title_.empty()) {
@@ -17,9 +24,32 @@ public:
         }
     }
 
+    Task(const Task& other, const allocator_type& allocator)
+        : id_(other.id_),
+        title_(other.title_, allocator),
+        description_(other.description_, allocator),
+        status_(other.status_),
+        assignedDeveloperId_(other.assignedDeveloperId_)
+    {}
+
+    Task(Task&& other, const allocator_type& allocator)
+        : id_(other.id_),
+        title_(std::move(other.title_), allocator),
+        description_(std::move(other.description_), allocator),
+        status_(other.status_),
+        assignedDeveloperId_(other.assignedDeveloperId_)
+    {}
+
+    Task(const Task&) = default;
+    Task(Task&&) = default;
+    Task& operator=(const Task&) = default;
+    Task& operator=(Task&&) = default;
+
+    allocator_type get_allocator() const { return title_.get_allocator(); }
+
     int id() const noexcept { return id_; }
-    const std::string& title() const noexcept { return title_; }
-    const std::string& description() const noexcept { return description_; }
+    const std::pmr::string& title() const noexcept { return title_; }
+    const std::pmr::string& description() const noexcept { return description_; }
     TaskStatus status() const noexcept { return status_; }
 
     const std::optional<int>& assignedDeveloper() const noexcept {
@@ -28,31 +58,77 @@ public:
 
     void assignDeveloper(int developerId) {
         assignedDeveloperId_ = developerId;
-
-        if (status_ == TaskStatus::Backlog) {
-            status_ = TaskStatus::Assigned;
-        }
+        status_ = statusAfterAssignment(status_);
     }
 
     void changeStatus(TaskStatus newStatus) {
-        validateStatusTransition(newStatus);
-        status_ = newStatus;
+        throwIfError(tryChangeStatus(newStatus));
     }
 
-private:
-    void validateStatusTransition(TaskStatus newStatus) const {
+    // Как changeStatus, но отказ возвращается, а не выбрасывается.
+    BoardError tryChangeStatus(TaskStatus newStatus) noexcept {
+        BoardError error = checkStatusTransition(newStatus, assignedDeveloperId_.has_value());
+        if (error == BoardError::None) status_ = newStatus;
+        return error;
+    }
+
+    // Правила переходов общие для Task и для хранилища задач доски.
+    static TaskStatus statusAfterAssignment(TaskStatus status) {
+        return status == TaskStatus::Backlog ? TaskStatus::Assigned : status;
+    }
+
+    static BoardError checkStatusTransition(TaskStatus newStatus, bool hasDeveloper) noexcept {
         if ((newStatus == TaskStatus::Assigned ||
              newStatus == TaskStatus::InProgress) &&
-            !assignedDeveloperId_) {
-            throw std::logic_error(
-                "Для перемещения задачи в выполнение назначьте сначала разработчика");
+            !hasDeveloper) {
+            return BoardError::DeveloperRequired;
         }
+        return BoardError::None;
+    }
+
+    static void validateStatusTransition(TaskStatus newStatus, bool hasDeveloper) {
+        throwIfError(checkStatusTransition(newStatus, hasDeveloper));
     }
 
 private:
     int id_;
-    std::string title_;
-    std::string description_;
+    std::pmr::string title_;
+    std::pmr::string description_;
+    TaskStatus status_;
+    std::optional<int> assignedDeveloperId_;
+};
+
+// Лёгкое представление задачи: горячие поля по значению, текст — ссылками
+// на хранилище. Действительно до следующего изменения доски.
+class TaskView {
+public:
+    TaskView(int id,
+             std::string_view title,
+             std::string_view description,
+             TaskStatus status,
+             std::optional<int> assignedDeveloperId)
+        : id_(id),
+        title_(title),
+        description_(description),
+        status_(status),
+        assignedDeveloperId_(assignedDeveloperId)
+    {}
+
+    TaskView(const Task& task)
+        : TaskView(task.id(), task.title(), task.description(),
+                   task.status(), task.assignedDeveloper())
+    {}
+
+    int id() const noexcept { return id_; }
+    std::string_view title() const noexcept { return title_; }
+    std::string_view description() const noexcept { return description_; }
+    TaskStatus status() const noexcept { return status_; }
+    std::optional<int> assignedDeveloper() const noexcept { return assignedDeveloperId_; }
+
+private:
+    int id_;
+    std::string_view title_;
+    std::string_view description_;
     TaskStatus status_;
     std::optional<int> assignedDeveloperId_;
 };
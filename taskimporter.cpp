@@ -0,0 +1,356 @@
+#include "taskimporter.h"
+#include "boardserializer.h"
+#include "taskutils.h"
+#include <nlohmann/json.hpp>
+#include <algorithm>
+#include <charconv>
+#include <cstdint>
+#include <limits>
+#include <istream>
+#include <optional>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace {
+
+std::runtime_error lineError(std::size_t line, const std::string& message)
+{
+    return std::runtime_error("Строка " + std::to_string(line) + ": " + message);
+}
+
+std::optional<int> parseOptionalId(std::string_view text, const char* what)
+{
+    if (text.empty()) return std::nullopt;
+    int value = 0;
+    auto [end, ec] = std::from_chars(text.data(), text.data() + text.size(), value);
+    if (ec != std::errc() || end != text.data() + text.size()) {
+        throw std::runtime_error(std::string("Некорректный ") + what + ": " + std::string(text));
+    }
+    return value;
+}
+
+TaskStatus parseStatus(const std::string& text)
+{
+    if (text.empty()) return TaskStatus::Backlog;
+    try {
+        return stringToTaskStatus(text);
+    } catch (const std::exception&) {
+        throw std::runtime_error("Неизвестный статус задачи: " + text);
+    }
+}
+
+struct ImportedRow {
+    std::optional<int> id;
+    std::string title;
+    std::string description;
+    TaskStatus status = TaskStatus::Backlog;
+    std::optional<int> assignee;
+};
+
+// Копит разобранные строки и отдаёт их доске порциями. Строки порции
+// переиспользуются, так что их буферы выделяются только в первой порции.
+class ImportBatch {
+public:
+    explicit ImportBatch(ScrumBoard& board) : board_(board) {
+        rows_.reserve(kImportBatchSize);
+        views_.reserve(kImportBatchSize);
+    }
+
+    // Место под следующую строку входа.
+    ImportedRow& next(std::size_t line) {
+        if (used_ == 0) firstLine_ = line;
+        lastLine_ = line;
+        if (used_ == rows_.size()) rows_.emplace_back();
+        return rows_[used_++];
+    }
+
+    // Проверки, которые можно сделать по одной строке, — с её номером.
+    void check(const ImportedRow& row) {
+        try {
+            if (row.title.empty()) {
+                throw std::invalid_argument("Название задачи не может быть пустым");
+            }
+            if (!isValidUtf8(row.title) || !isValidUtf8(row.description)) {
+                throw std::invalid_argument("Текст задачи не в кодировке UTF-8");
+            }
+            Task::validateStatusTransition(row.status, row.assignee.has_value());
+        } catch (const std::exception& e) {
+            throw lineError(lastLine_, e.what());
+        }
+        if (used_ == kImportBatchSize) flush();
+    }
+
+    void flush() {
+        if (used_ == 0) return;
+        views_.clear();
+        // Сначала ID, заданные в самой порции: пустой ID не должен их занять.
+        explicitIds_.clear();
+        for (std::size_t i = 0; i < used_; ++i) {
+            if (rows_[i].id) explicitIds_.push_back(*rows_[i].id);
+        }
+        std::sort(explicitIds_.begin(), explicitIds_.end());
+        for (std::size_t i = 0; i < used_; ++i) {
+            const ImportedRow& row = rows_[i];
+            int id = row.id ? *row.id : freeTaskId();
+            if (id > maxId_) maxId_ = id;
+            views_.emplace_back(id, row.title, row.description, row.status, row.assignee);
+        }
+        try {
+            board_.addTasks(views_);
+        } catch (const std::exception& e) {
+            throw std::runtime_error("Строки " + std::to_string(firstLine_) + "-" +
+                                     std::to_string(lastLine_) + ": " + e.what());
+        }
+        imported_ += used_;
+        used_ = 0;
+        // Порция уже на доске, даже если следующая не добавится.
+        if (maxId_ >= board_.peekNextTaskId()) board_.setNextTaskId(maxId_ + 1);
+    }
+
+    std::size_t finish() {
+        flush();
+        return imported_;
+    }
+
+private:
+    // Счётчик доски не обязан быть больше уже занятых ID.
+    int freeTaskId() {
+        int id = board_.getNextTaskId();
+        while (board_.findTask(id) || std::binary_search(explicitIds_.begin(), explicitIds_.end(), id)) {
+            id = board_.getNextTaskId();
+        }
+        return id;
+    }
+
+    ScrumBoard& board_;
+    std::vector<ImportedRow> rows_;
+    std::vector<TaskView> views_;
+    std::vector<int> explicitIds_;
+    std::size_t used_ = 0;
+    std::size_t imported_ = 0;
+    int maxId_ = 0;
+    std::size_t firstLine_ = 0;
+    std::size_t lastLine_ = 0;
+};
+
+constexpr int kEof = std::char_traits<char>::eof();
+
+// Читает CSV по записям прямо из буфера потока. Запись может занимать
+// несколько строк файла, если перевод строки стоит внутри кавычек.
+class CsvReader {
+public:
+    explicit CsvReader(std::istream& in) : buffer_(*in.rdbuf()) {}
+
+    // Заполняет первые count полей; false, если записи кончились.
+    bool next(std::vector<std::string>& fields, std::size_t& count) {
+        int c = buffer_.sbumpc();
+        if (c == kEof) return false;
+        recordLine_ = ++line_;
+        count = 0;
+        for (;;) {
+            if (count == fields.size()) fields.emplace_back();
+            std::string& field = fields[count++];
+            field.clear();
+            if (c == '"') {
+                for (;;) {
+                    c = buffer_.sbumpc();
+                    if (c == kEof) throw lineError(recordLine_, "не закрыта кавычка");
+                    if (c == '"') {
+                        if (buffer_.sgetc() != '"') break;
+                        buffer_.sbumpc();
+                    } else if (c == '\n') {
+                        ++line_;
+                    }
+                    field.push_back((char)c);
+                }
+                c = buffer_.sbumpc();
+                if (c != ',' && c != '\r' && c != '\n' && c != kEof) {
+                    throw lineError(line_, "после закрывающей кавычки ожидается запятая");
+                }
+            } else {
+                while (c != ',' && c != '\r' && c != '\n' && c != kEof) {
+                    field.push_back((char)c);
+                    c = buffer_.sbumpc();
+                }
+            }
+            if (c != ',') break;
+            c = buffer_.sbumpc();
+        }
+        if (c == '\r' && buffer_.sgetc() == '\n') buffer_.sbumpc();
+        return true;
+    }
+
+    // Строка файла, с которой началась последняя запись.
+    std::size_t recordLine() const noexcept { return recordLine_; }
+
+private:
+    std::streambuf& buffer_;
+    std::size_t line_ = 0;
+    std::size_t recordLine_ = 0;
+};
+
+// Разбирает строку JSON Lines событиями SAX прямо в ImportedRow, без DOM.
+// Вложенные значения и лишние ключи пропускаются.
+class JsonLineReader : public nlohmann::json_sax<nlohmann::json> {
+public:
+    // Заполняет row; ошибки выбрасываются без номера строки.
+    void read(const std::string& text, ImportedRow& row) {
+        row_ = &row;
+        row.id.reset();
+        row.assignee.reset();
+        row.title.clear();
+        row.description.clear();
+        row.status = TaskStatus::Backlog;
+        depth_ = 0;
+        topLevelObject_ = false;
+        hasTitle_ = false;
+        if (!nlohmann::json::sax_parse(text, this)) throw std::runtime_error(error_);
+        if (!topLevelObject_) throw std::runtime_error("ожидается JSON-объект");
+        if (!hasTitle_) throw std::runtime_error("нет поля title");
+    }
+
+    bool null() override { return true; }
+    bool boolean(bool) override { return true; }
+    bool number_integer(number_integer_t v) override { return integer(v); }
+
+    bool number_unsigned(number_unsigned_t v) override {
+        return integer((std::int64_t)std::min<number_unsigned_t>(v, std::numeric_limits<std::int64_t>::max()));
+    }
+
+    bool number_float(number_float_t, const string_t&) override { return true; }
+
+    bool string(string_t& v) override {
+        if (depth_ != 1) return true;
+        if (key_ == "title") {
+            row_->title.swap(v);
+            hasTitle_ = true;
+        } else if (key_ == "description") {
+            row_->description.swap(v);
+        } else if (key_ == "status") {
+            row_->status = parseStatus(v);
+        }
+        return true;
+    }
+
+    bool binary(binary_t&) override { return true; }
+
+    bool start_object(std::size_t) override {
+        if (depth_ == 0) topLevelObject_ = true;
+        ++depth_;
+        return true;
+    }
+
+    bool key(string_t& k) override {
+        if (depth_ == 1) key_.swap(k);
+        return true;
+    }
+
+    bool end_object() override { --depth_; return true; }
+    bool start_array(std::size_t) override { ++depth_; return true; }
+    bool end_array() override { --depth_; return true; }
+
+    bool parse_error(std::size_t, const std::string&, const nlohmann::detail::exception& ex) override {
+        error_ = ex.what();
+        return false;
+    }
+
+private:
+    bool integer(std::int64_t v) {
+        if (depth_ != 1 || (key_ != "id" && key_ != "assignedDeveloperId")) return true;
+        if (v < std::numeric_limits<int>::min() || v > std::numeric_limits<int>::max()) {
+            throw std::runtime_error("Некорректный ID: " + key_);
+        }
+        if (key_ == "id") row_->id = (int)v;
+        else row_->assignee = (int)v;
+        return true;
+    }
+
+    ImportedRow* row_ = nullptr;
+    int depth_ = 0;
+    bool topLevelObject_ = false;
+    bool hasTitle_ = false;
+    std::string key_;
+    std::string error_;
+};
+
+constexpr std::size_t kNoColumn = SIZE_MAX;
+
+} // namespace
+
+std::size_t importTasksFromCsv(ScrumBoard& board, std::istream& in)
+{
+    CsvReader reader(in);
+    std::vector<std::string> fields;
+    std::size_t count = 0;
+    if (!reader.next(fields, count)) return 0;
+
+    // Excel начинает UTF-8 файл с BOM.
+    if (fields[0].compare(0, 3, "\xEF\xBB\xBF") == 0) fields[0].erase(0, 3);
+    std::size_t idColumn = kNoColumn, titleColumn = kNoColumn, descriptionColumn = kNoColumn;
+    std::size_t statusColumn = kNoColumn, assigneeColumn = kNoColumn;
+    for (std::size_t i = 0; i < count; ++i) {
+        if (fields[i] == "id") idColumn = i;
+        else if (fields[i] == "title") titleColumn = i;
+        else if (fields[i] == "description") descriptionColumn = i;
+        else if (fields[i] == "status") statusColumn = i;
+        else if (fields[i] == "assignee") assigneeColumn = i;
+    }
+    if (titleColumn == kNoColumn) {
+        throw lineError(reader.recordLine(), "в заголовке CSV нет столбца title");
+    }
+
+    std::size_t columns = count;
+    std::string missing;
+    ImportBatch batch(board);
+    while (reader.next(fields, count)) {
+        if (count == 1 && fields[0].empty()) continue;   // пустая строка
+        std::size_t line = reader.recordLine();
+        ImportedRow& row = batch.next(line);
+        // Короткая запись: недостающие поля пустые.
+        for (std::size_t i = count; i < columns; ++i) {
+            if (i == fields.size()) fields.emplace_back();
+            fields[i].clear();
+        }
+        missing.clear();
+        auto field = [&](std::size_t column) -> std::string& {
+            return column == kNoColumn ? missing : fields[column];
+        };
+        try {
+            row.id = parseOptionalId(field(idColumn), "ID задачи");
+            row.assignee = parseOptionalId(field(assigneeColumn), "ID разработчика");
+            row.status = parseStatus(field(statusColumn));
+        } catch (const std::exception& e) {
+            throw lineError(line, e.what());
+        }
+        row.title.swap(field(titleColumn));
+        row.description.swap(field(descriptionColumn));
+        if (row.assignee) row.status = Task::statusAfterAssignment(row.status);
+        batch.check(row);
+    }
+    return batch.finish();
+}
+
+std::size_t importTasksFromJsonLines(ScrumBoard& board, std::istream& in)
+{
+    ImportBatch batch(board);
+    JsonLineReader reader;
+    std::string text;
+    std::size_t line = 0;
+    while (std::getline(in, text)) {
+        ++line;
+        if (!text.empty() && text.back() == '\r') text.pop_back();
+        if (text.find_first_not_of(" \t") == std::string::npos) continue;
+
+        ImportedRow& row = batch.next(line);
+        try {
+            reader.read(text, row);
+        } catch (const std::exception& e) {
+            throw lineError(line, e.what());
+        }
+        if (row.assignee) row.status = Task::statusAfterAssignment(row.status);
+        batch.check(row);
+    }
+    return batch.finish();
+}
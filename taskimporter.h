@@ -0,0 +1,27 @@
+#pragma once
+#include <cstddef>
+#include <iosfwd>
+#include "scrumboard.h"
+
+// Потоковый импорт задач из других трекеров. Вход читается по одной записи,
+// задачи добавляются на доску порциями по kImportBatchSize через
+// ScrumBoard::addTasks, поэтому файл целиком в памяти не держится.
+//
+// Пустой ID заменяется следующим свободным ID доски. Задача с исполнителем
+// и статусом Backlog становится Assigned, как после assignTask.
+// Текст задач должен быть в UTF-8, как в файле доски.
+// Ошибки выбрасываются как std::runtime_error с номером строки. Порция
+// добавляется целиком или не добавляется вовсе, но порции до ошибки
+// остаются на доске, и счётчик ID доски идёт после них. Функции
+// возвращают число добавленных задач.
+
+constexpr std::size_t kImportBatchSize = 4096;
+
+// Первая запись — заголовок. Обязателен столбец title; id, description,
+// status и assignee необязательны, остальные столбцы пропускаются.
+// Поля в кавычках могут содержать запятые, "" и переводы строк (RFC 4180).
+std::size_t importTasksFromCsv(ScrumBoard& board, std::istream& in);
+
+// Один JSON-объект на строку с ключами файла доски: id, title,
+// description, status, assignedDeveloperId.
+std::size_t importTasksFromJsonLines(ScrumBoard& board, std::istream& in);
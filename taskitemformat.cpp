@@ -1,17 +1,72 @@
 #include "taskitemformat.h"
 #include "scrumboard.h"   // где объявлен ScrumBoard
-#include "task.h"         // где объявлен Task
+#include "task.h"         // где объявлен TaskView
+#include "memoryaccounting.h"
+#include "tracing.h"
 #include <vector>
 
 namespace TaskItemFormat {
 
-QString developerNameById(const ScrumBoard& board, int devId) {
-    for (const auto& [id, dev] : board.getAllDevelopers()) {
-        if (id == devId) return QString::fromStdString(dev.name());
-    }
+static QString fromUtf8View(std::string_view text) {
+    return QString::fromUtf8(text.data(), (qsizetype)text.size());
+}
+
+static QString unknownDeveloperName(int devId) {
     return QString("ID %1").arg(devId);
 }
 
+DeveloperNameCache::DeveloperNameCache(ScrumBoard& board)
+    : m_board(board),
+      m_names(&memory::resource(memory::Component::View))
+{
+    m_subscription = m_board.subscribe([this](const BoardChange& change) {
+        onBoardChanged(change);
+    });
+}
+
+DeveloperNameCache::~DeveloperNameCache() {
+    m_board.unsubscribe(m_subscription);
+}
+
+QString DeveloperNameCache::nameById(int devId) const {
+    if (devId < 0) return developerNameById(m_board, devId);
+
+    size_t slot = (size_t)devId;
+    if (slot < m_names.size() && !m_names[slot].isNull()) return m_names[slot];
+
+    const Developer* dev = m_board.findDeveloper(devId);
+    if (!dev) return unknownDeveloperName(devId);
+
+    // Кешируем только ID из плотного диапазона, как и сама доска.
+    if (slot < 4 * (m_board.getAllDevelopers().size() + 16)) {
+        if (slot >= m_names.size()) m_names.resize(slot + 1);
+        m_names[slot] = fromUtf8View(dev->name());
+        return m_names[slot];
+    }
+    return fromUtf8View(dev->name());
+}
+
+void DeveloperNameCache::onBoardChanged(const BoardChange& change) {
+    switch (change.kind) {
+    case BoardChange::Kind::DeveloperAdded:
+    case BoardChange::Kind::DeveloperRemoved:
+        if (change.id >= 0 && (size_t)change.id < m_names.size())
+            m_names[(size_t)change.id] = QString();
+        break;
+    case BoardChange::Kind::Reset:
+        m_names.clear();
+        break;
+    default:
+        break;
+    }
+}
+
+QString developerNameById(const ScrumBoard& board, int devId) {
+    const Developer* dev = board.findDeveloper(devId);
+    if (dev) return fromUtf8View(dev->name());
+    return unknownDeveloperName(devId);
+}
+
 int extractTaskId(const QString& itemText) {
     int l = itemText.indexOf('[');
     int r = itemText.indexOf(']');
@@ -21,13 +76,13 @@ int extractTaskId(const QString& itemText) {
     return ok ? id : -1;
 }
 
-QString makeTitleLine(const ScrumBoard& board, const Task& task) {
+static QString composeTitleLine(const TaskView& task, const QString* developerName) {
     QString text = QString("[%1] %2")
     .arg(task.id())
-        .arg(QString::fromStdString(task.title()));
+        .arg(fromUtf8View(task.title()));
 
-    if (task.assignedDeveloper()) {
-        text += QString(" (%1)").arg(developerNameById(board, *task.assignedDeveloper()));
+    if (developerName) {
+        text += QString(" (%1)").arg(*developerName);
     } else {
         text += " (не назначен)";
     }
@@ -39,8 +94,22 @@ QString makeTitleLine(const ScrumBoard& board, const Task& task) {
     return text;
 }
 
-QString makeTooltip(const Task& task) {
-    QString descr = QString::fromStdString(task.description()).trimmed();
+QString makeTitleLine(const ScrumBoard& board, const TaskView& task) {
+    KANBAN_TRACE_SCOPE("makeTitleLine");
+    if (!task.assignedDeveloper()) return composeTitleLine(task, nullptr);
+    QString name = developerNameById(board, *task.assignedDeveloper());
+    return composeTitleLine(task, &name);
+}
+
+QString makeTitleLine(const DeveloperNameCache& names, const TaskView& task) {
+    KANBAN_TRACE_SCOPE("makeTitleLine");
+    if (!task.assignedDeveloper()) return composeTitleLine(task, nullptr);
+    QString name = names.nameById(*task.assignedDeveloper());
+    return composeTitleLine(task, &name);
+}
+
+QString makeTooltip(const TaskView& task) {
+    QString descr = fromUtf8View(task.description()).trimmed();
     if (descr.isEmpty()) return "Описание задачи: отсутствует";
     return QString("Описание задачи: %1").arg(descr);
 }
@@ -1,13 +1,40 @@
 #pragma once
 #include <QString>
+#include <memory_resource>
+#include <vector>
 
 class ScrumBoard;
-class Task;
+class TaskView;
+struct BoardChange;
 
 namespace TaskItemFormat {
+
+// Имена разработчиков, уже переведённые в QString: строка строится один раз
+// на разработчика и сбрасывается при его удалении или перезагрузке доски.
+// Таблица учитывается в memory::Component::View, сами строки QString — нет:
+// их выделяет Qt.
+class DeveloperNameCache {
+public:
+    explicit DeveloperNameCache(ScrumBoard& board);
+    ~DeveloperNameCache();
+
+    DeveloperNameCache(const DeveloperNameCache&) = delete;
+    DeveloperNameCache& operator=(const DeveloperNameCache&) = delete;
+
+    QString nameById(int devId) const;
+
+private:
+    void onBoardChanged(const BoardChange& change);
+
+    ScrumBoard& m_board;
+    int m_subscription = 0;
+    mutable std::pmr::vector<QString> m_names;
+};
+
 QString developerNameById(const ScrumBoard& board, int devId);
 int extractTaskId(const QString& itemText);
 
-QString makeTitleLine(const ScrumBoard& board, const ::Task& task);
-QString makeTooltip(const ::Task& task);
+QString makeTitleLine(const ScrumBoard& board, const ::TaskView& task);
+QString makeTitleLine(const DeveloperNameCache& names, const ::TaskView& task);
+QString makeTooltip(const ::TaskView& task);
 }
@@ -0,0 +1,470 @@
+#include "tasksearchindex.h"
+#include <algorithm>
+#include <utility>
+
+namespace {
+
+// Длиннее слова обрезаются: искать по ним всё равно будут по началу.
+constexpr std::size_t kMaxTokenBytes = 64;
+// Новые слова ищутся перебором, пока их меньше этой границы или восьмой
+// части словаря; дальше они вливаются в сортированную часть.
+constexpr std::size_t kMinRecentMerge = 1024;
+// Слова, которых не осталось ни в одной задаче, и слова удалённых задач
+// вычищаются, когда их становится больше половины.
+constexpr std::size_t kMinPurge = 4096;
+// Слово запроса с таким числом подходящих слов словаря проверяется по
+// их спискам задач, а с большим — по словам самих кандидатов.
+constexpr std::size_t kMaxProbeTokens = 8;
+
+// Следующий символ UTF-8; некорректная последовательность даёт U+FFFD.
+char32_t nextCodePoint(std::string_view text, std::size_t& i)
+{
+    unsigned char c = (unsigned char)text[i++];
+    if (c < 0x80) return c;
+    int extra = c >= 0xF8 ? -1 : c >= 0xF0 ? 3 : c >= 0xE0 ? 2 : c >= 0xC0 ? 1 : -1;
+    if (extra < 0) return 0xFFFD;
+    char32_t cp = c & (0x3F >> extra);
+    for (int k = 0; k < extra; ++k) {
+        if (i >= text.size() || ((unsigned char)text[i] & 0xC0) != 0x80) return 0xFFFD;
+        cp = (cp << 6) | ((unsigned char)text[i++] & 0x3F);
+    }
+    return cp;
+}
+
+bool isWordChar(char32_t cp)
+{
+    if (cp < 0x80) {
+        return (cp >= '0' && cp <= '9') || (cp >= 'a' && cp <= 'z') || (cp >= 'A' && cp <= 'Z');
+    }
+    if (cp < 0xC0 || cp == 0xD7 || cp == 0xF7 || cp == 0xFFFD) return false;
+    // Знаки препинания, символы, стрелки, рамки, эмодзи.
+    if (cp >= 0x2000 && cp < 0x2C00) return false;
+    if (cp >= 0x3000 && cp < 0x3040) return false;
+    if (cp >= 0x1F000) return false;
+    return true;
+}
+
+char32_t foldCase(char32_t cp)
+{
+    if (cp >= 'A' && cp <= 'Z') return cp + 0x20;
+    if (cp >= 0xC0 && cp <= 0xDE && cp != 0xD7) return cp + 0x20;
+    if (cp >= 0x410 && cp <= 0x42F) return cp + 0x20;
+    if (cp == 0x401 || cp == 0x451) return 0x435;             // Ё, ё -> е
+    if (cp >= 0x400 && cp <= 0x40F) return cp + 0x50;
+    if (cp >= 0x391 && cp <= 0x3A9 && cp != 0x3A2) return cp + 0x20;
+    return cp;
+}
+
+void appendUtf8(char32_t cp, std::string& out)
+{
+    if (cp < 0x80) {
+        out += (char)cp;
+    } else if (cp < 0x800) {
+        out += (char)(0xC0 | (cp >> 6));
+        out += (char)(0x80 | (cp & 0x3F));
+    } else if (cp < 0x10000) {
+        out += (char)(0xE0 | (cp >> 12));
+        out += (char)(0x80 | ((cp >> 6) & 0x3F));
+        out += (char)(0x80 | (cp & 0x3F));
+    } else {
+        out += (char)(0xF0 | (cp >> 18));
+        out += (char)(0x80 | ((cp >> 12) & 0x3F));
+        out += (char)(0x80 | ((cp >> 6) & 0x3F));
+        out += (char)(0x80 | (cp & 0x3F));
+    }
+}
+
+// Дописывает слова text в out; fn(begin, end) получает границы каждого слова.
+template <typename Fn>
+void forEachToken(std::string_view text, std::string& out, Fn&& fn)
+{
+    std::size_t begin = out.size();
+    auto finish = [&]() {
+        if (out.size() > begin) fn(begin, out.size());
+        begin = out.size();
+    };
+
+    std::size_t i = 0;
+    while (i < text.size()) {
+        char32_t cp = nextCodePoint(text, i);
+        if (!isWordChar(cp)) {
+            finish();
+        } else if (out.size() - begin < kMaxTokenBytes) {
+            appendUtf8(foldCase(cp), out);
+        }
+    }
+    finish();
+}
+
+bool startsWith(std::string_view text, std::string_view prefix)
+{
+    return text.size() >= prefix.size() && text.compare(0, prefix.size(), prefix) == 0;
+}
+
+}
+
+TaskSearchIndex::TaskSearchIndex(ScrumBoard& board)
+    : board_(board),
+      pool_(newPool()),
+      tokens_(&memory::resource(memory::Component::SearchIndex)),
+      sorted_(tokens_.get_allocator()),
+      recent_(tokens_.get_allocator()),
+      docSlots_(tokens_.get_allocator().resource()),
+      docs_(tokens_.get_allocator()),
+      docTokens_(tokens_.get_allocator()),
+      pending_(tokens_.get_allocator())
+{
+    subscription_ = board_.subscribe([this](const BoardChange& change) { onBoardChanged(change); });
+    rebuild();
+}
+
+TaskSearchIndex::~TaskSearchIndex()
+{
+    board_.unsubscribe(subscription_);
+}
+
+std::vector<std::string> TaskSearchIndex::tokenize(std::string_view text)
+{
+    std::string buffer;
+    std::vector<std::string> tokens;
+    forEachToken(text, buffer, [&](std::size_t begin, std::size_t end) {
+        tokens.emplace_back(buffer, begin, end - begin);
+    });
+    return tokens;
+}
+
+TextPool TaskSearchIndex::newPool()
+{
+    auto* resource = &memory::resource(memory::Component::SearchIndex);
+    return TextPool(resource, resource);
+}
+
+void TaskSearchIndex::onBoardChanged(const BoardChange& change)
+{
+    switch (change.kind) {
+    case BoardChange::Kind::TaskAdded:
+        removeTask(change.id);
+        addTask(board_.getTask(change.id));
+        break;
+    case BoardChange::Kind::TaskRemoved:
+        removeTask(change.id);
+        break;
+    case BoardChange::Kind::Reset:
+        rebuild();
+        break;
+    case BoardChange::Kind::BatchBegin:
+        ++batchDepth_;
+        break;
+    case BoardChange::Kind::BatchEnd:
+        if (batchDepth_ > 0 && --batchDepth_ == 0) flush();
+        break;
+    default:
+        // Статус и исполнитель на текст задачи не влияют.
+        break;
+    }
+}
+
+void TaskSearchIndex::rebuild()
+{
+    pool_ = newPool();
+    tokens_.clear();
+    sorted_.clear();
+    recent_.clear();
+    listedTokens_ = 0;
+    emptyTokens_ = 0;
+    docSlots_.clear();
+    docs_.clear();
+    docTokens_.clear();
+    deadDocTokens_ = 0;
+    pending_.clear();
+
+    const TaskStore& tasks = board_.getAllTasks();
+    docSlots_.reserve(tasks.size());
+    docs_.reserve(tasks.size());
+    // Задачи лежат в хранилище почти по возрастанию ID; редкие исключения
+    // копятся и вливаются в списки разом.
+    ++batchDepth_;
+    for (const TaskView& task : tasks) addTask(task);
+    --batchDepth_;
+    if (batchDepth_ == 0) flush();
+    mergeRecent();
+}
+
+void TaskSearchIndex::addTask(const TaskView& task)
+{
+    tokenText_.clear();
+    std::vector<std::pair<std::size_t, std::size_t>> spans;
+    auto collect = [&](std::size_t begin, std::size_t end) { spans.emplace_back(begin, end); };
+    forEachToken(task.title(), tokenText_, collect);
+    forEachToken(task.description(), tokenText_, collect);
+
+    std::vector<std::string_view> words;
+    words.reserve(spans.size());
+    for (const auto& span : spans) {
+        words.emplace_back(tokenText_.data() + span.first, span.second - span.first);
+    }
+    std::sort(words.begin(), words.end());
+    words.erase(std::unique(words.begin(), words.end()), words.end());
+
+    Doc doc{task.id(), (std::uint32_t)docTokens_.size(), (std::uint32_t)words.size()};
+    for (std::string_view word : words) {
+        Handle handle = pool_.intern(word);
+        if (handle >= tokens_.size()) tokens_.resize((std::size_t)handle + 1);
+        Token& token = tokens_[handle];
+        if (!token.listed) {
+            // Словарь держит единственную ссылку на слово.
+            token.listed = true;
+            ++listedTokens_;
+            ++emptyTokens_;
+            recent_.push_back(handle);
+        } else {
+            pool_.release(handle);
+        }
+        docTokens_.push_back(handle);
+        changePosting(handle, task.id(), true);
+    }
+    docSlots_.set(task.id(), (std::uint32_t)docs_.size());
+    docs_.push_back(doc);
+
+    if (recent_.size() > std::max(kMinRecentMerge, sorted_.size() / 8)) mergeRecent();
+}
+
+void TaskSearchIndex::removeTask(int taskId)
+{
+    std::uint32_t slot = docSlots_.find(taskId);
+    if (slot == FlatIdIndex::npos) return;
+
+    const Doc& doc = docs_[slot];
+    for (std::uint32_t i = 0; i < doc.count; ++i) {
+        changePosting(docTokens_[doc.first + i], taskId, false);
+    }
+    deadDocTokens_ += doc.count;
+
+    // Как в TaskStore: на место удалённой задачи переносится последняя.
+    if ((std::size_t)slot + 1 != docs_.size()) {
+        docs_[slot] = docs_.back();
+        docSlots_.set(docs_[slot].id, slot);
+    }
+    docs_.pop_back();
+    docSlots_.erase(taskId);
+
+    if (deadDocTokens_ > kMinPurge && deadDocTokens_ * 2 > docTokens_.size()) compactDocTokens();
+    if (batchDepth_ == 0 && emptyTokens_ > kMinPurge && emptyTokens_ * 2 > listedTokens_) purgeEmptyTokens();
+}
+
+// Загрузка добавляет задачи по возрастанию ID: такие изменения дописываются
+// в конец списка сразу. Остальные внутри пакета откладываются до flush().
+void TaskSearchIndex::changePosting(Handle handle, int taskId, bool add)
+{
+    Token& token = tokens_[handle];
+    std::pmr::vector<int>& tasks = token.tasks;
+    if (!token.pending && add && (tasks.empty() || tasks.back() < taskId)) {
+        if (tasks.empty()) --emptyTokens_;
+        tasks.push_back(taskId);
+        return;
+    }
+    if (batchDepth_ > 0 || token.pending) {
+        token.pending = true;
+        pending_.push_back({handle, taskId, add});
+        return;
+    }
+
+    auto it = std::lower_bound(tasks.begin(), tasks.end(), taskId);
+    bool present = it != tasks.end() && *it == taskId;
+    if (add && !present) {
+        if (tasks.empty()) --emptyTokens_;
+        tasks.insert(it, taskId);
+    } else if (!add && present) {
+        tasks.erase(it);
+        if (tasks.empty()) ++emptyTokens_;
+    }
+}
+
+// Для каждого слова с отложенными изменениями: список = (список − удалённые)
+// ∪ добавленные, где для каждой задачи берётся её последнее изменение.
+void TaskSearchIndex::flush()
+{
+    if (!pending_.empty()) {
+        std::stable_sort(pending_.begin(), pending_.end(),
+                         [](const PendingChange& a, const PendingChange& b) {
+                             return a.token != b.token ? a.token < b.token : a.taskId < b.taskId;
+                         });
+
+        std::vector<int> added;
+        std::vector<int> removed;
+        for (std::size_t i = 0; i < pending_.size();) {
+            Handle handle = pending_[i].token;
+            added.clear();
+            removed.clear();
+            for (; i < pending_.size() && pending_[i].token == handle; ++i) {
+                bool last = i + 1 == pending_.size() || pending_[i + 1].token != handle ||
+                            pending_[i + 1].taskId != pending_[i].taskId;
+                if (last) (pending_[i].add ? added : removed).push_back(pending_[i].taskId);
+            }
+
+            Token& token = tokens_[handle];
+            std::pmr::vector<int>& tasks = token.tasks;
+            bool wasEmpty = tasks.empty();
+            if (!removed.empty()) {
+                tasks.erase(std::remove_if(tasks.begin(), tasks.end(),
+                                           [&removed](int id) {
+                                               return std::binary_search(removed.begin(), removed.end(), id);
+                                           }),
+                            tasks.end());
+            }
+            if (!added.empty()) {
+                std::size_t middle = tasks.size();
+                tasks.insert(tasks.end(), added.begin(), added.end());
+                std::inplace_merge(tasks.begin(), tasks.begin() + (std::ptrdiff_t)middle, tasks.end());
+                tasks.erase(std::unique(tasks.begin(), tasks.end()), tasks.end());
+            }
+            if (wasEmpty && !tasks.empty()) --emptyTokens_;
+            if (!wasEmpty && tasks.empty()) ++emptyTokens_;
+            token.pending = false;
+        }
+        pending_.clear();
+        pending_.shrink_to_fit();
+    }
+
+    if (emptyTokens_ > kMinPurge && emptyTokens_ * 2 > listedTokens_) purgeEmptyTokens();
+}
+
+void TaskSearchIndex::mergeRecent()
+{
+    if (recent_.empty()) return;
+    auto byText = [this](Handle a, Handle b) { return pool_.view(a) < pool_.view(b); };
+    std::sort(recent_.begin(), recent_.end(), byText);
+    std::size_t middle = sorted_.size();
+    sorted_.insert(sorted_.end(), recent_.begin(), recent_.end());
+    std::inplace_merge(sorted_.begin(), sorted_.begin() + (std::ptrdiff_t)middle, sorted_.end(), byText);
+    recent_.clear();
+}
+
+void TaskSearchIndex::purgeEmptyTokens()
+{
+    std::vector<Handle> released;
+    auto drop = [&](Handle handle) {
+        Token& token = tokens_[handle];
+        if (!token.tasks.empty()) return false;
+        token.listed = false;
+        token.tasks.clear();
+        token.tasks.shrink_to_fit();
+        released.push_back(handle);
+        return true;
+    };
+    sorted_.erase(std::remove_if(sorted_.begin(), sorted_.end(), drop), sorted_.end());
+    recent_.erase(std::remove_if(recent_.begin(), recent_.end(), drop), recent_.end());
+
+    // Освобождённый дескриптор пул может сразу выдать другому слову.
+    for (Handle handle : released) pool_.release(handle);
+    listedTokens_ -= released.size();
+    emptyTokens_ = 0;
+    pool_.compactIfFragmented();
+}
+
+void TaskSearchIndex::compactDocTokens()
+{
+    std::pmr::vector<Handle> compacted(docTokens_.get_allocator());
+    compacted.reserve(docTokens_.size() - deadDocTokens_);
+    for (Doc& doc : docs_) {
+        std::uint32_t first = (std::uint32_t)compacted.size();
+        compacted.insert(compacted.end(), docTokens_.begin() + doc.first,
+                         docTokens_.begin() + doc.first + doc.count);
+        doc.first = first;
+    }
+    docTokens_.swap(compacted);
+    deadDocTokens_ = 0;
+}
+
+void TaskSearchIndex::matchPrefix(std::string_view prefix, std::vector<Handle>& out) const
+{
+    auto it = std::lower_bound(sorted_.begin(), sorted_.end(), prefix,
+                               [this](Handle handle, std::string_view value) {
+                                   return pool_.view(handle) < value;
+                               });
+    for (; it != sorted_.end() && startsWith(pool_.view(*it), prefix); ++it) {
+        if (!tokens_[*it].tasks.empty()) out.push_back(*it);
+    }
+    for (Handle handle : recent_) {
+        if (!tokens_[handle].tasks.empty() && startsWith(pool_.view(handle), prefix)) out.push_back(handle);
+    }
+}
+
+bool TaskSearchIndex::docHasPrefix(int taskId, std::string_view prefix) const
+{
+    const Doc& doc = docs_[docSlots_.find(taskId)];
+    for (std::uint32_t i = 0; i < doc.count; ++i) {
+        if (startsWith(pool_.view(docTokens_[doc.first + i]), prefix)) return true;
+    }
+    return false;
+}
+
+std::optional<std::vector<int>> TaskSearchIndex::search(std::string_view query)
+{
+    flush();
+
+    std::vector<std::string> words = tokenize(query);
+    if (words.empty()) return std::nullopt;
+    std::sort(words.begin(), words.end());
+    words.erase(std::unique(words.begin(), words.end()), words.end());
+
+    struct Term {
+        std::string_view prefix;
+        std::vector<Handle> tokens;
+        std::size_t cost = 0;       // сумма длин списков задач
+    };
+    std::vector<Term> terms(words.size());
+    for (std::size_t i = 0; i < words.size(); ++i) {
+        Term& term = terms[i];
+        term.prefix = words[i];
+        matchPrefix(term.prefix, term.tokens);
+        if (term.tokens.empty()) return std::vector<int>();
+        for (Handle handle : term.tokens) term.cost += tokens_[handle].tasks.size();
+    }
+    std::sort(terms.begin(), terms.end(), [](const Term& a, const Term& b) { return a.cost < b.cost; });
+
+    // Кандидаты — задачи самого редкого слова; остальные слова их только отсеивают.
+    std::vector<int> result;
+    result.reserve(terms[0].cost);
+    for (Handle handle : terms[0].tokens) {
+        const std::pmr::vector<int>& tasks = tokens_[handle].tasks;
+        result.insert(result.end(), tasks.begin(), tasks.end());
+    }
+    if (terms[0].tokens.size() > 1) {
+        std::sort(result.begin(), result.end());
+        result.erase(std::unique(result.begin(), result.end()), result.end());
+    }
+
+    for (std::size_t i = 1; i < terms.size() && !result.empty(); ++i) {
+        const Term& term = terms[i];
+        if (term.tokens.size() <= kMaxProbeTokens) {
+            result.erase(std::remove_if(result.begin(), result.end(),
+                                        [&](int id) {
+                                            for (Handle handle : term.tokens) {
+                                                const std::pmr::vector<int>& tasks = tokens_[handle].tasks;
+                                                if (std::binary_search(tasks.begin(), tasks.end(), id)) return false;
+                                            }
+                                            return true;
+                                        }),
+                         result.end());
+        } else {
+            result.erase(std::remove_if(result.begin(), result.end(),
+                                        [&](int id) { return !docHasPrefix(id, term.prefix); }),
+                         result.end());
+        }
+    }
+    return result;
+}
+
+std::size_t TaskSearchIndex::memoryUsage() const
+{
+    std::size_t bytes = pool_.memoryUsage()
+                        + tokens_.capacity() * sizeof(Token)
+                        + (sorted_.capacity() + recent_.capacity()) * sizeof(Handle)
+                        + docSlots_.capacity() * (sizeof(int) + sizeof(std::uint32_t))
+                        + docs_.capacity() * sizeof(Doc)
+                        + docTokens_.capacity() * sizeof(Handle)
+                        + pending_.capacity() * sizeof(PendingChange);
+    for (const Token& token : tokens_) bytes += token.tasks.capacity() * sizeof(int);
+    return bytes;
+}
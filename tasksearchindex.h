@@ -0,0 +1,112 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <memory_resource>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <vector>
+#include "scrumboard.h"
+#include "taskstore.h"
+#include "textpool.h"
+
+// Полнотекстовый индекс по названиям и описаниям задач доски. Слово — это
+// последовательность букв и цифр; латиница и кириллица приводятся к нижнему
+// регистру, «ё» ищется как «е». Каждое слово хранится в словаре один раз
+// вместе с отсортированным списком ID задач, где оно встречается; для каждой
+// задачи хранится список её слов, чтобы снять её из индекса при удалении.
+//
+// Индекс подписан на доску и следует за её уведомлениями. Изменения внутри
+// пакета копятся и применяются к спискам слов одним проходом в конце пакета.
+// Вся память индекса берётся у ресурса memory::Component::SearchIndex.
+class TaskSearchIndex {
+public:
+    explicit TaskSearchIndex(ScrumBoard& board);
+    ~TaskSearchIndex();
+
+    TaskSearchIndex(const TaskSearchIndex&) = delete;
+    TaskSearchIndex& operator=(const TaskSearchIndex&) = delete;
+
+    // Слова запроса через пробел; задача подходит, если для каждого из них
+    // в её тексте есть слово, которое с него начинается. Возвращает ID задач
+    // по возрастанию или nullopt, если в запросе нет ни одного слова.
+    // Текст задач при поиске не читается.
+    std::optional<std::vector<int>> search(std::string_view query);
+
+    std::size_t taskCount() const noexcept { return docs_.size(); }
+    std::size_t tokenCount() const noexcept { return listedTokens_ - emptyTokens_; }
+    // Оценка памяти индекса по размерам контейнеров: словарь, списки задач
+    // по словам и слова задач. Измеренное значение даёт memory::report().
+    std::size_t memoryUsage() const;
+
+    // Слова текста в том виде, в каком их хранит индекс.
+    static std::vector<std::string> tokenize(std::string_view text);
+
+private:
+    using Handle = TextPool::Handle;
+
+    // Список задач слова берёт ресурс у вектора слов (uses-allocator).
+    struct Token {
+        using allocator_type = std::pmr::polymorphic_allocator<int>;
+
+        explicit Token(const allocator_type& allocator) : tasks(allocator) {}
+        Token(const Token& other, const allocator_type& allocator)
+            : tasks(other.tasks, allocator), listed(other.listed), pending(other.pending) {}
+        Token(Token&& other, const allocator_type& allocator)
+            : tasks(std::move(other.tasks), allocator), listed(other.listed), pending(other.pending) {}
+        Token(const Token&) = default;
+        Token(Token&&) = default;
+        Token& operator=(const Token&) = default;
+        Token& operator=(Token&&) = default;
+
+        std::pmr::vector<int> tasks;    // по возрастанию ID
+        bool listed = false;            // слово есть в словаре
+        bool pending = false;           // есть отложенные изменения списка
+    };
+
+    struct Doc {
+        int id;
+        std::uint32_t first;        // начало слов задачи в docTokens_
+        std::uint32_t count;
+    };
+
+    struct PendingChange {
+        Handle token;
+        int taskId;
+        bool add;
+    };
+
+    static TextPool newPool();
+    void onBoardChanged(const BoardChange& change);
+    void rebuild();
+    void addTask(const TaskView& task);
+    void removeTask(int taskId);
+    void changePosting(Handle token, int taskId, bool add);
+    void flush();
+    void mergeRecent();
+    void purgeEmptyTokens();
+    void compactDocTokens();
+    void matchPrefix(std::string_view prefix, std::vector<Handle>& out) const;
+    bool docHasPrefix(int taskId, std::string_view prefix) const;
+
+    ScrumBoard& board_;
+    int subscription_ = 0;
+    int batchDepth_ = 0;
+
+    // Словарь: текст слов в пуле (одна ссылка на слово), порядок слов —
+    // сортированный sorted_ и ещё не влитый в него recent_.
+    TextPool pool_;
+    std::pmr::vector<Token> tokens_;
+    std::pmr::vector<Handle> sorted_;
+    std::pmr::vector<Handle> recent_;
+    std::size_t listedTokens_ = 0;
+    std::size_t emptyTokens_ = 0;
+
+    FlatIdIndex docSlots_;
+    std::pmr::vector<Doc> docs_;
+    std::pmr::vector<Handle> docTokens_;
+    std::size_t deadDocTokens_ = 0;
+
+    std::pmr::vector<PendingChange> pending_;
+    std::string tokenText_;
+};
@@ -1,9 +1,10 @@
 #pragma once
 
+#include <cstddef>
+#include <cstdint>
 #include <string>
 
-
-enum class TaskStatus {
+enum class TaskStatus : std::uint8_t {
     Backlog,
     Assigned,
     InProgress,
@@ -11,6 +12,12 @@ enum class TaskStatus {
     Done
 };
 
+constexpr std::size_t kTaskStatusCount = 5;
+
+inline std::size_t statusIndex(TaskStatus status) {
+    return static_cast<std::size_t>(status);
+}
+
 inline std::string toString(TaskStatus status) {
     switch(status) {
     case TaskStatus::Assigned: return "Assigned";
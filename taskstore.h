@@ -0,0 +1,266 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <iterator>
+#include <limits>
+#include <memory_resource>
+#include <string_view>
+#include "memoryaccounting.h"
+#include "persistentvector.h"
+#include "task.h"
+#include "textpool.h"
+
+// Индекс ID -> позиция в хранилище: открытая адресация с линейным
+// пробированием в одном плоском массиве, удаление сдвигом назад (без надгробий).
+class FlatIdIndex {
+public:
+    static constexpr std::uint32_t npos = std::numeric_limits<std::uint32_t>::max();
+
+    FlatIdIndex() = default;
+    explicit FlatIdIndex(std::pmr::memory_resource* resource) noexcept : entries_(resource) {}
+
+    std::size_t size() const noexcept { return size_; }
+
+    void clear() {
+        entries_.clear();
+        size_ = 0;
+    }
+
+    void reserve(std::size_t count) {
+        std::size_t needed = 16;
+        while (needed < count * 2) needed *= 2;
+        if (needed > entries_.size()) rehash(needed);
+    }
+
+    std::uint32_t find(int id) const noexcept {
+        if (entries_.empty()) return npos;
+        // Пробирование идёт по отрезкам листьев: спуск по дереву — раз на лист.
+        std::size_t mask = entries_.size() - 1;
+        for (std::size_t i = bucketFor(id); ; ) {
+            std::size_t count;
+            const Entry* e = entries_.run(i, count);
+            for (const Entry* end = e + count; e != end; ++e) {
+                if (e->slot == npos) return npos;
+                if (e->id == id) return e->slot;
+            }
+            i = (i + count) & mask;
+        }
+    }
+
+    // Вставляет или перезаписывает позицию для ID.
+    void set(int id, std::uint32_t slot) {
+        if ((size_ + 1) * 2 > entries_.size()) {
+            rehash(entries_.empty() ? 16 : entries_.size() * 2);
+        }
+        std::size_t mask = entries_.size() - 1;
+        for (std::size_t i = bucketFor(id); ; i = (i + 1) & mask) {
+            const Entry& e = entries_[i];
+            if (e.slot == npos) {
+                entries_.mutate(i) = {id, slot};
+                ++size_;
+                return;
+            }
+            if (e.id == id) {
+                entries_.mutate(i).slot = slot;
+                return;
+            }
+        }
+    }
+
+    void erase(int id) {
+        if (find(id) == npos) return;
+        std::size_t mask = entries_.size() - 1;
+        std::size_t i = bucketFor(id);
+        while (entries_[i].id != id || entries_[i].slot == npos) i = (i + 1) & mask;
+
+        // Сдвигаем назад элементы цепочки, которые могут занять освободившуюся ячейку.
+        std::size_t hole = i;
+        for (std::size_t j = (hole + 1) & mask; entries_[j].slot != npos; j = (j + 1) & mask) {
+            std::size_t home = bucketFor(entries_[j].id);
+            bool movable = (hole <= j) ? (home <= hole || home > j)
+                                       : (home <= hole && home > j);
+            if (movable) {
+                entries_.mutate(hole) = entries_[j];
+                hole = j;
+            }
+        }
+        entries_.mutate(hole).slot = npos;
+        --size_;
+    }
+
+    std::size_t capacity() const noexcept { return entries_.size(); }
+
+private:
+    struct Entry {
+        int id = 0;
+        std::uint32_t slot = npos;
+    };
+
+    std::size_t bucketFor(int id) const noexcept {
+        // Фибоначчиево хеширование: последовательные ID расходятся по таблице.
+        std::uint64_t h = static_cast<std::uint32_t>(id) * 0x9E3779B97F4A7C15ull;
+        return static_cast<std::size_t>(h >> shift_);
+    }
+
+    void rehash(std::size_t capacity) {
+        PersistentVector<Entry> old = std::move(entries_);
+        entries_.assign(capacity, Entry());
+        shift_ = 64;
+        for (std::size_t c = capacity; c > 1; c >>= 1) --shift_;
+        size_ = 0;
+        for (const Entry& e : old) {
+            if (e.slot != npos) set(e.id, e.slot);
+        }
+    }
+
+    PersistentVector<Entry> entries_;
+    std::size_t size_ = 0;
+    unsigned shift_ = 64;
+};
+
+// Хранилище задач «структура массивов»: горячие поля (ID, статус, исполнитель)
+// лежат в отдельных плотных массивах, текст — в общем пуле строк. Позиции плотные:
+// при удалении на место задачи переносится последняя. Стабильный дескриптор
+// задачи — её ID; позиция по ID находится через FlatIdIndex. Столбцы — постоянные
+// векторы: копия хранилища стоит O(1), а правка копирует лишь пару листьев.
+// Память каждой части берётся у её ресурса из memoryaccounting.h либо
+// вся у одного ресурса, переданного в конструктор.
+class TaskStore {
+public:
+    using Slot = std::uint32_t;
+    static constexpr Slot npos = FlatIdIndex::npos;
+    static constexpr int kNoDeveloper = std::numeric_limits<int>::min();
+
+    class const_iterator {
+    public:
+        using iterator_category = std::forward_iterator_tag;
+        using value_type = TaskView;
+        using difference_type = std::ptrdiff_t;
+        using pointer = void;
+        using reference = TaskView;
+
+        const_iterator(const TaskStore* store, Slot slot) : store_(store), slot_(slot) {}
+
+        TaskView operator*() const { return store_->view(slot_); }
+        const_iterator& operator++() { ++slot_; return *this; }
+        const_iterator operator++(int) { const_iterator tmp = *this; ++slot_; return tmp; }
+        bool operator==(const const_iterator& other) const { return slot_ == other.slot_; }
+        bool operator!=(const const_iterator& other) const { return slot_ != other.slot_; }
+
+    private:
+        const TaskStore* store_;
+        Slot slot_;
+    };
+
+    TaskStore()
+        : ids_(&memory::resource(memory::Component::TaskColumns)),
+          statuses_(ids_.resource()),
+          assignees_(ids_.resource()),
+          texts_(ids_.resource()),
+          text_(newTextPool()),
+          index_(&memory::resource(memory::Component::TaskIndex)) {}
+
+    explicit TaskStore(std::pmr::memory_resource* resource)
+        : ids_(resource), statuses_(resource), assignees_(resource), texts_(resource),
+          text_(resource, resource), index_(resource) {}
+
+    std::size_t size() const noexcept { return ids_.size(); }
+    bool empty() const noexcept { return ids_.empty(); }
+    // Сколько задач поместится без перестройки индекса.
+    std::size_t capacity() const noexcept { return index_.capacity() / 2; }
+
+    const_iterator begin() const { return const_iterator(this, 0); }
+    const_iterator end() const { return const_iterator(this, (Slot)ids_.size()); }
+
+    void reserve(std::size_t count) {
+        index_.reserve(count);
+        text_.reserve(count * 2);
+    }
+
+    void clear() {
+        ids_.clear();
+        statuses_.clear();
+        assignees_.clear();
+        texts_.clear();
+        text_ = TextPool(text_.textResource(), text_.tablesResource());
+        index_.clear();
+    }
+
+    Slot find(int id) const noexcept { return index_.find(id); }
+    bool contains(int id) const noexcept { return find(id) != npos; }
+
+    // ID должен отсутствовать в хранилище — проверка на стороне вызывающего.
+    Slot insert(const TaskView& task) {
+        Slot slot = (Slot)ids_.size();
+        ids_.push_back(task.id());
+        statuses_.push_back(task.status());
+        assignees_.push_back(task.assignedDeveloper() ? *task.assignedDeveloper() : kNoDeveloper);
+        texts_.push_back({text_.intern(task.title()), text_.intern(task.description())});
+        index_.set(task.id(), slot);
+        return slot;
+    }
+
+    void erase(Slot slot) {
+        int id = ids_[slot];
+        text_.release(texts_[slot].title);
+        text_.release(texts_[slot].description);
+
+        Slot last = (Slot)ids_.size() - 1;
+        if (slot != last) {
+            ids_.mutate(slot) = ids_[last];
+            statuses_.mutate(slot) = statuses_[last];
+            assignees_.mutate(slot) = assignees_[last];
+            texts_.mutate(slot) = texts_[last];
+            index_.set(ids_[slot], slot);
+        }
+        ids_.pop_back();
+        statuses_.pop_back();
+        assignees_.pop_back();
+        texts_.pop_back();
+        index_.erase(id);
+
+        text_.compactIfFragmented();
+    }
+
+    int id(Slot slot) const { return ids_[slot]; }
+    TaskStatus status(Slot slot) const { return statuses_[slot]; }
+    int assignee(Slot slot) const { return assignees_[slot]; }
+    bool hasAssignee(Slot slot) const { return assignees_[slot] != kNoDeveloper; }
+    std::string_view title(Slot slot) const { return text_.view(texts_[slot].title); }
+    std::string_view description(Slot slot) const { return text_.view(texts_[slot].description); }
+
+    void setStatus(Slot slot, TaskStatus status) { statuses_.mutate(slot) = status; }
+    void setAssignee(Slot slot, int developerId) { assignees_.mutate(slot) = developerId; }
+
+    TaskView view(Slot slot) const {
+        int dev = assignees_[slot];
+        return TaskView(ids_[slot], title(slot), description(slot),
+                        statuses_[slot],
+                        dev != kNoDeveloper ? std::optional<int>(dev) : std::nullopt);
+    }
+
+    // Прямой доступ к колонкам для сплошных проходов.
+    const PersistentVector<int>& ids() const noexcept { return ids_; }
+    const PersistentVector<TaskStatus>& statuses() const noexcept { return statuses_; }
+    const PersistentVector<int>& assignees() const noexcept { return assignees_; }
+
+    const TextPool& textPool() const noexcept { return text_; }
+
+private:
+    struct TaskText {
+        TextPool::Handle title;
+        TextPool::Handle description;
+    };
+
+    static TextPool newTextPool() {
+        return TextPool(&memory::resource(memory::Component::TaskText),
+                        &memory::resource(memory::Component::TextTables));
+    }
+
+    PersistentVector<int> ids_;
+    PersistentVector<TaskStatus> statuses_;
+    PersistentVector<int> assignees_;
+    PersistentVector<TaskText> texts_;
+    TextPool text_;
+    FlatIdIndex index_;
+};
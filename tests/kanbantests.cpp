@@ -3,11 +3,39 @@
 #include "task.h"
 #include "developer.h"
 #include "scrumboard.h"
+#include "taskstore.h"
+#include "textpool.h"
+#include "persistentvector.h"
+#include "persistentidset.h"
 #include "boardserializer.h"
+#include "boardsnapshot.h"
+#include "boardjournal.h"
+#include "boardsaver.h"
+#include "boardloader.h"
+#include "boardhistory.h"
+#include "boardworkspace.h"
+#include "boardgenerator.h"
+#include "boardquery.h"
+#include "taskimporter.h"
+#include "tasksearchindex.h"
+#include "atomicfile.h"
+#include "memoryaccounting.h"
+#include "metrics.h"
+#include "tracing.h"
 #include "taskstatus.h"
 
+#include <cstddef>
 #include <filesystem>
+#include <fstream>
+#include <map>
+#include <future>
+#include <random>
+#include <set>
+#include <sstream>
 #include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
 
 namespace fs = std::filesystem;
 
@@ -41,6 +69,28 @@ TEST(ScrumBoardTests, AddDeveloper_DuplicateId_Throws) {
     EXPECT_THROW(b.addDeveloper(Developer(1, "B")), std::runtime_error);
 }
 
+TEST(ScrumBoardTests, FindDeveloper_DenseAndSparseIds) {
+    ScrumBoard b;
+    b.addDeveloper(Developer(1, "A"));
+    b.addDeveloper(Developer(2, "B"));
+    b.addDeveloper(Developer(1000000, "Far"));
+    b.addDeveloper(Developer(-5, "Negative"));
+
+    ASSERT_NE(b.findDeveloper(2), nullptr);
+    EXPECT_EQ(b.findDeveloper(2)->name(), "B");
+    EXPECT_EQ(b.getDeveloper(1000000).name(), "Far");
+    EXPECT_EQ(b.getDeveloper(-5).name(), "Negative");
+    EXPECT_EQ(b.findDeveloper(3), nullptr);
+    EXPECT_THROW((void)b.getDeveloper(3), std::out_of_range);
+
+    b.removeDeveloper(1);
+    EXPECT_EQ(b.findDeveloper(1), nullptr);
+    EXPECT_EQ(b.getDeveloper(2).name(), "B");
+    EXPECT_EQ(b.getDeveloper(1000000).name(), "Far");
+    EXPECT_EQ(b.getAllDevelopers().size(), 3u);
+    EXPECT_THROW(b.removeDeveloper(1), std::runtime_error);
+}
+
 TEST(ScrumBoardTests, AddTask_DuplicateId_Throws) {
     ScrumBoard b;
     b.addTask(Task(1, "T1", "D1"));
@@ -82,6 +132,560 @@ TEST(ScrumBoardTests, RemoveTask_Unknown_Throws) {
     EXPECT_THROW(b.removeTask(123), std::runtime_error);
 }
 
+TEST(ScrumBoardTests, Mutations_NotifySubscribers) {
+    ScrumBoard b;
+    std::vector<BoardChange> changes;
+    int token = b.subscribe([&](const BoardChange& c) { changes.push_back(c); });
+
+    b.addDeveloper(Developer(1, "Dev"));
+    b.addTask(Task(1, "T", "D"));
+    b.assignTask(1, 1);
+    b.changeTaskStatus(1, TaskStatus::InProgress);
+    b.removeTask(1);
+
+    ASSERT_EQ(changes.size(), 5u);
+    EXPECT_EQ(changes[0].kind, BoardChange::Kind::DeveloperAdded);
+    EXPECT_EQ(changes[1].kind, BoardChange::Kind::TaskAdded);
+    EXPECT_EQ(changes[2].kind, BoardChange::Kind::TaskAssigned);
+    EXPECT_EQ(changes[2].oldStatus, TaskStatus::Backlog);
+    EXPECT_EQ(changes[2].newStatus, TaskStatus::Assigned);
+    EXPECT_EQ(changes[3].kind, BoardChange::Kind::TaskStatusChanged);
+    EXPECT_EQ(changes[3].oldStatus, TaskStatus::Assigned);
+    EXPECT_EQ(changes[3].newStatus, TaskStatus::InProgress);
+    EXPECT_EQ(changes[4].kind, BoardChange::Kind::TaskRemoved);
+    EXPECT_EQ(changes[4].oldStatus, TaskStatus::InProgress);
+
+    b.unsubscribe(token);
+    b.addTask(Task(2, "T", "D"));
+    EXPECT_EQ(changes.size(), 5u);
+}
+
+TEST(ScrumBoardTests, RejectedTransition_DoesNotNotify) {
+    ScrumBoard b;
+    b.addTask(Task(1, "T", "D"));
+    int notified = 0;
+    b.subscribe([&](const BoardChange&) { ++notified; });
+    EXPECT_THROW(b.changeTaskStatus(1, TaskStatus::InProgress), std::logic_error);
+    EXPECT_EQ(notified, 0);
+}
+
+TEST(ScrumBoardTests, ReplaceWith_KeepsSubscribersAndNotifiesReset) {
+    ScrumBoard b;
+    std::vector<BoardChange> changes;
+    b.subscribe([&](const BoardChange& c) { changes.push_back(c); });
+
+    ScrumBoard copy = b;
+    copy.addTask(Task(1, "T", "D"));
+    EXPECT_TRUE(changes.empty());
+
+    b.replaceWith(copy);
+    ASSERT_EQ(changes.size(), 1u);
+    EXPECT_EQ(changes[0].kind, BoardChange::Kind::Reset);
+    EXPECT_EQ(b.getAllTasks().size(), 1u);
+
+    b.removeTask(1);
+    EXPECT_EQ(changes.size(), 2u);
+}
+
+TEST(ScrumBoardTests, StatusIndex_FollowsMutations) {
+    ScrumBoard b;
+    b.addDeveloper(Developer(1, "Dev"));
+    b.addTask(Task(3, "T3", "D3"));
+    b.addTask(Task(1, "T1", "D1"));
+    b.addTask(Task(2, "T2", "D2"));
+
+    EXPECT_EQ(b.countTasks(TaskStatus::Backlog), 3u);
+    EXPECT_EQ(b.getTaskIdsByStatus(TaskStatus::Backlog), (std::vector<int>{1, 2, 3}));
+
+    b.assignTask(2, 1);
+    b.assignTask(3, 1);
+    b.changeTaskStatus(3, TaskStatus::InProgress);
+    EXPECT_EQ(b.getTaskIdsByStatus(TaskStatus::Backlog), (std::vector<int>{1}));
+    EXPECT_EQ(b.getTaskIdsByStatus(TaskStatus::Assigned), (std::vector<int>{2}));
+    EXPECT_EQ(b.getTaskIdsByStatus(TaskStatus::InProgress), (std::vector<int>{3}));
+
+    EXPECT_THROW(b.changeTaskStatus(1, TaskStatus::InProgress), std::logic_error);
+    EXPECT_EQ(b.countTasks(TaskStatus::InProgress), 1u);
+
+    b.removeTask(3);
+    EXPECT_EQ(b.countTasks(TaskStatus::InProgress), 0u);
+    EXPECT_EQ(b.countTasks(TaskStatus::Done), 0u);
+}
+
+TEST(ScrumBoardTests, ChangeTaskStatuses_AppliesValidAndReportsFailures) {
+    ScrumBoard b;
+    b.addDeveloper(Developer(1, "Dev"));
+    b.addTask(Task(1, "T1", "D1"));
+    b.addTask(Task(2, "T2", "D2"));
+    b.addTask(Task(3, "T3", "D3"));
+    b.assignTask(1, 1);
+    b.assignTask(3, 1);
+
+    std::vector<BoardChange::Kind> kinds;
+    b.subscribe([&](const BoardChange& c) { kinds.push_back(c.kind); });
+
+    auto failures = b.changeTaskStatuses({1, 2, 3, 99}, TaskStatus::InProgress);
+
+    ASSERT_EQ(failures.size(), 2u);
+    EXPECT_EQ(failures[0].taskId, 2);
+    EXPECT_EQ(failures[1].taskId, 99);
+    EXPECT_EQ(b.getTask(1).status(), TaskStatus::InProgress);
+    EXPECT_EQ(b.getTask(2).status(), TaskStatus::Backlog);
+    EXPECT_EQ(b.getTask(3).status(), TaskStatus::InProgress);
+
+    ASSERT_EQ(kinds.size(), 4u);
+    EXPECT_EQ(kinds.front(), BoardChange::Kind::BatchBegin);
+    EXPECT_EQ(kinds.back(), BoardChange::Kind::BatchEnd);
+}
+
+TEST(ScrumBoardTests, AddTasks_InsertsInOneStepOrNotAtAll) {
+    ScrumBoard b;
+    b.addDeveloper(Developer(1, "Alice"));
+    b.addTask(Task(10, "Старая", "d"));
+
+    Task assigned(3, "Назначена", "d");
+    assigned.assignDeveloper(1);
+    std::vector<Task> tasks = { Task(5, "A", "a"), assigned, Task(1, "B", "b") };
+
+    int added = 0, batches = 0;
+    b.subscribe([&](const BoardChange& change) {
+        if (change.kind == BoardChange::Kind::TaskAdded) ++added;
+        if (change.kind == BoardChange::Kind::BatchBegin) ++batches;
+    });
+    b.addTasks(tasks);
+
+    EXPECT_EQ(added, 3);
+    EXPECT_EQ(batches, 1);
+    EXPECT_EQ(b.getTask(3).status(), TaskStatus::Assigned);
+    EXPECT_EQ(b.getTaskIdsByStatus(TaskStatus::Backlog), (std::vector<int>{1, 5, 10}));
+
+    std::vector<Task> duplicate = { Task(20, "C", "c"), Task(5, "D", "d") };
+    EXPECT_THROW(b.addTasks(duplicate), std::runtime_error);
+    std::vector<Task> repeated = { Task(21, "C", "c"), Task(21, "D", "d") };
+    EXPECT_THROW(b.addTasks(repeated), std::runtime_error);
+    std::vector<TaskView> unknownDeveloper = { TaskView(22, "E", "e", TaskStatus::Assigned, 9) };
+    EXPECT_THROW(b.addTasks(unknownDeveloper), std::out_of_range);
+    EXPECT_EQ(b.getAllTasks().size(), 4u);
+    EXPECT_FALSE(b.findTask(20).has_value());
+}
+
+TEST(ScrumBoardTests, TryMutations_ReturnErrorAndLeaveBoardUnchanged) {
+    ScrumBoard b;
+    b.addDeveloper(Developer(1, "Alice"));
+    b.addTask(Task(1, "T1", "D1"));
+
+    int notifications = 0;
+    b.subscribe([&](const BoardChange&) { ++notifications; });
+
+    EXPECT_EQ(b.tryChangeTaskStatus(1, TaskStatus::InProgress), BoardError::DeveloperRequired);
+    EXPECT_EQ(b.tryChangeTaskStatus(9, TaskStatus::Done), BoardError::TaskNotFound);
+    EXPECT_EQ(b.tryAssignTask(1, 7), BoardError::DeveloperNotFound);
+    EXPECT_EQ(b.tryAssignTask(9, 1), BoardError::TaskNotFound);
+    EXPECT_EQ(b.tryAddTask(Task(1, "Другая", "d")), BoardError::DuplicateTask);
+    EXPECT_EQ(b.tryAddTask(TaskView(2, "", "d", TaskStatus::Backlog, std::nullopt)), BoardError::EmptyTitle);
+    EXPECT_EQ(b.tryAddDeveloper(Developer(1, "Bob")), BoardError::DuplicateDeveloper);
+    EXPECT_EQ(b.tryRemoveTask(9), BoardError::TaskNotFound);
+    EXPECT_EQ(notifications, 0);
+    EXPECT_EQ(b.getTask(1).status(), TaskStatus::Backlog);
+
+    EXPECT_EQ(b.tryAssignTask(1, 1), BoardError::None);
+    EXPECT_EQ(b.tryChangeTaskStatus(1, TaskStatus::InProgress), BoardError::None);
+    EXPECT_EQ(b.getTask(1).status(), TaskStatus::InProgress);
+    EXPECT_EQ(notifications, 2);
+
+    // Бросающие методы сохранили прежние типы исключений.
+    EXPECT_THROW(b.changeTaskStatus(9, TaskStatus::Done), std::out_of_range);
+    EXPECT_THROW(b.addTask(Task(1, "T", "d")), std::runtime_error);
+    Task task(5, "T5", "D5");
+    EXPECT_EQ(task.tryChangeStatus(TaskStatus::Assigned), BoardError::DeveloperRequired);
+    EXPECT_THROW(task.changeStatus(TaskStatus::Assigned), std::logic_error);
+}
+
+TEST(SearchIndexTests, Tokenize_FoldsCaseAndSplitsOnPunctuation) {
+    EXPECT_EQ(TaskSearchIndex::tokenize("Ёлка, ЗАДАЧА-42: Fix «UI»!"),
+              (std::vector<std::string>{"елка", "задача", "42", "fix", "ui"}));
+    EXPECT_TRUE(TaskSearchIndex::tokenize(" — ... ").empty());
+}
+
+TEST(SearchIndexTests, Search_FollowsBoardChanges) {
+    ScrumBoard b;
+    b.addDeveloper(Developer(1, "Alice"));
+    b.addTask(Task(1, "Починить вход", "Ошибка авторизации на сервере"));
+    b.addTask(Task(2, "Сервер логов", "Настроить ротацию"));
+    TaskSearchIndex index(b);
+    b.addTask(Task(3, "Вход через SSO", "Сервер авторизации"));
+
+    EXPECT_FALSE(index.search("  ,, ").has_value());
+    EXPECT_EQ(*index.search("сервер"), (std::vector<int>{1, 2, 3}));
+    EXPECT_EQ(*index.search("Серв АВТОР"), (std::vector<int>{1, 3}));
+    EXPECT_EQ(*index.search("вход sso"), (std::vector<int>{3}));
+    EXPECT_TRUE(index.search("сервер kubernetes")->empty());
+
+    // Статус на текст не влияет, удаление и повторное добавление ID — влияют.
+    b.assignTask(3, 1);
+    b.removeTask(1);
+    EXPECT_EQ(*index.search("автор"), (std::vector<int>{3}));
+    b.addTask(Task(1, "Документация", ""));
+    EXPECT_EQ(*index.search("док"), (std::vector<int>{1}));
+    EXPECT_TRUE(index.search("починить")->empty());
+
+    std::vector<Task> batch = { Task(10, "Сервер метрик", ""), Task(5, "Сервер очередей", "") };
+    b.addTasks(batch);
+    EXPECT_EQ(*index.search("сервер"), (std::vector<int>{2, 3, 5, 10}));
+
+    ScrumBoard other;
+    other.addTask(Task(7, "Новая доска", ""));
+    b.replaceWith(other);
+    EXPECT_TRUE(index.search("сервер")->empty());
+    EXPECT_EQ(*index.search("доска"), (std::vector<int>{7}));
+    EXPECT_EQ(index.taskCount(), 1u);
+    EXPECT_GT(index.memoryUsage(), 0u);
+}
+
+TEST(SearchIndexTests, Search_MatchesNaiveScanUnderChurn) {
+    const std::vector<std::string> vocabulary = {
+        "сервер", "север", "вход", "входящий", "отчёт", "отчет", "Api", "apple", "база", "баг"
+    };
+    std::mt19937 rng(7);
+    auto makeText = [&](int id) {
+        std::string text = std::to_string(id);
+        for (int i = 0; i < 3; ++i) text += " " + vocabulary[rng() % vocabulary.size()];
+        return text;
+    };
+
+    ScrumBoard b;
+    TaskSearchIndex index(b);
+    std::unordered_map<int, std::string> reference;
+    int nextId = 1;
+    for (int round = 0; round < 6; ++round) {
+        std::vector<Task> added;
+        for (int i = 0; i < 3000; ++i) {
+            int id = nextId++;
+            added.emplace_back(id, makeText(id), vocabulary[rng() % vocabulary.size()]);
+            reference[id] = added.back().title() + " " + added.back().description();
+        }
+        b.addTasks(added);
+
+        b.beginBatch();
+        for (int i = 0; i < 2500; ++i) {
+            int id = (int)(rng() % (unsigned)nextId);
+            if (!reference.count(id)) continue;
+            b.removeTask(id);
+            reference.erase(id);
+        }
+        b.endBatch();
+        for (int i = 0; i < 50; ++i) {
+            int id = (int)(rng() % (unsigned)nextId);
+            if (reference.count(id)) continue;
+            b.addTask(Task(id, makeText(id), ""));
+            reference[id] = b.getTask(id).title();
+        }
+
+        for (const char* query : {"сер", "север", "вход апи", "отче", "ap", "база баг", "1"}) {
+            std::vector<std::string> terms = TaskSearchIndex::tokenize(query);
+            std::vector<int> expected;
+            for (const auto& entry : reference) {
+                std::vector<std::string> words = TaskSearchIndex::tokenize(entry.second);
+                bool all = std::all_of(terms.begin(), terms.end(), [&](const std::string& term) {
+                    return std::any_of(words.begin(), words.end(), [&](const std::string& word) {
+                        return word.compare(0, term.size(), term) == 0;
+                    });
+                });
+                if (all) expected.push_back(entry.first);
+            }
+            std::sort(expected.begin(), expected.end());
+            EXPECT_EQ(*index.search(query), expected) << query << " round " << round;
+        }
+    }
+    EXPECT_EQ(index.taskCount(), reference.size());
+}
+
+TEST(ImportTests, Csv_QuotedFieldsAndShortRows) {
+    ScrumBoard b;
+    b.addDeveloper(Developer(1, "Alice"));
+    b.addTask(Task(1, "Старая", "d"));
+    std::istringstream csv(
+        "\xEF\xBB\xBFid,title,external,status,description,assignee\r\n"
+        "7,\"Запятая, \"\"кавычки\"\"\",x,Done,\"две\nстроки\",\r\n"
+        "\r\n"
+        ",Без ID,y,,,1\n"
+        "3,Короткая\n");
+
+    EXPECT_EQ(importTasksFromCsv(b, csv), 3u);
+    EXPECT_EQ(b.getTask(7).title(), "Запятая, \"кавычки\"");
+    EXPECT_EQ(b.getTask(7).description(), "две\nстроки");
+    EXPECT_EQ(b.getTask(7).status(), TaskStatus::Done);
+    EXPECT_EQ(b.getTask(3).description(), "");
+    // Пустой ID берётся у доски, следующий ID идёт после наибольшего.
+    auto autoId = b.getTaskIdsByStatus(TaskStatus::Assigned);
+    ASSERT_EQ(autoId.size(), 1u);
+    EXPECT_EQ(b.getTask(autoId[0]).title(), "Без ID");
+    EXPECT_EQ(b.peekNextTaskId(), 8);
+
+    // Пустой ID не занимает ID, заданный ниже в той же порции.
+    ScrumBoard mixed;
+    std::istringstream mixedCsv("id,title\n2,a\n,b\n,c\n4,d\n,e\n");
+    EXPECT_EQ(importTasksFromCsv(mixed, mixedCsv), 5u);
+    EXPECT_EQ(mixed.getTask(2).title(), "a");
+    EXPECT_EQ(mixed.getTask(1).title(), "b");
+    EXPECT_EQ(mixed.getTask(3).title(), "c");
+    EXPECT_EQ(mixed.getTask(4).title(), "d");
+    EXPECT_EQ(mixed.getTask(5).title(), "e");
+    EXPECT_EQ(mixed.peekNextTaskId(), 6);
+}
+
+TEST(ImportTests, Csv_ErrorsReportLineAndKeepEarlierBatches) {
+    ScrumBoard b;
+    std::ostringstream text;
+    text << "title,id\n";
+    for (size_t i = 1; i <= kImportBatchSize; ++i) text << "T" << i << "," << i << "\n";
+    text << "\"Многострочная\nзадача\",1\n";
+    std::istringstream csv(text.str());
+
+    try {
+        importTasksFromCsv(b, csv);
+        FAIL() << "дубликат не обнаружен";
+    } catch (const std::runtime_error& e) {
+        EXPECT_NE(std::string(e.what()).find(std::to_string(kImportBatchSize + 2)), std::string::npos);
+    }
+    EXPECT_EQ(b.getAllTasks().size(), kImportBatchSize);
+    // Счётчик ID идёт после оставшихся порций, иначе новая задача заняла бы их ID.
+    EXPECT_EQ(b.peekNextTaskId(), (int)kImportBatchSize + 1);
+
+    ScrumBoard partial;
+    std::ostringstream rows;
+    rows << "title,id\n";
+    for (int i = 1; i <= 5000; ++i) rows << (i == 4500 ? "" : "T" + std::to_string(i)) << "," << i << "\n";
+    std::istringstream partialCsv(rows.str());
+    EXPECT_THROW(importTasksFromCsv(partial, partialCsv), std::runtime_error);
+    EXPECT_EQ(partial.getAllTasks().size(), kImportBatchSize);
+    EXPECT_EQ(partial.peekNextTaskId(), (int)kImportBatchSize + 1);
+    partial.addTask(Task(partial.getNextTaskId(), "Новая", ""));
+
+    std::istringstream badStatus("title,status\nA,Backlog\nB,Later\n");
+    try {
+        importTasksFromCsv(b, badStatus);
+        FAIL() << "статус не проверен";
+    } catch (const std::runtime_error& e) {
+        EXPECT_EQ(std::string(e.what()).rfind("Строка 3:", 0), 0u);
+    }
+    std::istringstream latin1("title\nCafe\nCaf\xE9\n");
+    try {
+        importTasksFromCsv(b, latin1);
+        FAIL() << "текст не в UTF-8 принят";
+    } catch (const std::runtime_error& e) {
+        EXPECT_EQ(std::string(e.what()).rfind("Строка 3:", 0), 0u);
+    }
+    std::istringstream noTitle("id,name\n1,A\n");
+    EXPECT_THROW(importTasksFromCsv(b, noTitle), std::runtime_error);
+    std::istringstream openQuote("title\n\"A\n");
+    EXPECT_THROW(importTasksFromCsv(b, openQuote), std::runtime_error);
+}
+
+TEST(ImportTests, JsonLines_MatchesBoardFileFields) {
+    ScrumBoard b;
+    b.addDeveloper(Developer(2, "Bob"));
+    std::istringstream jsonl(
+        "{\"id\": 4, \"title\": \"A\", \"description\": \"a\", \"status\": \"InProgress\", \"assignedDeveloperId\": 2}\n"
+        "\n"
+        "{\"title\": \"B\", \"assignedDeveloperId\": null}\r\n");
+
+    EXPECT_EQ(importTasksFromJsonLines(b, jsonl), 2u);
+    EXPECT_EQ(b.getTask(4).status(), TaskStatus::InProgress);
+    EXPECT_EQ(b.getTask(4).assignedDeveloper(), std::optional<int>(2));
+    EXPECT_EQ(b.getTaskIdsByStatus(TaskStatus::Backlog).size(), 1u);
+
+    std::istringstream broken("{\"title\": \"C\"}\n{\"title\": \n");
+    try {
+        importTasksFromJsonLines(b, broken);
+        FAIL() << "битая строка не обнаружена";
+    } catch (const std::runtime_error& e) {
+        EXPECT_EQ(std::string(e.what()).rfind("Строка 2:", 0), 0u);
+    }
+    std::istringstream unassigned("{\"id\": 9, \"title\": \"D\", \"status\": \"Assigned\"}\n");
+    EXPECT_THROW(importTasksFromJsonLines(b, unassigned), std::runtime_error);
+    EXPECT_FALSE(b.findTask(9).has_value());
+}
+
+TEST(TaskStoreTests, FlatIdIndex_MatchesReferenceUnderChurn) {
+    FlatIdIndex index;
+    std::unordered_map<int, std::uint32_t> reference;
+    std::mt19937 rng(7);
+    std::uniform_int_distribution<int> ids(-500, 2000);
+
+    for (int step = 0; step < 20000; ++step) {
+        int id = ids(rng);
+        if (rng() % 3 == 0) {
+            index.erase(id);
+            reference.erase(id);
+        } else {
+            index.set(id, (std::uint32_t)step);
+            reference[id] = (std::uint32_t)step;
+        }
+    }
+
+    EXPECT_EQ(index.size(), reference.size());
+    for (int id = -500; id <= 2000; ++id) {
+        auto it = reference.find(id);
+        EXPECT_EQ(index.find(id), it == reference.end() ? FlatIdIndex::npos : it->second);
+    }
+}
+
+TEST(PersistentVectorTests, CopiesStayIndependentUnderRandomEdits) {
+    std::mt19937 rng(11);
+    std::vector<PersistentVector<int>> versions(1);
+    std::vector<std::vector<int>> expected(1);
+
+    // Серии вставок и удалений доводят версии до двух уровней дерева.
+    for (int step = 0; step < 20000; ++step) {
+        std::size_t v = rng() % versions.size();
+        unsigned op = rng() % 10;
+        if (op == 0 && versions.size() < 16) {
+            versions.push_back(versions[v]);
+            expected.push_back(expected[v]);
+        } else if (op < 6 || expected[v].empty()) {
+            for (unsigned n = rng() % 400; n > 0; --n) {
+                versions[v].push_back(step);
+                expected[v].push_back(step);
+            }
+        } else if (op < 9) {
+            std::size_t i = rng() % expected[v].size();
+            versions[v].mutate(i) = -step;
+            expected[v][i] = -step;
+        } else {
+            for (unsigned n = rng() % 300; n > 0 && !expected[v].empty(); --n) {
+                versions[v].pop_back();
+                expected[v].pop_back();
+            }
+        }
+    }
+
+    for (std::size_t v = 0; v < versions.size(); ++v) {
+        ASSERT_EQ(versions[v].size(), expected[v].size());
+        EXPECT_TRUE(std::equal(versions[v].begin(), versions[v].end(), expected[v].begin()));
+        for (std::size_t i = 0; i < expected[v].size(); i += 97) EXPECT_EQ(versions[v][i], expected[v][i]);
+    }
+    EXPECT_GT(expected[0].size() + expected.back().size(), 65536u);
+}
+
+TEST(PersistentVectorTests, AssignSharesLeavesUntilWritten) {
+    PersistentVector<std::uint32_t> v;
+    v.assign(100000, 7);
+    PersistentVector<std::uint32_t> copy = v;
+    v.mutate(5) = 1;
+    v.mutate(99999) = 2;
+    EXPECT_EQ(v[5], 1u);
+    EXPECT_EQ(v[99999], 2u);
+    EXPECT_EQ(v[6], 7u);
+    EXPECT_EQ(copy[5], 7u);
+    EXPECT_EQ(copy[99999], 7u);
+    EXPECT_EQ((std::size_t)std::count(copy.begin(), copy.end(), 7u), 100000u);
+}
+
+TEST(PersistentIdSetTests, CopiesStayIndependentUnderRandomEdits) {
+    std::mt19937 rng(12);
+    std::vector<PersistentIdSet> versions(1);
+    std::vector<std::set<int>> expected(1);
+
+    for (int step = 0; step < 20000; ++step) {
+        std::size_t v = rng() % versions.size();
+        unsigned op = rng() % 10;
+        if (op == 0 && versions.size() < 8) {
+            versions.push_back(versions[v]);
+            expected.push_back(expected[v]);
+        } else if (op < 5) {
+            int id = (int)(rng() % 20000);
+            EXPECT_EQ(versions[v].insert(id), expected[v].insert(id).second);
+        } else if (op < 8) {
+            int id = (int)(rng() % 20000);
+            EXPECT_EQ(versions[v].erase(id), expected[v].erase(id) == 1);
+        } else {
+            // Пакет ID: обычно больше всех прежних, иногда вперемешку.
+            int start = expected[v].empty() ? 0 : *expected[v].rbegin() + 1;
+            if (op == 9) start = (int)(rng() % 20000);
+            std::vector<int> ids;
+            for (int id = start; id < start + 3000; id += 1 + (int)(rng() % 3)) {
+                if (!expected[v].count(id)) ids.push_back(id);
+            }
+            versions[v].insertSorted(ids);
+            expected[v].insert(ids.begin(), ids.end());
+        }
+    }
+
+    for (std::size_t v = 0; v < versions.size(); ++v) {
+        ASSERT_EQ(versions[v].size(), expected[v].size());
+        EXPECT_EQ(versions[v].toVector(), std::vector<int>(expected[v].begin(), expected[v].end()));
+        EXPECT_TRUE(std::equal(versions[v].begin(), versions[v].end(), expected[v].begin()));
+        for (int id = 0; id < 20000; id += 37) EXPECT_EQ(versions[v].contains(id), expected[v].count(id) == 1);
+    }
+}
+
+TEST(TaskStoreTests, Erase_MovesLastTaskAndKeepsLookups) {
+    TaskStore store;
+    for (int id = 1; id <= 5; ++id) {
+        store.insert(Task(id, "T" + std::to_string(id), "D"));
+    }
+
+    store.erase(store.find(2));
+    ASSERT_EQ(store.size(), 4u);
+    EXPECT_FALSE(store.contains(2));
+    for (int id : {1, 3, 4, 5}) {
+        TaskStore::Slot slot = store.find(id);
+        ASSERT_NE(slot, TaskStore::npos);
+        EXPECT_EQ(store.id(slot), id);
+        EXPECT_EQ(store.title(slot), "T" + std::to_string(id));
+    }
+}
+
+TEST(TextPoolTests, Intern_SharesEqualStrings) {
+    TextPool pool;
+    TextPool::Handle a = pool.intern("Исправить баг");
+    TextPool::Handle b = pool.intern("Исправить баг");
+    TextPool::Handle c = pool.intern("Другое");
+
+    EXPECT_EQ(a, b);
+    EXPECT_NE(a, c);
+    EXPECT_EQ(pool.uniqueStrings(), 2u);
+
+    pool.release(a);
+    EXPECT_EQ(pool.view(b), "Исправить баг");
+    pool.release(b);
+    EXPECT_EQ(pool.uniqueStrings(), 1u);
+}
+
+TEST(TextPoolTests, Compact_KeepsHandlesAndDropsDeadBytes) {
+    TextPool pool;
+    std::vector<TextPool::Handle> handles;
+    for (int i = 0; i < 20000; ++i) {
+        handles.push_back(pool.intern("строка номер " + std::to_string(i) + std::string(64, 'x')));
+    }
+    for (int i = 0; i < 20000; i += 2) pool.release(handles[(size_t)i]);
+
+    size_t before = pool.arenaBytes();
+    EXPECT_TRUE(pool.compactIfFragmented());
+    EXPECT_LT(pool.arenaBytes(), before);
+
+    for (int i = 1; i < 20000; i += 2) {
+        EXPECT_EQ(pool.view(handles[(size_t)i]), "строка номер " + std::to_string(i) + std::string(64, 'x'));
+    }
+
+    TextPool copy = pool;
+    pool.release(handles[1]);
+    EXPECT_EQ(copy.view(handles[1]), "строка номер 1" + std::string(64, 'x'));
+}
+
+TEST(TaskStoreTests, RemoveTask_KeepsOtherTextsReadable) {
+    ScrumBoard b;
+    for (int id = 1; id <= 100; ++id) {
+        b.addTask(Task(id, "Общий заголовок", "Описание " + std::to_string(id)));
+    }
+    for (int id = 1; id <= 100; id += 3) b.removeTask(id);
+
+    EXPECT_EQ(b.getTask(2).title(), "Общий заголовок");
+    EXPECT_EQ(b.getTask(99).description(), "Описание 99");
+    EXPECT_EQ(b.getAllTasks().textPool().uniqueStrings(), 1u + b.getAllTasks().size());
+}
+
 static fs::path makeTempJsonPath(const std::string& name) {
     auto p = fs::temp_directory_path() / name;
     std::error_code ec;
@@ -122,7 +726,7 @@ TEST(SerializerTests, SerializeDeserialize_RoundTrip_PreservesTasksAndDevelopers
     ASSERT_EQ(loaded.getAllTasks().size(), 4u);
 
     {
-        const Task& x = loaded.getTask(1);
+        const TaskView x = loaded.getTask(1);
         EXPECT_EQ(x.title(), "Login");
         EXPECT_EQ(x.description(), "Сделать форму логина");
         ASSERT_TRUE(x.assignedDeveloper().has_value());
@@ -130,7 +734,7 @@ TEST(SerializerTests, SerializeDeserialize_RoundTrip_PreservesTasksAndDevelopers
         EXPECT_EQ(x.status(), TaskStatus::Assigned);
     }
     {
-        const Task& x = loaded.getTask(2);
+        const TaskView x = loaded.getTask(2);
         EXPECT_EQ(x.title(), "API");
         EXPECT_EQ(x.description(), "Сделать эндпоинт /tasks");
         ASSERT_TRUE(x.assignedDeveloper().has_value());
@@ -138,7 +742,7 @@ TEST(SerializerTests, SerializeDeserialize_RoundTrip_PreservesTasksAndDevelopers
         EXPECT_EQ(x.status(), TaskStatus::InProgress);
     }
     {
-        const Task& x = loaded.getTask(3);
+        const TaskView x = loaded.getTask(3);
         EXPECT_EQ(x.title(), "UI");
         EXPECT_EQ(x.description(), "Сверстать колонки");
         ASSERT_TRUE(x.assignedDeveloper().has_value());
@@ -146,7 +750,7 @@ TEST(SerializerTests, SerializeDeserialize_RoundTrip_PreservesTasksAndDevelopers
         EXPECT_EQ(x.status(), TaskStatus::Blocked);
     }
     {
-        const Task& x = loaded.getTask(4);
+        const TaskView x = loaded.getTask(4);
         EXPECT_EQ(x.title(), "Docs");
         EXPECT_EQ(x.description(), "Описать проект");
         ASSERT_TRUE(x.assignedDeveloper().has_value());
@@ -157,3 +761,1663 @@ TEST(SerializerTests, SerializeDeserialize_RoundTrip_PreservesTasksAndDevelopers
     std::error_code ec;
     fs::remove(tmp, ec);
 }
+
+TEST(SerializerTests, StreamingWrite_MatchesJsonDump) {
+    ScrumBoard b;
+    b.addDeveloper(Developer(1, "Alice \"A\""));
+    b.addTask(Task(1, "Tab\there", "Строка\nс переводом \\ и \x01"));
+    b.assignTask(1, 1);
+    b.addTask(Task(2, "Empty desc", ""));
+
+    std::ostringstream pretty;
+    BoardSerializer::write(b, pretty);
+    EXPECT_EQ(pretty.str(), BoardSerializer::serialize(b).dump(4));
+
+    std::ostringstream compact;
+    BoardSerializer::write(b, compact, JsonFormat::Compact);
+    EXPECT_EQ(compact.str(), BoardSerializer::serialize(b).dump());
+
+    std::ostringstream empty;
+    BoardSerializer::write(ScrumBoard(), empty);
+    EXPECT_EQ(empty.str(), BoardSerializer::serialize(ScrumBoard()).dump(4));
+
+    // Текст не в UTF-8 (Latin-1, обрыв, суррогат) не делает файл нечитаемым.
+    EXPECT_TRUE(isValidUtf8("Задача \xF0\x9F\x98\x80"));
+    EXPECT_FALSE(isValidUtf8("Caf\xE9"));
+    EXPECT_FALSE(isValidUtf8("\xED\xA0\x80"));
+    EXPECT_FALSE(isValidUtf8("\xC0\xAF"));
+    ScrumBoard latin;
+    latin.addTask(Task(1, "Caf\xE9", "\xD0"));
+    std::ostringstream out;
+    BoardSerializer::write(latin, out);
+    std::istringstream in(out.str());
+    ScrumBoard loaded = BoardSerializer::read(in);
+    EXPECT_EQ(loaded.getTask(1).title(), "Caf\xEF\xBF\xBD");
+    EXPECT_EQ(loaded.getTask(1).description(), "\xEF\xBF\xBD");
+}
+
+TEST(SerializerTests, RecordWriter_MatchesWholeBoardWrite) {
+    ScrumBoard b;
+    b.addDeveloper(Developer(1, "Alice"));
+    b.addTask(Task(1, "T", "D"));
+    b.assignTask(1, 1);
+
+    for (JsonFormat format : {JsonFormat::Pretty, JsonFormat::Compact}) {
+        std::ostringstream whole;
+        BoardSerializer::write(b, whole, format);
+
+        std::ostringstream records;
+        BoardRecordWriter writer(records, format);
+        writer.developer(1, "Alice");
+        writer.task(b.getTask(1));
+        EXPECT_THROW(writer.developer(2, "Bob"), std::logic_error);
+        writer.finish();
+        EXPECT_EQ(records.str(), whole.str());
+    }
+
+    std::ostringstream noTasks;
+    BoardRecordWriter writer(noTasks, JsonFormat::Compact);
+    writer.finish();
+    EXPECT_EQ(noTasks.str(), BoardSerializer::serialize(ScrumBoard()).dump());
+}
+
+TEST(SerializerTests, StreamingRead_TasksBeforeDevelopers_RestoresAssignments) {
+    std::istringstream in(R"({"tasks": [
+        {"id": 7, "title": "T", "description": "d", "status": "InProgress", "assignedDeveloperId": 3},
+        {"id": 2, "title": "U", "description": "", "status": "Backlog", "assignedDeveloperId": null}
+    ], "developers": [{"id": 3, "name": "Carol"}]})");
+
+    ScrumBoard loaded = BoardSerializer::read(in);
+
+    ASSERT_EQ(loaded.getAllTasks().size(), 2u);
+    EXPECT_EQ(loaded.getTask(7).status(), TaskStatus::InProgress);
+    EXPECT_EQ(*loaded.getTask(7).assignedDeveloper(), 3);
+    EXPECT_FALSE(loaded.getTask(2).assignedDeveloper().has_value());
+    EXPECT_EQ(loaded.peekNextTaskId(), 8);
+    EXPECT_EQ(loaded.peekNextDeveloperId(), 4);
+}
+
+static std::string generateBoard(const BoardGeneratorOptions& options) {
+    std::ostringstream out;
+    BoardRecordWriter writer(out, JsonFormat::Compact);
+    BoardGenerator(options).write(writer);
+    return out.str();
+}
+
+TEST(GeneratorTests, SameSeed_SameValidBoard) {
+    BoardGeneratorOptions options;
+    options.tasks = 3000;
+    options.developers = 40;
+    options.seed = 17;
+    options.owners = OwnerDistribution::Skewed;
+    options.idStride = 50;
+    options.escapedText = true;
+
+    std::string json = generateBoard(options);
+    EXPECT_EQ(generateBoard(options), json);
+    options.seed = 18;
+    EXPECT_NE(generateBoard(options), json);
+
+    std::istringstream in(json);
+    BoardLoadReport report;
+    ScrumBoard board = BoardSerializer::read(in, report);
+    EXPECT_TRUE(report.clean());
+    ASSERT_EQ(board.getAllTasks().size(), 3000u);
+    EXPECT_EQ(board.getAllDevelopers().size(), 40u);
+
+    // Пропуски в ID и спецсимволы в тексте действительно есть.
+    EXPECT_GT(board.peekNextTaskId(), 3000 * 10);
+    bool escaped = false;
+    for (const TaskView& task : board.getAllTasks()) {
+        escaped = escaped || task.description().find('\n') != std::string_view::npos;
+        ASSERT_GE(task.title().size(), options.titleLength.min);
+        ASSERT_LE(task.title().size(), options.titleLength.max);
+        ASSERT_TRUE(isValidUtf8(task.title())) << task.title();
+        ASSERT_TRUE(isValidUtf8(task.description())) << task.description();
+    }
+    EXPECT_TRUE(escaped);
+
+    // У первого разработчика задач больше, чем у последнего.
+    std::map<int, int> owned;
+    for (const TaskView& task : board.getAllTasks()) {
+        if (task.assignedDeveloper()) ++owned[*task.assignedDeveloper()];
+    }
+    EXPECT_GT(owned[1], 5 * owned[40]);
+}
+
+TEST(GeneratorTests, StatusWeightsAndSingleOwner) {
+    BoardGeneratorOptions options;
+    options.tasks = 2000;
+    options.developers = 10;
+    options.statusWeights = {0, 0, 50, 0, 50};
+    options.assignedShare = 0;
+    options.owners = OwnerDistribution::SingleOwner;
+    options.titleLength = {5, 5};
+    options.descriptionLength = {1000, 2000};
+
+    std::istringstream in(generateBoard(options));
+    ScrumBoard board = BoardSerializer::read(in);
+
+    std::size_t inProgress = board.taskIdsByStatus(TaskStatus::InProgress).size();
+    std::size_t done = board.taskIdsByStatus(TaskStatus::Done).size();
+    EXPECT_EQ(inProgress + done, 2000u);
+    EXPECT_NEAR((double)inProgress, 1000.0, 150.0);
+    for (const TaskView& task : board.getAllTasks()) {
+        // В работе — обязательно у единственного исполнителя, готовые — без него.
+        EXPECT_EQ(task.assignedDeveloper().has_value(), task.status() == TaskStatus::InProgress);
+        if (task.assignedDeveloper()) {
+            EXPECT_EQ(*task.assignedDeveloper(), 1);
+        }
+        EXPECT_EQ(task.title().size(), 5u);
+        EXPECT_GE(task.description().size(), 1000u);
+        EXPECT_LE(task.description().size(), 2000u);
+    }
+
+    options.developers = 0;
+    EXPECT_THROW(BoardGenerator{options}, std::invalid_argument);
+}
+
+TEST(SerializerTests, StreamingRead_BrokenJson_Throws) {
+    std::istringstream truncated(R"({"developers": [{"id": 1, "name": "A"})");
+    EXPECT_THROW(BoardSerializer::read(truncated), std::runtime_error);
+
+    std::istringstream missingTitle(R"({"developers": [], "tasks": [{"id": 1, "description": "", "status": "Backlog"}]})");
+    EXPECT_THROW(BoardSerializer::read(missingTitle), std::runtime_error);
+}
+
+TEST(SerializerTests, TolerantLoad_ReportsEveryProblem) {
+    const std::string json = R"({
+        "developers": [
+            {"id": 1, "name": "Alice"},
+            {"id": 1, "name": "Дубликат"},
+            {"name": "Без ID"},
+            {"id": 2, "name": ""}
+        ],
+        "tasks": [
+            {"id": 1, "title": "Хорошая", "description": "", "status": "InProgress", "assignedDeveloperId": 1},
+            {"id": 1, "title": "Дубликат", "description": "", "status": "Backlog"},
+            {"id": 2, "title": "Статус", "description": "", "status": "Someday"},
+            {"id": 3, "title": "Чужой", "description": "", "status": "Done", "assignedDeveloperId": 42},
+            {"id": 4, "title": "", "description": "", "status": "Backlog"},
+            {"id": 5, "title": "Без исполнителя", "description": "", "status": "InProgress"},
+            {"id": 6, "title": "Последняя", "description": "", "status": "Blocked"}
+        ]
+    })";
+
+    std::istringstream strict(json);
+    EXPECT_THROW(BoardSerializer::read(strict), std::runtime_error);
+
+    std::istringstream in(json);
+    BoardLoadReport streamed;
+    ScrumBoard board = BoardSerializer::read(in, streamed);
+    BoardLoadReport fromDom;
+    ScrumBoard domBoard = BoardSerializer::deserialize(nlohmann::json::parse(json), fromDom);
+
+    for (const BoardLoadReport* report : {&streamed, &fromDom}) {
+        ASSERT_EQ(report->issues.size(), 8u);
+        EXPECT_EQ(report->issues[0].kind, BoardRecordKind::Developer);
+        EXPECT_EQ(report->issues[0].error, BoardError::DuplicateDeveloper);
+        EXPECT_EQ(report->issues[1].index, 2u);
+        EXPECT_EQ(report->issues[1].error, BoardError::None);
+        EXPECT_EQ(report->issues[2].index, 3u);
+        EXPECT_EQ(report->issues[2].id, std::optional<int>(2));
+        EXPECT_EQ(report->issues[2].error, BoardError::EmptyName);
+        EXPECT_EQ(report->issues[3].error, BoardError::DuplicateTask);
+        EXPECT_EQ(report->issues[4].id, std::optional<int>(2));
+        EXPECT_EQ(report->issues[5].error, BoardError::EmptyTitle);
+        EXPECT_EQ(report->issues[6].error, BoardError::DeveloperRequired);
+        // Отложенное назначение проверяется в конце файла.
+        EXPECT_EQ(report->issues[7].index, 3u);
+        EXPECT_EQ(report->issues[7].error, BoardError::DeveloperNotFound);
+    }
+
+    for (const ScrumBoard* b : {&board, &domBoard}) {
+        EXPECT_EQ(b->getAllDevelopers().size(), 1u);
+        EXPECT_EQ(b->getAllTasks().size(), 4u);
+        EXPECT_EQ(b->getTask(1).title(), "Хорошая");
+        EXPECT_EQ(b->getTask(1).status(), TaskStatus::InProgress);
+        EXPECT_EQ(b->getTask(3).status(), TaskStatus::Done);
+        EXPECT_FALSE(b->getTask(3).assignedDeveloper().has_value());
+        EXPECT_EQ(b->getTask(5).status(), TaskStatus::Backlog);
+        EXPECT_EQ(b->getTask(6).status(), TaskStatus::Blocked);
+        EXPECT_EQ(b->peekNextTaskId(), 7);
+    }
+}
+
+static ScrumBoard makeSnapshotBoard() {
+    ScrumBoard b;
+    b.addDeveloper(Developer(1, "Alice"));
+    b.addDeveloper(Developer(40, "Bob"));
+    b.addTask(Task(5, "Login", "Сделать форму логина"));
+    b.assignTask(5, 1);
+    b.changeTaskStatus(5, TaskStatus::InProgress);
+    b.addTask(Task(2, "Docs", ""));
+    b.addTask(Task(9, "Login", "Сделать форму логина"));
+    b.assignTask(9, 40);
+    b.changeTaskStatus(9, TaskStatus::Done);
+    b.setNextTaskId(12);
+    b.setNextDeveloperId(41);
+    return b;
+}
+
+// Разработчики и задачи совпадают; счётчики ID не сравниваются.
+static void expectSameContent(const ScrumBoard& expected, const ScrumBoard& actual) {
+    ASSERT_EQ(actual.getAllDevelopers().size(), expected.getAllDevelopers().size());
+    for (const Developer& dev : expected.getAllDevelopers()) {
+        EXPECT_EQ(actual.getDeveloper(dev.id()).name(), dev.name());
+    }
+    ASSERT_EQ(actual.getAllTasks().size(), expected.getAllTasks().size());
+    for (const TaskView& task : expected.getAllTasks()) {
+        const TaskView x = actual.getTask(task.id());
+        EXPECT_EQ(x.title(), task.title());
+        EXPECT_EQ(x.description(), task.description());
+        EXPECT_EQ(x.status(), task.status());
+        EXPECT_EQ(x.assignedDeveloper(), task.assignedDeveloper());
+    }
+    for (TaskStatus status : {TaskStatus::Backlog, TaskStatus::Assigned, TaskStatus::InProgress,
+                              TaskStatus::Blocked, TaskStatus::Done}) {
+        EXPECT_EQ(actual.getTaskIdsByStatus(status), expected.getTaskIdsByStatus(status));
+    }
+}
+
+static void expectSameBoard(const ScrumBoard& expected, const ScrumBoard& actual) {
+    expectSameContent(expected, actual);
+    EXPECT_EQ(actual.peekNextTaskId(), expected.peekNextTaskId());
+    EXPECT_EQ(actual.peekNextDeveloperId(), expected.peekNextDeveloperId());
+}
+
+TEST(SerializerTests, Snapshot_RoundTrip_PreservesTasksAndDevelopers) {
+    ScrumBoard b = makeSnapshotBoard();
+
+    auto tmp = makeTempJsonPath("scrum_board_test.kbsnap");
+    saveBoardSnapshot(b, tmp.string());
+    expectSameBoard(b, loadBoardSnapshot(tmp.string()));
+
+    std::error_code ec;
+    fs::remove(tmp, ec);
+}
+
+TEST(SerializerTests, Snapshot_MappedReader_ServesViewsAndFindsById) {
+    ScrumBoard b = makeSnapshotBoard();
+
+    auto tmp = makeTempJsonPath("scrum_board_mapped.kbsnap");
+    saveBoardSnapshot(b, tmp.string());
+    {
+        BoardSnapshot snap = BoardSnapshot::open(tmp.string());
+        EXPECT_EQ(snap.taskCount(), 3u);
+        EXPECT_EQ(snap.developerCount(), 2u);
+        EXPECT_EQ(snap.developerName(1), "Bob");
+
+        std::optional<TaskView> t = snap.findTask(9);
+        ASSERT_TRUE(t.has_value());
+        EXPECT_EQ(t->title(), "Login");
+        EXPECT_EQ(t->status(), TaskStatus::Done);
+        EXPECT_EQ(t->assignedDeveloper(), std::optional<int>(40));
+
+        // Одинаковые строки лежат в таблице один раз.
+        EXPECT_EQ(t->description().data(), snap.findTask(5)->description().data());
+        EXPECT_FALSE(snap.findTask(7).has_value());
+    }
+
+    std::error_code ec;
+    fs::remove(tmp, ec);
+}
+
+TEST(SerializerTests, Snapshot_CorruptedFile_Throws) {
+    auto tmp = makeTempJsonPath("scrum_board_corrupt.kbsnap");
+    saveBoardSnapshot(makeSnapshotBoard(), tmp.string());
+
+    {
+        std::fstream f(tmp, std::ios::in | std::ios::out | std::ios::binary);
+        f.seekp(-3, std::ios::end);
+        f.put('#');
+    }
+    EXPECT_THROW(BoardSnapshot::open(tmp.string()), std::runtime_error);
+    EXPECT_NO_THROW(BoardSnapshot::open(tmp.string(), BoardSnapshot::Verify::HeaderOnly));
+
+    // Заголовок тоже под контрольной суммой: следующий ID задачи не
+    // проверяется по смещениям и иначе прошёл бы незамеченным.
+    saveBoardSnapshot(makeSnapshotBoard(), tmp.string());
+    {
+        std::fstream f(tmp, std::ios::in | std::ios::out | std::ios::binary);
+        f.seekp(offsetof(snapshot::Header, nextTaskId));
+        f.put('\x7f');
+    }
+    EXPECT_THROW(BoardSnapshot::open(tmp.string()), std::runtime_error);
+
+    // Исполнитель, которого нет среди разработчиков, — не повреждение файла.
+    saveBoardSnapshot(makeSnapshotBoard(), tmp.string());
+    {
+        snapshot::Header header;
+        std::fstream f(tmp, std::ios::in | std::ios::out | std::ios::binary);
+        f.read(reinterpret_cast<char*>(&header), sizeof(header));
+        std::int32_t missing = 41;
+        f.seekp((std::streamoff)(header.developersOffset + sizeof(snapshot::DeveloperRecord)));
+        f.write(reinterpret_cast<const char*>(&missing), sizeof(missing));
+    }
+    try {
+        BoardSnapshot::open(tmp.string(), BoardSnapshot::Verify::HeaderOnly).toBoard();
+        FAIL() << "чужой исполнитель не обнаружен";
+    } catch (const std::runtime_error& e) {
+        EXPECT_EQ(std::string(e.what()), "Задача 9 назначена несуществующему разработчику 40");
+    }
+
+    {
+        std::ofstream f(tmp, std::ios::binary);
+        f << "{\"developers\": [], \"tasks\": []} and some padding to exceed the header size ....";
+    }
+    EXPECT_THROW(BoardSnapshot::open(tmp.string()), std::runtime_error);
+
+    std::error_code ec;
+    fs::remove(tmp, ec);
+}
+
+TEST(SerializerTests, Snapshot_ConvertersBothWays_PreserveBoard) {
+    ScrumBoard b = makeSnapshotBoard();
+
+    auto json = makeTempJsonPath("scrum_board_convert.json");
+    auto snap = makeTempJsonPath("scrum_board_convert.kbsnap");
+    auto back = makeTempJsonPath("scrum_board_convert_back.json");
+
+    saveBoardToFile(b, json.string());
+    convertJsonToSnapshot(json.string(), snap.string());
+    convertSnapshotToJson(snap.string(), back.string());
+
+    ScrumBoard loaded = loadBoardFromFile(back.string());
+    ASSERT_EQ(loaded.getAllTasks().size(), 3u);
+    EXPECT_EQ(loaded.getTask(5).status(), TaskStatus::InProgress);
+    EXPECT_EQ(loaded.getTask(9).assignedDeveloper(), std::optional<int>(40));
+    EXPECT_EQ(loaded.getDeveloper(40).name(), "Bob");
+
+    std::error_code ec;
+    fs::remove(json, ec);
+    fs::remove(snap, ec);
+    fs::remove(back, ec);
+}
+
+static fs::path makeTempDir(const std::string& name) {
+    auto p = fs::temp_directory_path() / name;
+    std::error_code ec;
+    fs::remove_all(p, ec);
+    fs::create_directories(p);
+    return p;
+}
+
+static size_t countJournalSegments(const fs::path& dir) {
+    size_t count = 0;
+    for (const auto& entry : fs::directory_iterator(dir)) {
+        if (entry.path().filename().string().find(".journal.") != std::string::npos) ++count;
+    }
+    return count;
+}
+
+TEST(JournalTests, Mutations_AreReplayedOnLoad) {
+    auto dir = makeTempDir("kanban_journal_replay");
+    std::string path = (dir / "board.kbsnap").string();
+    {
+        ScrumBoard b;
+        BoardJournal journal(b, path);
+        b.addDeveloper(Developer(1, "Alice"));
+        b.addDeveloper(Developer(2, "Bob"));
+        b.addTask(Task(1, "Login", "Форма"));
+        b.addTask(Task(2, "API", "Эндпоинт"));
+        b.addTask(Task(3, "Tmp", "Удалить"));
+        b.assignTask(1, 2);
+        b.changeTaskStatus(1, TaskStatus::InProgress);
+        b.removeTask(3);
+        b.removeDeveloper(1);
+        EXPECT_EQ(journal.sequence(), 9u);
+    }
+
+    ScrumBoard loaded = BoardJournal::load(path);
+    ASSERT_EQ(loaded.getAllTasks().size(), 2u);
+    EXPECT_EQ(loaded.getTask(1).status(), TaskStatus::InProgress);
+    EXPECT_EQ(loaded.getTask(1).assignedDeveloper(), std::optional<int>(2));
+    EXPECT_FALSE(loaded.findTask(3).has_value());
+    EXPECT_EQ(loaded.findDeveloper(1), nullptr);
+    EXPECT_EQ(loaded.peekNextTaskId(), 4);
+
+    std::error_code ec;
+    fs::remove_all(dir, ec);
+}
+
+TEST(JournalTests, Compaction_FoldsJournalIntoSnapshot) {
+    auto dir = makeTempDir("kanban_journal_compact");
+    std::string path = (dir / "board.kbsnap").string();
+    {
+        ScrumBoard b;
+        BoardJournal journal(b, path);
+        b.addDeveloper(Developer(1, "Alice"));
+        for (int id = 1; id <= 50; ++id) b.addTask(Task(id, "Задача", "Описание"));
+        b.assignTask(7, 1);
+
+        ASSERT_TRUE(journal.compact());
+        // Изменения во время уплотнения попадают в новый сегмент.
+        b.changeTaskStatus(7, TaskStatus::Done);
+        journal.waitForCompaction();
+
+        EXPECT_TRUE(fs::exists(path));
+        EXPECT_EQ(countJournalSegments(dir), 1u);
+        EXPECT_EQ(BoardSnapshot::open(path).journalSequence(), 52u);
+    }
+
+    // При повторном открытии запись продолжается с того же номера.
+    {
+        ScrumBoard b;
+        BoardJournal journal(b, path);
+        EXPECT_EQ(journal.sequence(), 53u);
+        EXPECT_EQ(b.getTask(7).status(), TaskStatus::Done);
+        b.removeTask(50);
+    }
+
+    ScrumBoard loaded = BoardJournal::load(path);
+    EXPECT_EQ(loaded.getAllTasks().size(), 49u);
+    EXPECT_EQ(loaded.getTask(7).status(), TaskStatus::Done);
+
+    std::error_code ec;
+    fs::remove_all(dir, ec);
+}
+
+// Удалённый разработчик не остаётся исполнителем: иначе уплотнение
+// записало бы снимок, который не открывается.
+TEST(JournalTests, RemovedDeveloper_LeavesNoAssignmentsAfterCompaction) {
+    auto dir = makeTempDir("kanban_journal_remove_developer");
+    std::string path = (dir / "board.kbsnap").string();
+    ScrumBoard expected;
+    {
+        ScrumBoard b;
+        BoardJournal journal(b, path);
+        BoardHistory history(b);
+        b.addDeveloper(Developer(1, "Alice"));
+        b.addDeveloper(Developer(2, "Bob"));
+        for (int id = 1; id <= 4; ++id) b.addTask(Task(id, "Задача", ""));
+        b.assignTask(1, 1);
+        b.assignTask(2, 1);
+        b.changeTaskStatus(2, TaskStatus::InProgress);
+        b.assignTask(3, 1);
+        b.changeTaskStatus(3, TaskStatus::Done);
+        b.assignTask(4, 2);
+
+        b.removeDeveloper(1);
+        EXPECT_EQ(b.getTask(1).status(), TaskStatus::Backlog);
+        EXPECT_EQ(b.getTask(2).status(), TaskStatus::Backlog);
+        EXPECT_EQ(b.getTask(3).status(), TaskStatus::Done);
+        for (int id = 1; id <= 3; ++id) EXPECT_FALSE(b.getTask(id).assignedDeveloper().has_value()) << id;
+        EXPECT_EQ(b.getTask(4).assignedDeveloper(), std::optional<int>(2));
+        EXPECT_EQ(b.countTasks(TaskStatus::InProgress), 0u);
+        expectSameContent(b, BoardJournal::load(path));
+
+        // Отмена возвращает и разработчика, и его задачи; повтор снова их снимает.
+        ASSERT_TRUE(history.undo());
+        EXPECT_EQ(b.getTask(2).assignedDeveloper(), std::optional<int>(1));
+        EXPECT_EQ(b.getTask(2).status(), TaskStatus::InProgress);
+        expectSameContent(b, BoardJournal::load(path));
+        ASSERT_TRUE(history.redo());
+
+        ASSERT_TRUE(journal.compact());
+        journal.waitForCompaction();
+        expected = b;
+    }
+
+    ScrumBoard reopened = loadBoardSnapshot(path);
+    expectSameContent(expected, reopened);
+    expectSameContent(expected, BoardJournal::load(path));
+
+    std::error_code ec;
+    fs::remove_all(dir, ec);
+}
+
+TEST(JournalTests, TornLastRecord_IsIgnored) {
+    auto dir = makeTempDir("kanban_journal_torn");
+    std::string path = (dir / "board.kbsnap").string();
+    {
+        ScrumBoard b;
+        BoardJournal journal(b, path);
+        b.addTask(Task(1, "A", "a"));
+        b.addTask(Task(2, "B", "b"));
+    }
+
+    fs::path segment;
+    for (const auto& entry : fs::directory_iterator(dir)) segment = entry.path();
+    fs::resize_file(segment, fs::file_size(segment) - 3);
+
+    ScrumBoard loaded = BoardJournal::load(path);
+    EXPECT_EQ(loaded.getAllTasks().size(), 1u);
+    EXPECT_TRUE(loaded.findTask(1).has_value());
+
+    {
+        ScrumBoard b;
+        BoardJournal journal(b, path);
+        b.addTask(Task(5, "C", "c"));
+    }
+    loaded = BoardJournal::load(path);
+    EXPECT_EQ(loaded.getAllTasks().size(), 2u);
+    EXPECT_TRUE(loaded.findTask(5).has_value());
+
+    std::error_code ec;
+    fs::remove_all(dir, ec);
+}
+
+TEST(JournalTests, ReplaceWith_WritesSnapshotImmediately) {
+    auto dir = makeTempDir("kanban_journal_reset");
+    std::string path = (dir / "board.kbsnap").string();
+    {
+        ScrumBoard b;
+        BoardJournal journal(b, path);
+        b.addTask(Task(1, "Old", "o"));
+
+        ScrumBoard other;
+        other.addTask(Task(9, "New", "n"));
+        b.replaceWith(other);
+        EXPECT_EQ(countJournalSegments(dir), 0u);
+    }
+
+    ScrumBoard loaded = BoardJournal::load(path);
+    ASSERT_EQ(loaded.getAllTasks().size(), 1u);
+    EXPECT_EQ(loaded.getTask(9).title(), "New");
+
+    std::error_code ec;
+    fs::remove_all(dir, ec);
+}
+
+TEST(JournalTests, BulkChange_IsHiddenUntilSnapshotIsWritten) {
+    auto dir = makeTempDir("kanban_journal_bulk");
+    auto backup = makeTempDir("kanban_journal_bulk_backup");
+    std::string path = (dir / "board.kbsnap").string();
+    {
+        ScrumBoard b;
+        BoardJournal journal(b, path);
+        b.addTask(Task(1, "До замены", "a"));
+        fs::copy(dir, backup);
+
+        journal.beginBulkChange();
+        b.replaceWith(ScrumBoard());
+        b.addTask(Task(2, "Загружена", "b"));
+        journal.endBulkChange();
+        journal.waitForCompaction();
+        b.addTask(Task(3, "После замены", "c"));
+        EXPECT_EQ(journal.sequence(), 3u);
+    }
+
+    ScrumBoard loaded = BoardJournal::load(path);
+    ASSERT_EQ(loaded.getAllTasks().size(), 2u);
+    EXPECT_TRUE(loaded.findTask(2).has_value());
+    EXPECT_TRUE(loaded.findTask(3).has_value());
+
+    // Сбой до записи снимка: остаются прежние файлы и новый сегмент.
+    fs::remove(path);
+    fs::copy(backup, dir, fs::copy_options::recursive | fs::copy_options::overwrite_existing);
+    loaded = BoardJournal::load(path);
+    ASSERT_EQ(loaded.getAllTasks().size(), 1u);
+    EXPECT_EQ(loaded.getTask(1).title(), "До замены");
+
+    std::error_code ec;
+    fs::remove_all(dir, ec);
+    fs::remove_all(backup, ec);
+}
+
+TEST(ScrumBoardTests, Copy_IsIsolatedFromLaterMutations) {
+    ScrumBoard b;
+    b.addDeveloper(Developer(1, "Alice"));
+    for (int id = 1; id <= 100; ++id) b.addTask(Task(id, "Задача " + std::to_string(id), "Описание"));
+    b.assignTask(10, 1);
+
+    ScrumBoard copy = b;
+
+    b.changeTaskStatus(10, TaskStatus::InProgress);
+    b.removeTask(20);
+    b.addTask(Task(101, "Новая", "Описание"));
+    for (int id = 30; id <= 90; ++id) b.removeTask(id);
+
+    EXPECT_EQ(copy.getAllTasks().size(), 100u);
+    EXPECT_EQ(copy.getTask(10).status(), TaskStatus::Assigned);
+    EXPECT_EQ(copy.getTask(20).title(), "Задача 20");
+    EXPECT_EQ(copy.getTask(50).title(), "Задача 50");
+    EXPECT_FALSE(copy.findTask(101).has_value());
+    EXPECT_EQ(copy.countTasks(TaskStatus::InProgress), 0u);
+
+    EXPECT_EQ(b.getTask(10).status(), TaskStatus::InProgress);
+    EXPECT_EQ(b.getTask(101).title(), "Новая");
+    EXPECT_EQ(b.getAllTasks().size(), 39u);
+}
+
+// Колонки доски по уведомлениям: сколько задач в каждом статусе.
+class StatusCounter {
+public:
+    explicit StatusCounter(ScrumBoard& board) : board_(board) {
+        subscription_ = board_.subscribe([this](const BoardChange& change) {
+            switch (change.kind) {
+            case BoardChange::Kind::TaskAdded: ++counts_[change.newStatus]; break;
+            case BoardChange::Kind::TaskRemoved: --counts_[change.oldStatus]; break;
+            case BoardChange::Kind::TaskStatusChanged:
+            case BoardChange::Kind::TaskAssigned:
+                --counts_[change.oldStatus];
+                ++counts_[change.newStatus];
+                break;
+            case BoardChange::Kind::Reset: ++resets_; break;
+            default: break;
+            }
+        });
+    }
+    ~StatusCounter() { board_.unsubscribe(subscription_); }
+
+    void expectMatchesBoard() {
+        for (TaskStatus status : {TaskStatus::Backlog, TaskStatus::Assigned, TaskStatus::InProgress,
+                                  TaskStatus::Blocked, TaskStatus::Done}) {
+            EXPECT_EQ((std::size_t)counts_[status], board_.countTasks(status));
+        }
+        EXPECT_EQ(resets_, 0);
+    }
+
+private:
+    ScrumBoard& board_;
+    int subscription_ = 0;
+    std::map<TaskStatus, int> counts_;
+    int resets_ = 0;
+};
+
+TEST(BoardHistoryTests, UndoRedo_WalkThroughEveryStep) {
+    ScrumBoard b;
+    BoardHistory history(b);
+    StatusCounter counter(b);
+    std::vector<ScrumBoard> states{b};
+    auto step = [&](auto action) {
+        action();
+        states.push_back(b);
+    };
+
+    step([&] { b.addDeveloper(Developer(1, "Alice")); });
+    step([&] { b.addTask(Task(1, "Login", "Форма")); });
+    step([&] { b.addTask(Task(2, "API", "Эндпоинт")); });
+    step([&] { b.assignTask(1, 1); });
+    step([&] { b.changeTaskStatus(1, TaskStatus::InProgress); });
+    step([&] { b.changeTaskStatuses({1, 2}, TaskStatus::Done); });
+    step([&] { b.removeTask(2); });
+    step([&] { b.removeDeveloper(1); });
+    step([&] { b.addTasks(std::vector<Task>{Task(3, "A", ""), Task(4, "B", ""), Task(5, "C", "")}); });
+    ASSERT_EQ(history.undoCount(), states.size() - 1);
+
+    for (std::size_t i = states.size() - 1; i > 0; --i) {
+        ASSERT_TRUE(history.undo());
+        expectSameContent(states[i - 1], b);
+        counter.expectMatchesBoard();
+    }
+    EXPECT_FALSE(history.undo());
+    EXPECT_EQ(history.redoCount(), states.size() - 1);
+
+    for (std::size_t i = 1; i < states.size(); ++i) {
+        ASSERT_TRUE(history.redo());
+        expectSameContent(states[i], b);
+        counter.expectMatchesBoard();
+    }
+    EXPECT_FALSE(history.redo());
+
+    // Отмена не откатывает счётчик ID, новая правка отбрасывает повтор.
+    b.setNextTaskId(10);
+    ASSERT_TRUE(history.undo());
+    EXPECT_EQ(b.peekNextTaskId(), 10);
+    EXPECT_FALSE(b.findTask(5).has_value());
+    b.addTask(Task(b.getNextTaskId(), "New", ""));
+    EXPECT_FALSE(history.canRedo());
+    ASSERT_TRUE(history.undo());
+    EXPECT_FALSE(b.findTask(10).has_value());
+
+    b.replaceWith(ScrumBoard());
+    EXPECT_FALSE(history.canUndo());
+}
+
+TEST(BoardHistoryTests, UndoRedo_AreJournaledAsOrdinaryChanges) {
+    auto dir = makeTempDir("kanban_history_journal");
+    std::string path = (dir / "board.kbsnap").string();
+    {
+        ScrumBoard b;
+        BoardJournal journal(b, path);
+        BoardHistory history(b);
+        b.addDeveloper(Developer(1, "Alice"));
+        b.addDeveloper(Developer(2, "Bob"));
+        b.addTask(Task(1, "Login", "Форма"));
+        b.addTask(Task(2, "API", "Эндпоинт"));
+        b.assignTask(1, 1);
+        b.changeTaskStatus(1, TaskStatus::InProgress);
+        b.removeTask(2);
+        b.removeDeveloper(2);
+
+        // Возврат удалённых разработчика и задачи, снятие исполнителя.
+        for (int i = 0; i < 4; ++i) ASSERT_TRUE(history.undo());
+        ASSERT_TRUE(history.redo());
+        EXPECT_EQ(b.getTask(1).assignedDeveloper(), std::optional<int>(1));
+        ASSERT_TRUE(history.undo());
+        EXPECT_FALSE(b.getTask(1).assignedDeveloper().has_value());
+        ASSERT_NE(b.findDeveloper(2), nullptr);
+
+        ScrumBoard loaded = BoardJournal::load(path);
+        expectSameContent(b, loaded);
+    }
+
+    std::error_code ec;
+    fs::remove_all(dir, ec);
+}
+
+TEST(SerializerTests, BackgroundSave_WritesStateAtCallTime) {
+    std::promise<void> release;
+    std::shared_future<void> released = release.get_future().share();
+    std::promise<std::string> finished;
+
+    BoardSaver saver([released](const ScrumBoard& board, const std::string& filename) {
+        released.wait();
+        saveBoardToFile(board, filename);
+    });
+
+    ScrumBoard b;
+    b.addTask(Task(1, "До сохранения", "d"));
+
+    auto tmp = makeTempJsonPath("scrum_board_background.json");
+    ASSERT_TRUE(saver.save(b, tmp.string(), [&finished](const std::string& error) {
+        finished.set_value(error);
+    }));
+    EXPECT_TRUE(saver.busy());
+    EXPECT_FALSE(saver.save(b, tmp.string()));
+
+    // Пока идёт сохранение, доска свободно меняется.
+    b.addTask(Task(2, "После", "d"));
+    b.removeTask(1);
+    release.set_value();
+
+    EXPECT_EQ(finished.get_future().get(), "");
+    saver.wait();
+    EXPECT_FALSE(saver.busy());
+
+    ScrumBoard loaded = loadBoardFromFile(tmp.string());
+    ASSERT_EQ(loaded.getAllTasks().size(), 1u);
+    EXPECT_EQ(loaded.getTask(1).title(), "До сохранения");
+    EXPECT_FALSE(fs::exists(tmp.string() + ".tmp"));
+
+    std::error_code ec;
+    fs::remove(tmp, ec);
+}
+
+TEST(SerializerTests, BackgroundSave_ReportsErrorAndKeepsOldFile) {
+    auto tmp = makeTempJsonPath("scrum_board_keep.json");
+    ScrumBoard b;
+    b.addTask(Task(1, "Старая", "d"));
+    saveBoardToFile(b, tmp.string());
+
+    BoardSaver saver([](const ScrumBoard& board, const std::string& filename) {
+        writeFileAtomically(filename, [&board](std::ostream& out) {
+            BoardSerializer::write(board, out);
+            throw std::runtime_error("диск заполнен");
+        });
+    });
+
+    std::promise<std::string> finished;
+    b.addTask(Task(2, "Новая", "d"));
+    ASSERT_TRUE(saver.save(b, tmp.string(), [&finished](const std::string& error) {
+        finished.set_value(error);
+    }));
+    EXPECT_EQ(finished.get_future().get(), "диск заполнен");
+
+    ScrumBoard loaded = loadBoardFromFile(tmp.string());
+    EXPECT_EQ(loaded.getAllTasks().size(), 1u);
+    EXPECT_FALSE(fs::exists(tmp.string() + ".tmp"));
+
+    std::error_code ec;
+    fs::remove(tmp, ec);
+}
+
+static ScrumBoard makeLoaderBoard(int taskCount) {
+    ScrumBoard b;
+    for (int id = 1; id <= 5; ++id) b.addDeveloper(Developer(id, "Dev " + std::to_string(id)));
+    for (int id = 1; id <= taskCount; ++id) {
+        // Порядок хранения не совпадает с порядком ID.
+        int taskId = id % 2 ? id : taskCount * 2 - id;
+        b.addTask(Task(taskId, "Задача " + std::to_string(taskId), id % 3 ? "Описание" : ""));
+        if (id % 4) b.assignTask(taskId, id % 5 + 1);
+        if (id % 4 == 2) b.changeTaskStatus(taskId, TaskStatus::InProgress);
+        if (id % 8 == 3) b.changeTaskStatus(taskId, TaskStatus::Done);
+    }
+    return b;
+}
+
+TEST(SerializerTests, ProgressiveLoad_MatchesBlockingLoad) {
+    auto tmp = makeTempJsonPath("scrum_board_progressive.json");
+    saveBoardToFile(makeLoaderBoard(20000), tmp.string());
+    ScrumBoard expected = loadBoardFromFile(tmp.string());
+
+    ScrumBoard b;
+    int batches = 0;
+    int subscription = b.subscribe([&batches](const BoardChange& change) {
+        if (change.kind == BoardChange::Kind::BatchBegin) ++batches;
+    });
+
+    BoardLoader loader(tmp.string());
+    size_t applied = 0;
+    while (!loader.applyPending(b, 3000)) {
+        // Один вызов применяет не больше заданного числа задач.
+        EXPECT_LE(loader.progress().tasksApplied - applied, 3000u);
+        applied = loader.progress().tasksApplied;
+        std::this_thread::yield();
+    }
+    b.unsubscribe(subscription);
+
+    ASSERT_EQ(loader.state(), BoardLoader::State::Finished);
+    EXPECT_GE(batches, 7);
+    EXPECT_EQ(loader.progress().tasksApplied, 20000u);
+    EXPECT_EQ(loader.progress().bytesRead, loader.progress().totalBytes);
+    expectSameBoard(expected, b);
+
+    // Совпадает и порядок хранения.
+    std::vector<int> expectedOrder, actualOrder;
+    for (const TaskView& task : expected.getAllTasks()) expectedOrder.push_back(task.id());
+    for (const TaskView& task : b.getAllTasks()) actualOrder.push_back(task.id());
+    EXPECT_EQ(actualOrder, expectedOrder);
+    for (TaskStatus status : {TaskStatus::Backlog, TaskStatus::Assigned, TaskStatus::InProgress, TaskStatus::Done}) {
+        EXPECT_EQ(b.getTaskIdsByStatus(status), expected.getTaskIdsByStatus(status));
+    }
+
+    std::error_code ec;
+    fs::remove(tmp, ec);
+}
+
+TEST(SerializerTests, ProgressiveLoad_DeferredAssignmentsAndErrors) {
+    auto tmp = makeTempJsonPath("scrum_board_progressive_order.json");
+    {
+        std::ofstream out(tmp);
+        out << R"({"tasks": [
+            {"id": 7, "title": "T", "description": "d", "status": "InProgress", "assignedDeveloperId": 3}
+        ], "developers": [{"id": 3, "name": "Carol"}]})";
+    }
+    ScrumBoard b;
+    BoardLoader loader(tmp.string());
+    while (!loader.applyPending(b)) std::this_thread::yield();
+    ASSERT_EQ(loader.state(), BoardLoader::State::Finished);
+    expectSameBoard(loadBoardFromFile(tmp.string()), b);
+
+    {
+        std::ofstream out(tmp);
+        out << R"({"developers": [{"id": 1, "name": "A"}], "tasks": [{"id": 1, "title": "T", )";
+    }
+    ScrumBoard broken;
+    BoardLoader failing(tmp.string());
+    while (!failing.applyPending(broken)) std::this_thread::yield();
+    EXPECT_EQ(failing.state(), BoardLoader::State::Failed);
+    EXPECT_FALSE(failing.error().empty());
+
+    ScrumBoard missing;
+    BoardLoader absent((tmp.string() + ".missing"));
+    while (!absent.applyPending(missing)) std::this_thread::yield();
+    EXPECT_EQ(absent.state(), BoardLoader::State::Failed);
+
+    std::error_code ec;
+    fs::remove(tmp, ec);
+}
+
+TEST(SerializerTests, ProgressiveLoad_CancelStopsLoading) {
+    auto tmp = makeTempJsonPath("scrum_board_progressive_cancel.json");
+    saveBoardToFile(makeLoaderBoard(50000), tmp.string());
+
+    ScrumBoard b;
+    BoardLoader loader(tmp.string());
+    while (b.getAllTasks().size() == 0) {
+        ASSERT_FALSE(loader.applyPending(b, 100));
+    }
+    loader.cancel();
+    EXPECT_TRUE(loader.applyPending(b));
+    EXPECT_EQ(loader.state(), BoardLoader::State::Cancelled);
+    EXPECT_LT(b.getAllTasks().size(), 50000u);
+
+    std::error_code ec;
+    fs::remove(tmp, ec);
+}
+
+TEST(SerializerTests, ParallelWrite_MatchesSequentialWrite) {
+    ScrumBoard big = makeLoaderBoard(5000);
+    ScrumBoard small = makeSnapshotBoard();
+    for (const ScrumBoard* board : {&big, &small}) {
+        for (JsonFormat format : {JsonFormat::Pretty, JsonFormat::Compact}) {
+            std::ostringstream expected;
+            BoardSerializer::write(*board, expected, format);
+            for (unsigned threads : {1u, 2u, 7u, 0u}) {
+                std::ostringstream actual;
+                BoardSerializer::writeParallel(*board, actual, format, threads);
+                EXPECT_EQ(actual.str(), expected.str()) << "threads=" << threads;
+            }
+        }
+    }
+
+    std::ostringstream empty;
+    BoardSerializer::writeParallel(ScrumBoard(), empty, JsonFormat::Pretty, 4);
+    EXPECT_EQ(empty.str(), BoardSerializer::serialize(ScrumBoard()).dump(4));
+}
+
+TEST(SerializerTests, ParallelRead_MatchesSequentialRead) {
+    std::ostringstream out;
+    BoardSerializer::write(makeLoaderBoard(5000), out, JsonFormat::Compact);
+    std::istringstream in(out.str());
+    ScrumBoard expected = BoardSerializer::read(in);
+
+    for (unsigned threads : {1u, 3u, 0u}) {
+        ScrumBoard actual = BoardSerializer::readParallel(out.str(), threads);
+        expectSameBoard(expected, actual);
+
+        std::vector<int> expectedOrder, actualOrder;
+        for (const TaskView& task : expected.getAllTasks()) expectedOrder.push_back(task.id());
+        for (const TaskView& task : actual.getAllTasks()) actualOrder.push_back(task.id());
+        EXPECT_EQ(actualOrder, expectedOrder);
+        EXPECT_EQ(actual.getTaskIdsByStatus(TaskStatus::Done), expected.getTaskIdsByStatus(TaskStatus::Done));
+    }
+
+    // Задачи до разработчиков и назначение при статусе Backlog.
+    const char* json = R"({"tasks": [
+        {"id": 7, "title": "T", "description": "d", "status": "Backlog", "assignedDeveloperId": 3}
+    ], "extra": {"a": [1, "]"]}, "developers": [{"id": 3, "name": "Carol"}]})";
+    std::istringstream reordered(json);
+    expectSameBoard(BoardSerializer::read(reordered), BoardSerializer::readParallel(json, 2));
+}
+
+TEST(SerializerTests, ParallelRead_BrokenInput_Throws) {
+    EXPECT_THROW(BoardSerializer::readParallel(R"({"developers": [{"id": 1, "name": "A"})", 2),
+                 std::runtime_error);
+    EXPECT_THROW(BoardSerializer::readParallel(R"({"tasks": [{"id": 1, "title": "T"} {"id": 2}]})", 2),
+                 std::runtime_error);
+    EXPECT_THROW(BoardSerializer::readParallel(
+                     R"({"tasks": [{"id": 1, "title": "", "description": "", "status": "Backlog"}]})", 2),
+                 std::invalid_argument);
+    EXPECT_THROW(BoardSerializer::readParallel(
+                     R"({"tasks": [{"id": 1, "title": "A", "description": "", "status": "Backlog"},
+                                   {"id": 1, "title": "B", "description": "", "status": "Backlog"}]})", 2),
+                 std::runtime_error);
+}
+
+static std::string boardJson(const ScrumBoard& board) {
+    std::ostringstream out;
+    BoardSerializer::write(board, out, JsonFormat::Compact);
+    return out.str();
+}
+
+// Прогон файла доски через BoardRecordEditor, как это делает kanban_cli.
+static void editBoard(const std::string& json, BoardRecordEditor& editor) {
+    std::istringstream in(json);
+    BoardSerializer::readRecords(in, editor);
+}
+
+TEST(QueryTests, ParseLists) {
+    EXPECT_EQ(parseIdList("5,1-3,2"), (std::vector<int>{1, 2, 3, 5}));
+    EXPECT_EQ(parseIdList("-2--1"), (std::vector<int>{-2, -1}));
+    EXPECT_THROW(parseIdList("3-1"), std::invalid_argument);
+    EXPECT_THROW(parseIdList("1,x"), std::invalid_argument);
+    EXPECT_EQ(parseStatusList("Done,Blocked"), (std::vector<TaskStatus>{TaskStatus::Done, TaskStatus::Blocked}));
+    EXPECT_THROW(parseStatusList("Done,Later"), std::invalid_argument);
+}
+
+TEST(QueryTests, WriterAsHandler_CopiesFileUnchanged) {
+    ScrumBoard b;
+    b.addDeveloper(Developer(1, "Alice"));
+    b.addTask(Task(1, "T", "Строка\n\"в кавычках\""));
+    b.assignTask(1, 1);
+    std::string json = boardJson(b);
+
+    std::ostringstream copy;
+    BoardRecordWriter writer(copy, JsonFormat::Compact);
+    std::istringstream in(json);
+    BoardSerializer::readRecords(in, writer);
+    writer.finish();
+    EXPECT_EQ(copy.str(), json);
+}
+
+TEST(QueryTests, Editor_AppliesBoardRulesAndReportsRejections) {
+    ScrumBoard b;
+    b.addDeveloper(Developer(1, "Alice"));
+    b.addDeveloper(Developer(2, "Bob"));
+    for (int id = 1; id <= 6; ++id) b.addTask(Task(id, "T" + std::to_string(id), ""));
+    b.assignTask(2, 1);
+    b.assignTask(3, 1);
+    b.changeTaskStatus(3, TaskStatus::InProgress);
+    b.changeTaskStatus(4, TaskStatus::Done);
+    std::string json = boardJson(b);
+
+    // Задачи без исполнителя нельзя перевести в работу: они остаются как были.
+    TaskFilter filter;
+    filter.ids = {1, 2, 3, 4};
+    TaskEdit start;
+    start.status = TaskStatus::InProgress;
+    std::ostringstream started;
+    {
+        BoardRecordWriter writer(started, JsonFormat::Compact);
+        BoardRecordEditor editor(writer, filter, start);
+        editBoard(json, editor);
+        writer.finish();
+        EXPECT_EQ(editor.matched(), 4u);
+        EXPECT_EQ(editor.changed(), 1u);
+        EXPECT_EQ(editor.rejected(), 2u);
+        ASSERT_EQ(editor.failures().size(), 2u);
+        EXPECT_EQ(editor.failures()[0].taskId, 1);
+        EXPECT_EQ(editor.failures()[0].error, BoardError::DeveloperRequired);
+    }
+    ScrumBoard expected = b;
+    expected.changeTaskStatus(2, TaskStatus::InProgress);
+    std::istringstream startedIn(started.str());
+    expectSameContent(expected, BoardSerializer::read(startedIn));
+
+    // Назначение: Backlog становится Assigned, статус Done сохраняется.
+    TaskFilter unassigned;
+    unassigned.unassigned = true;
+    TaskEdit assign;
+    assign.assignTo = 2;
+    std::ostringstream assigned;
+    {
+        BoardRecordWriter writer(assigned, JsonFormat::Compact);
+        BoardRecordEditor editor(writer, unassigned, assign);
+        editBoard(json, editor);
+        writer.finish();
+        EXPECT_EQ(editor.changed(), 4u);
+        EXPECT_EQ(editor.rejected(), 0u);
+    }
+    for (int id : {1, 4, 5, 6}) expected.assignTask(id, 2);
+    expected.changeTaskStatus(2, TaskStatus::Assigned);
+    std::istringstream assignedIn(assigned.str());
+    expectSameContent(expected, BoardSerializer::read(assignedIn));
+
+    // Несуществующий разработчик — отказ по каждой задаче.
+    assign.assignTo = 9;
+    std::ostringstream missing;
+    BoardRecordWriter writer(missing, JsonFormat::Compact);
+    BoardRecordEditor editor(writer, TaskFilter(), assign);
+    editBoard(json, editor);
+    writer.finish();
+    EXPECT_EQ(editor.rejected(), 6u);
+    EXPECT_EQ(missing.str(), json);
+}
+
+TEST(QueryTests, Editor_DevelopersAfterTasks_Throws) {
+    std::string json = R"({"tasks": [{"id": 1, "title": "T", "description": "", "status": "Backlog",
+        "assignedDeveloperId": null}], "developers": [{"id": 1, "name": "A"}]})";
+    std::ostringstream out;
+    BoardRecordWriter writer(out, JsonFormat::Compact);
+    BoardRecordEditor editor(writer, TaskFilter(), TaskEdit());
+    std::istringstream in(json);
+    EXPECT_THROW(BoardSerializer::readRecords(in, editor), std::runtime_error);
+}
+
+TEST(QueryTests, Stats_CountsByStatusAndAssignee) {
+    BoardStats stats;
+    stats.addTask(TaskView(1, "ab", "cde", TaskStatus::Backlog, std::nullopt));
+    stats.addTask(TaskView(2, "a", "", TaskStatus::Assigned, 7));
+    stats.addTask(TaskView(3, "a", "", TaskStatus::Done, 7));
+    stats.addTask(TaskView(4, "a", "", TaskStatus::Done, 3));
+    EXPECT_EQ(stats.tasks, 4u);
+    EXPECT_EQ(stats.unassigned, 1u);
+    EXPECT_EQ(stats.byStatus[statusIndex(TaskStatus::Done)], 2u);
+    EXPECT_EQ(stats.textBytes, 8u);
+    auto top = stats.topAssignees(5);
+    ASSERT_EQ(top.size(), 2u);
+    EXPECT_EQ(top[0], std::make_pair(7, std::size_t(2)));
+    EXPECT_EQ(top[1], std::make_pair(3, std::size_t(1)));
+}
+
+// ---------- Трассировка ----------
+
+namespace {
+
+std::vector<nlohmann::json> traceEvents(const char* name) {
+    std::ostringstream out;
+    tracing::writeChromeTrace(out);
+    nlohmann::json trace = nlohmann::json::parse(out.str());
+    std::vector<nlohmann::json> found;
+    for (const nlohmann::json& event : trace["traceEvents"]) {
+        if (event["name"] == name) found.push_back(event);
+    }
+    return found;
+}
+
+}
+
+TEST(TracingTests, RecordsScopesOnlyWhileActive) {
+    ScrumBoard board;
+    board.addDeveloper(Developer(1, "A"));
+    board.addTask(TaskView(1, "T", "D", TaskStatus::Assigned, 1));
+    board.addTask(TaskView(2, "T", "D", TaskStatus::Assigned, 1));
+
+    { tracing::Scope before("TracingTests.outer"); }
+    tracing::start();
+    {
+        tracing::Scope outer("TracingTests.outer");
+        board.changeTaskStatuses({1, 2}, TaskStatus::InProgress);
+    }
+    tracing::stop();
+    { tracing::Scope after("TracingTests.outer"); }
+
+    std::vector<nlohmann::json> outer = traceEvents("TracingTests.outer");
+    ASSERT_EQ(outer.size(), 1u);
+    EXPECT_EQ(outer[0]["ph"], "X");
+    EXPECT_GE(outer[0]["ts"].get<double>(), 0.0);
+
+#if KANBAN_TRACING
+    std::vector<nlohmann::json> batch = traceEvents("ScrumBoard::changeTaskStatuses");
+    ASSERT_EQ(batch.size(), 1u);
+    EXPECT_EQ(batch[0]["args"]["tasks"], 2);
+    EXPECT_EQ(batch[0]["tid"], outer[0]["tid"]);
+    // Вложенный участок лежит внутри внешнего.
+    double begin = outer[0]["ts"].get<double>();
+    double end = begin + outer[0]["dur"].get<double>();
+    EXPECT_GE(batch[0]["ts"].get<double>(), begin);
+    EXPECT_LE(batch[0]["ts"].get<double>() + batch[0]["dur"].get<double>(), end + 0.001);
+#endif
+}
+
+TEST(TracingTests, FullRing_KeepsNewestEvents) {
+    const char* const names[] = { "e0", "e1", "e2", "e3", "e4", "e5", "e6", "e7", "e8", "e9" };
+    tracing::start(4);
+    for (const char* name : names) tracing::Scope scope(name);
+    tracing::stop();
+
+    EXPECT_EQ(tracing::overwrittenEvents(), 6u);
+    EXPECT_TRUE(traceEvents("e5").empty());
+    for (const char* name : { "e6", "e7", "e8", "e9" }) EXPECT_EQ(traceEvents(name).size(), 1u) << name;
+
+    // Новая запись начинается с пустых колец.
+    tracing::start();
+    tracing::stop();
+    EXPECT_EQ(tracing::overwrittenEvents(), 0u);
+    EXPECT_TRUE(traceEvents("e9").empty());
+}
+
+TEST(TracingTests, FinishedThreadKeepsItsTrack) {
+    tracing::start();
+    { tracing::Scope scope("TracingTests.main"); }
+    std::thread worker([]() {
+        tracing::setThreadName("Рабочий");
+        tracing::Scope scope("TracingTests.worker");
+    });
+    worker.join();
+    // Поток без событий, как поток сохранения при выключенной записи,
+    // не оставляет дорожки.
+    std::thread idle([]() { tracing::setThreadName("Простой"); });
+    idle.join();
+    tracing::stop();
+
+    std::vector<nlohmann::json> main = traceEvents("TracingTests.main");
+    std::vector<nlohmann::json> work = traceEvents("TracingTests.worker");
+    ASSERT_EQ(main.size(), 1u);
+    ASSERT_EQ(work.size(), 1u);
+    EXPECT_NE(main[0]["tid"], work[0]["tid"]);
+
+    bool named = false;
+    for (const nlohmann::json& meta : traceEvents("thread_name")) {
+        if (meta["tid"] == work[0]["tid"]) named = meta["args"]["name"] == "Рабочий";
+        EXPECT_NE(meta["args"]["name"], "Простой");
+    }
+    EXPECT_TRUE(named);
+}
+
+// ---------- Показатели ----------
+
+TEST(MetricsTests, HistogramBuckets_CoverValuesWithBoundedError) {
+    std::mt19937_64 rng(5);
+    for (int i = 0; i < 100000; ++i) {
+        std::uint64_t value = rng() >> (rng() % 64);
+        std::size_t bucket = metrics::Histogram::bucketOf(value);
+        ASSERT_LT(bucket, metrics::Histogram::kBuckets);
+        ASSERT_LE(value, metrics::Histogram::bucketUpperBound(bucket)) << value;
+        if (bucket > 0) {
+            ASSERT_GT(value, metrics::Histogram::bucketUpperBound(bucket - 1)) << value;
+        }
+        ASSERT_LE((double)metrics::Histogram::bucketUpperBound(bucket) - (double)value, (double)value / 8 + 1) << value;
+    }
+    EXPECT_EQ(metrics::Histogram::bucketOf(UINT64_MAX), metrics::Histogram::kBuckets - 1);
+    EXPECT_EQ(metrics::Histogram::bucketUpperBound(metrics::Histogram::kBuckets - 1), UINT64_MAX);
+}
+
+TEST(MetricsTests, HistogramPercentiles) {
+    metrics::Histogram histogram;
+    EXPECT_EQ(histogram.snapshot().percentile(0.5), 0u);
+    for (std::uint64_t v = 1; v <= 1000; ++v) histogram.record(v);
+    metrics::HistogramSnapshot snap = histogram.snapshot();
+    EXPECT_EQ(snap.count, 1000u);
+    EXPECT_EQ(snap.sum, 500500u);
+    EXPECT_EQ(snap.max, 1000u);
+    EXPECT_GE(snap.percentile(0.5), 500u);
+    EXPECT_LE(snap.percentile(0.5), 500u + 500u / 8);
+    EXPECT_GE(snap.percentile(0.99), 990u);
+    EXPECT_EQ(snap.percentile(1.0), 1000u);
+}
+
+TEST(MetricsTests, ConcurrentRecording_LosesNothing) {
+    metrics::Histogram histogram;
+    metrics::Counter counter;
+    std::vector<std::thread> threads;
+    for (int t = 0; t < 4; ++t) {
+        threads.emplace_back([&, t]() {
+            for (std::uint64_t i = 0; i < 50000; ++i) {
+                histogram.record(i * (std::uint64_t)(t + 1));
+                counter.add();
+            }
+        });
+    }
+    for (std::thread& thread : threads) thread.join();
+    EXPECT_EQ(counter.value(), 200000u);
+    EXPECT_EQ(histogram.snapshot().count, 200000u);
+    EXPECT_EQ(histogram.snapshot().max, 49999u * 4);
+}
+
+TEST(MetricsTests, Registry_CountsBoardStatusChanges) {
+    metrics::Counter& calls = metrics::counter("board.status_change.calls");
+    metrics::Counter& rejected = metrics::counter("board.status_change.rejected");
+    EXPECT_EQ(&calls, &metrics::counter("board.status_change.calls"));
+    EXPECT_THROW(metrics::histogram("board.status_change.calls"), std::logic_error);
+
+    std::uint64_t callsBefore = calls.value();
+    std::uint64_t rejectedBefore = rejected.value();
+    ScrumBoard board;
+    board.addTask(Task(1, "T", "D"));
+    EXPECT_EQ(board.tryChangeTaskStatus(1, TaskStatus::Done), BoardError::None);
+    EXPECT_NE(board.tryChangeTaskStatus(1, TaskStatus::InProgress), BoardError::None);
+    EXPECT_NE(board.tryChangeTaskStatus(42, TaskStatus::Done), BoardError::None);
+    EXPECT_EQ(calls.value() - callsBefore, 3u);
+    EXPECT_EQ(rejected.value() - rejectedBefore, 2u);
+
+    metrics::gauge("tests.gauge", metrics::Unit::Bytes).set(3 * 1024 * 1024);
+    { metrics::Timer timer(metrics::histogram("tests.timer")); }
+
+    std::ostringstream json;
+    metrics::writeJson(json, metrics::snapshot());
+    nlohmann::json parsed = nlohmann::json::parse(json.str());
+    std::map<std::string, nlohmann::json> byName;
+    for (const nlohmann::json& item : parsed["metrics"]) byName[item["name"]] = item;
+    EXPECT_EQ(byName["board.status_change.rejected"]["kind"], "counter");
+    EXPECT_EQ(byName["tests.gauge"]["value"], 3 * 1024 * 1024);
+    EXPECT_EQ(byName["tests.timer"]["count"], 1);
+
+    std::ostringstream text;
+    metrics::writeText(text, metrics::snapshot());
+    EXPECT_NE(text.str().find("3.00 МБ"), std::string::npos);
+    EXPECT_EQ(metrics::formatValue(1500000, metrics::Unit::Nanoseconds), "1.50 мс");
+}
+
+TEST(MemoryTests, CountingResource_TracksSharedNodesOnce) {
+    memory::CountingResource resource;
+    {
+        PersistentVector<int> v(&resource);
+        for (int i = 0; i < 10000; ++i) v.push_back(i);
+        std::size_t filled = resource.bytes();
+        EXPECT_GE(filled, 10000 * sizeof(int));
+        EXPECT_GE(resource.blocks(), 10000 * sizeof(int) / 4096);
+
+        PersistentVector<int> copy = v;
+        EXPECT_EQ(resource.bytes(), filled);
+        copy.mutate(5) = -1;
+        EXPECT_GT(resource.bytes(), filled);
+        EXPECT_LT(resource.bytes(), filled + 2 * 4096 + 1024);
+
+        PersistentIdSet set(&resource);
+        for (int i = 0; i < 5000; ++i) set.insert(i);
+        PersistentIdSet setCopy = set;
+        std::size_t before = resource.bytes();
+        setCopy.erase(10);
+        EXPECT_GT(resource.bytes(), before);
+        EXPECT_EQ(setCopy.size(), 4999u);
+        EXPECT_EQ(set.size(), 5000u);
+    }
+    EXPECT_EQ(resource.bytes(), 0u);
+    EXPECT_EQ(resource.blocks(), 0u);
+    EXPECT_GT(resource.peakBytes(), 0u);
+}
+
+TEST(MemoryTests, TextPool_BlocksAndTablesCountedSeparately) {
+    memory::CountingResource text;
+    memory::CountingResource tables;
+    {
+        TextPool pool(&text, &tables);
+        std::vector<TextPool::Handle> handles;
+        for (int i = 0; i < 1000; ++i) handles.push_back(pool.intern("Строка " + std::to_string(i)));
+        pool.intern(std::string(100000, 'x'));
+        EXPECT_GE(text.bytes(), pool.arenaBytes());
+        EXPECT_GT(tables.bytes(), 1000 * sizeof(TextPool::Handle));
+
+        TextPool copy = pool;
+        for (int i = 0; i < 900; ++i) copy.release(handles[(std::size_t)i]);
+        copy.compact();
+        EXPECT_EQ(copy.view(handles[950]), "Строка 950");
+    }
+    EXPECT_EQ(text.bytes(), 0u);
+    EXPECT_EQ(tables.bytes(), 0u);
+}
+
+// Граница с запасом около трети: рост сверх неё — повод разобраться,
+// откуда взялись лишние байты на задачу.
+TEST(MemoryTests, Board_BytesPerTaskByComponent) {
+    const std::size_t count = 50000;
+    memory::Report before = memory::report();
+    auto grown = [&before](memory::Component c) {
+        return memory::report()[c].bytes - before[c].bytes;
+    };
+    {
+        ScrumBoard board;
+        board.addDeveloper(Developer(1, "Анна Петрова"));
+        std::vector<Task> tasks;
+        tasks.reserve(count);
+        for (std::size_t i = 1; i <= count; ++i) {
+            Task task((int)i, "Задача номер " + std::to_string(i), "Описание задачи " + std::to_string(i % 100));
+            if (i % 3 == 0) task.assignDeveloper(1);
+            tasks.push_back(std::move(task));
+        }
+        board.addTasks(tasks);
+        tasks.clear();
+        tasks.shrink_to_fit();
+
+        EXPECT_GT(grown(memory::Component::Developers), 0u);
+        EXPECT_GT(grown(memory::Component::StatusIndex), count * sizeof(int) - 1);
+        std::size_t text = grown(memory::Component::TaskText);
+        std::size_t tables = grown(memory::Component::TextTables);
+        std::size_t columns = grown(memory::Component::TaskColumns);
+        std::size_t index = grown(memory::Component::TaskIndex);
+        std::size_t total = memory::report().totalBytes() - before.totalBytes();
+
+        EXPECT_LE(text / count, 48u) << text;
+        EXPECT_LE(tables / count, 64u) << tables;
+        EXPECT_LE(columns / count, 24u) << columns;
+        EXPECT_LE(index / count, 40u) << index;
+        EXPECT_LE(total / count, 160u) << total;
+
+        {
+            TaskSearchIndex index(board);
+            EXPECT_GT(grown(memory::Component::SearchIndex), count * sizeof(int));
+        }
+        EXPECT_EQ(grown(memory::Component::SearchIndex), 0u);
+
+        // Снимок доски разделяет все узлы и почти ничего не стоит.
+        ScrumBoard snapshot = board;
+        EXPECT_LT(memory::report().totalBytes() - before.totalBytes(), total + 4096);
+        board.changeTaskStatus(7, TaskStatus::Done);
+        EXPECT_LT(memory::report().totalBytes() - before.totalBytes(), total + 64 * 1024);
+
+        std::ostringstream out;
+        memory::writeText(out, memory::report(), board.getAllTasks().size());
+        EXPECT_NE(out.str().find("Текст задач"), std::string::npos);
+        EXPECT_NE(out.str().find("Б/задачу"), std::string::npos);
+    }
+    EXPECT_EQ(memory::report().totalBytes(), before.totalBytes());
+}
+
+TEST(MemoryTests, ArenaBoard_HoldsWholeBoardUntilLastCopy) {
+    memory::Report before = memory::report();
+    auto grown = [&before](memory::Component c) {
+        return memory::report()[c].bytes - before[c].bytes;
+    };
+    std::optional<ScrumBoard> history;
+    {
+        ScrumBoard board = ScrumBoard::withArena();
+        EXPECT_TRUE(board.usesArena());
+        board.addDeveloper(Developer(1, "Анна Петрова"));
+        std::vector<Task> tasks;
+        for (int i = 1; i <= 5000; ++i) tasks.emplace_back(i, "Задача " + std::to_string(i), "Описание");
+        board.addTasks(tasks);
+        board.assignTask(10, 1);
+
+        EXPECT_GT(grown(memory::Component::Arenas), 5000u * 16);
+        for (memory::Component c : {memory::Component::TaskText, memory::Component::TextTables,
+                                    memory::Component::TaskColumns, memory::Component::TaskIndex,
+                                    memory::Component::StatusIndex, memory::Component::Developers}) {
+            EXPECT_EQ(grown(c), 0u) << memory::componentName(c);
+        }
+        history = board;
+    }
+    // Копия держит арену: узлы общие.
+    EXPECT_GT(grown(memory::Component::Arenas), 0u);
+    EXPECT_EQ(history->getTask(10).title(), "Задача 10");
+    EXPECT_EQ(history->getDeveloper(1).name(), "Анна Петрова");
+    EXPECT_EQ(history->countTasks(TaskStatus::Assigned), 1u);
+    history.reset();
+    EXPECT_EQ(grown(memory::Component::Arenas), 0u);
+}
+
+TEST(MemoryTests, ArenaBoard_CopyAndMoveAcrossResources) {
+    memory::Report before = memory::report();
+    auto fill = [](ScrumBoard& board) {
+        board.addDeveloper(Developer(7, "Игорь"));
+        for (int i = 1; i <= 300; ++i) board.addTask(Task(i, "Задача " + std::to_string(i), ""));
+        board.assignTask(5, 7);
+        board.changeTaskStatus(5, TaskStatus::InProgress);
+    };
+
+    ScrumBoard shared;
+    {
+        ScrumBoard arena = ScrumBoard::withArena();
+        fill(arena);
+        shared = arena;
+        EXPECT_TRUE(shared.usesArena());
+    }
+    // Правки после присваивания берут память в той же арене.
+    shared.addTask(Task(1000, "Новая", ""));
+    EXPECT_EQ(shared.getTask(5).status(), TaskStatus::InProgress);
+    EXPECT_EQ(shared.getTask(1000).title(), "Новая");
+    shared.setNextTaskId(2000);
+
+    // Копия с другим ресурсом переписывает содержимое и не держит арену.
+    memory::CountingResource target;
+    {
+        ScrumBoard copy(shared, ScrumBoard::allocator_type(&target));
+        EXPECT_FALSE(copy.usesArena());
+        shared = ScrumBoard();
+        EXPECT_EQ(memory::report()[memory::Component::Arenas].bytes, before[memory::Component::Arenas].bytes);
+        EXPECT_GT(target.bytes(), 0u);
+        EXPECT_EQ(copy.getAllTasks().size(), 301u);
+        EXPECT_EQ(copy.getTaskIdsByStatus(TaskStatus::InProgress), std::vector<int>{5});
+        EXPECT_EQ(copy.getDeveloper(7).name(), "Игорь");
+        EXPECT_EQ(copy.getNextTaskId(), 2000);
+
+        // Перемещение в доску по умолчанию тоже переносит ресурс.
+        ScrumBoard moved;
+        moved = std::move(copy);
+        moved.changeTaskStatus(5, TaskStatus::Done);
+        EXPECT_EQ(moved.getTask(5).status(), TaskStatus::Done);
+    }
+    EXPECT_EQ(target.bytes(), 0u);
+    EXPECT_EQ(memory::report().totalBytes(), before.totalBytes());
+}
+
+TEST(MemoryTests, ArenaBoard_LoadMatchesSharedLoad) {
+    ScrumBoard source;
+    source.addDeveloper(Developer(1, "Анна"));
+    for (int i = 1; i <= 200; ++i) source.addTask(Task(i, "Задача " + std::to_string(i), "Текст"));
+    source.assignTask(3, 1);
+    std::ostringstream out;
+    BoardSerializer::write(source, out, JsonFormat::Compact);
+
+    std::istringstream in(out.str());
+    ScrumBoard arena = BoardSerializer::read(in, BoardStorage::Arena);
+    EXPECT_TRUE(arena.usesArena());
+    ScrumBoard parallel = BoardSerializer::readParallel(out.str(), 2, BoardStorage::Arena);
+    EXPECT_TRUE(parallel.usesArena());
+    EXPECT_EQ(BoardSerializer::serialize(arena), BoardSerializer::serialize(source));
+    EXPECT_EQ(BoardSerializer::serialize(parallel), BoardSerializer::serialize(source));
+}
+
+// Правки освобождают узлы колонок и индексов; арена должна выдавать их снова.
+TEST(MemoryTests, ArenaBoard_ReusesFreedNodesUnderEdits) {
+    ScrumBoard board = ScrumBoard::withArena();
+    board.addDeveloper(Developer(1, "Анна"));
+    std::vector<Task> tasks;
+    for (int i = 1; i <= 20000; ++i) tasks.emplace_back(i, "Задача " + std::to_string(i), "Описание");
+    board.addTasks(tasks);
+    std::size_t loaded = board.arenaBytes();
+
+    for (int i = 0; i < 10000; ++i) {
+        int id = 1 + (i * 7919) % 20000;
+        board.changeTaskStatus(id, i % 2 ? TaskStatus::Done : TaskStatus::Blocked);
+        if (i % 100 == 0) {
+            board.addTask(Task(20001 + i, "Новая задача", "Описание"));
+            board.removeTask(20001 + i);
+        }
+    }
+    EXPECT_LE(board.arenaBytes(), 2 * loaded) << loaded;
+    EXPECT_EQ(board.getAllTasks().size(), 20000u);
+}
+
+static ScrumBoard makeWorkspaceBoard(int tasks) {
+    ScrumBoard board;
+    board.addDeveloper(Developer(1, "Анна"));
+    std::vector<Task> list;
+    for (int i = 1; i <= tasks; ++i) list.emplace_back(i, "Задача " + std::to_string(i), "Описание задачи");
+    board.addTasks(list);
+    board.assignTask(1, 1);
+    board.setNextTaskId(tasks + 1);
+    return board;
+}
+
+// Открывает доску и догружает её целиком.
+static void openWorkspaceBoard(BoardWorkspace& workspace, std::size_t index) {
+    if (workspace.activate(index)) return;
+    while (!workspace.loadStep(1000)) {
+    }
+}
+
+TEST(WorkspaceTests, Open_ReadsHeadersEagerlyAndTasksInSteps) {
+    auto dir = makeTempDir("kanban_workspace_open");
+    ScrumBoard source = makeWorkspaceBoard(2500);
+    saveBoardSnapshot(source, (dir / "beta.kbsnap").string());
+    saveBoardSnapshot(makeWorkspaceBoard(10), (dir / "alpha.kbsnap").string());
+    {
+        ScrumBoard active;
+        BoardWorkspace workspace(active, dir.string());
+        ASSERT_EQ(workspace.boardCount(), 2u);
+        EXPECT_EQ(workspace.boardInfo(0).name, "alpha");
+        EXPECT_EQ(workspace.boardInfo(1).tasks, 2500u);
+        EXPECT_EQ(workspace.boardInfo(1).developers, 1u);
+        EXPECT_FALSE(workspace.isLoaded(1));
+        EXPECT_EQ(workspace.memoryUsage(), 0u);
+
+        EXPECT_FALSE(workspace.activate(1));
+        EXPECT_TRUE(workspace.loading());
+        EXPECT_EQ(workspace.journal(), nullptr);
+        EXPECT_EQ(active.getAllDevelopers().size(), 1u);
+        EXPECT_TRUE(active.getAllTasks().empty());
+
+        EXPECT_FALSE(workspace.loadStep(1000));
+        EXPECT_EQ(active.getAllTasks().size(), 1000u);
+        EXPECT_EQ(workspace.loadProgress().totalTasks, 2500u);
+        EXPECT_FALSE(workspace.loadStep(1000));
+        EXPECT_TRUE(workspace.loadStep(1000));
+        EXPECT_FALSE(workspace.loading());
+        EXPECT_NE(workspace.journal(), nullptr);
+        EXPECT_TRUE(active.usesArena());
+        EXPECT_GT(workspace.memoryUsage(), 0u);
+        EXPECT_EQ(BoardSerializer::serialize(active), BoardSerializer::serialize(source));
+    }
+    std::error_code ec;
+    fs::remove_all(dir, ec);
+}
+
+TEST(WorkspaceTests, Switch_KeepsRecentBoardsAndJournalsEdits) {
+    auto dir = makeTempDir("kanban_workspace_switch");
+    {
+        ScrumBoard active;
+        BoardWorkspace workspace(active, dir.string());
+        std::size_t a = workspace.createBoard("a");
+        std::size_t b = workspace.createBoard("b");
+        EXPECT_THROW(workspace.createBoard("a"), std::invalid_argument);
+        EXPECT_THROW(workspace.createBoard("../x"), std::invalid_argument);
+
+        openWorkspaceBoard(workspace, a);
+        active.addDeveloper(Developer(1, "Анна"));
+        active.addTask(Task(1, "Первая", ""));
+        openWorkspaceBoard(workspace, b);
+        EXPECT_TRUE(active.getAllTasks().empty());
+        active.addTask(Task(5, "На доске b", ""));
+
+        // Доска a в кеше: возврат без загрузки, правки продолжают журнал.
+        EXPECT_TRUE(workspace.isLoaded(a));
+        EXPECT_TRUE(workspace.activate(a));
+        EXPECT_EQ(active.getTask(1).title(), "Первая");
+        active.assignTask(1, 1);
+        EXPECT_EQ(workspace.boardInfo(b).tasks, 1u);
+
+        // Отмена загрузки не оставляет активной доски.
+        workspace.setMemoryBudget(0);
+        EXPECT_FALSE(workspace.isLoaded(b));
+        EXPECT_FALSE(workspace.activate(b));
+        workspace.cancelLoad();
+        EXPECT_FALSE(workspace.activeIndex().has_value());
+        EXPECT_TRUE(active.getAllTasks().empty());
+    }
+
+    ScrumBoard a = BoardJournal::load((dir / "a.kbsnap").string());
+    EXPECT_EQ(a.getTask(1).assignedDeveloper(), std::optional<int>(1));
+    ScrumBoard b = BoardJournal::load((dir / "b.kbsnap").string());
+    EXPECT_EQ(b.getTask(5).title(), "На доске b");
+    EXPECT_EQ(countJournalSegments(dir), 0u);
+
+    std::error_code ec;
+    fs::remove_all(dir, ec);
+}
+
+TEST(WorkspaceTests, Budget_EvictsLeastRecentlyUsedAndPersists) {
+    auto dir = makeTempDir("kanban_workspace_budget");
+    for (const char* name : {"one", "three", "two"}) {
+        saveBoardSnapshot(makeWorkspaceBoard(3000), (dir / (std::string(name) + ".kbsnap")).string());
+    }
+    memory::Report before = memory::report();
+    {
+        ScrumBoard active;
+        BoardWorkspace workspace(active, dir.string());
+        std::size_t one = *workspace.findBoard("one");
+        std::size_t two = *workspace.findBoard("two");
+        std::size_t three = *workspace.findBoard("three");
+
+        openWorkspaceBoard(workspace, one);
+        active.removeTask(3000);
+        std::size_t single = workspace.memoryUsage();
+        // Помещаются две доски, но не три.
+        workspace.setMemoryBudget(single * 5 / 2);
+
+        openWorkspaceBoard(workspace, two);
+        EXPECT_TRUE(workspace.isLoaded(one));
+        openWorkspaceBoard(workspace, three);
+        EXPECT_FALSE(workspace.isLoaded(one));
+        EXPECT_TRUE(workspace.isLoaded(two));
+        EXPECT_LE(workspace.memoryUsage(), workspace.memoryBudget());
+
+        // Вытесненная доска загружается снова уже с правкой.
+        openWorkspaceBoard(workspace, one);
+        EXPECT_FALSE(active.findTask(3000).has_value());
+        EXPECT_EQ(active.getAllTasks().size(), 2999u);
+        EXPECT_FALSE(workspace.isLoaded(two));
+        EXPECT_TRUE(workspace.isLoaded(three));
+    }
+    EXPECT_EQ(memory::report()[memory::Component::Arenas].bytes, before[memory::Component::Arenas].bytes);
+    EXPECT_EQ(BoardSnapshot::open((dir / "one.kbsnap").string()).taskCount(), 2999u);
+
+    std::error_code ec;
+    fs::remove_all(dir, ec);
+}
+
+// Порции загрузки не попадают в историю: отмена во время загрузки или
+// сразу после неё не может выбросить часть задач доски.
+TEST(WorkspaceTests, Load_IsNotAnUndoStep) {
+    auto dir = makeTempDir("kanban_workspace_history");
+    saveBoardSnapshot(makeWorkspaceBoard(2500), (dir / "board.kbsnap").string());
+    {
+        ScrumBoard active;
+        BoardWorkspace workspace(active, dir.string());
+        BoardHistory history(active);
+
+        history.suspend();
+        ASSERT_FALSE(workspace.activate(0));
+        while (!workspace.loadStep(1000)) {
+            EXPECT_FALSE(history.canUndo());
+            EXPECT_FALSE(history.undo());
+        }
+        history.resume();
+        EXPECT_FALSE(history.canUndo());
+        EXPECT_EQ(active.getAllTasks().size(), 2500u);
+
+        active.changeTaskStatus(2, TaskStatus::Done);
+        ASSERT_TRUE(history.undo());
+        EXPECT_FALSE(history.canUndo());
+        EXPECT_EQ(active.getTask(2).status(), TaskStatus::Backlog);
+        EXPECT_EQ(active.getAllTasks().size(), 2500u);
+    }
+    EXPECT_EQ(BoardJournal::load((dir / "board.kbsnap").string()).getAllTasks().size(), 2500u);
+
+    std::error_code ec;
+    fs::remove_all(dir, ec);
+}
@@ -0,0 +1,265 @@
+#pragma once
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <functional>
+#include <limits>
+#include <memory>
+#include <memory_resource>
+#include <string_view>
+#include <utility>
+#include <vector>
+#include "persistentvector.h"
+
+// Пул текста задач: строки дописываются в крупные блоки (арену), одинаковые
+// строки хранятся один раз. Дескриптор строки не меняется при уплотнении,
+// а полученные string_view действительны до следующего release()/compact().
+//
+// Копия пула стоит O(1): блоки арены и таблицы — постоянные векторы, общие
+// с оригиналом. Байты, на которые ссылается копия, больше не меняются:
+// свободный хвост последнего блока достаётся тому пулу, который допишет
+// первым, остальные начинают новый блок.
+//
+// Блоки арены берутся у ресурса text, таблицы пула — у ресурса tables.
+class TextPool {
+public:
+    using Handle = std::uint32_t;
+
+    TextPool() = default;
+    TextPool(std::pmr::memory_resource* text, std::pmr::memory_resource* tables) noexcept
+        : blocks_(tables), largeBlocks_(tables), entries_(tables), freeHandles_(tables), lookup_(tables),
+          textResource_(text) {}
+
+    std::pmr::memory_resource* textResource() const noexcept { return textResource_; }
+    std::pmr::memory_resource* tablesResource() const noexcept { return entries_.resource(); }
+
+    Handle intern(std::string_view text) {
+        std::size_t hash = std::hash<std::string_view>()(text);
+        std::size_t bucket = findBucket(text, hash);
+        if (bucket != kNotFound) {
+            Handle handle = lookup_[bucket];
+            ++entries_.mutate(handle).refs;
+            return handle;
+        }
+
+        if ((lookupSize_ + 1) * 2 > lookup_.size()) {
+            rehashLookup(lookup_.empty() ? 64 : lookup_.size() * 2);
+        }
+
+        Handle handle;
+        if (!freeHandles_.empty()) {
+            handle = freeHandles_.back();
+            freeHandles_.pop_back();
+        } else {
+            handle = (Handle)entries_.size();
+            entries_.push_back(Entry());
+        }
+
+        Entry& e = entries_.mutate(handle);
+        e.data = append(text);
+        e.size = (std::uint32_t)text.size();
+        e.refs = 1;
+        e.hash = hash;
+        liveBytes_ += text.size();
+        insertLookup(handle);
+        return handle;
+    }
+
+    // Заранее готовит таблицы под count разных строк.
+    void reserve(std::size_t count) {
+        std::size_t capacity = 64;
+        while (capacity < count * 2 + 2) capacity *= 2;
+        if (capacity > lookup_.size()) rehashLookup(capacity);
+    }
+
+    // Добавляет ещё одну ссылку на уже хранящуюся строку.
+    void retain(Handle handle) { ++entries_.mutate(handle).refs; }
+
+    void release(Handle handle) {
+        Entry& e = entries_.mutate(handle);
+        if (--e.refs > 0) return;
+
+        eraseLookup(handle);
+        liveBytes_ -= e.size;
+        e.data = nullptr;
+        e.size = 0;
+        freeHandles_.push_back(handle);
+    }
+
+    std::string_view view(Handle handle) const {
+        const Entry& e = entries_[handle];
+        return std::string_view(e.data, e.size);
+    }
+
+    std::size_t liveBytes() const noexcept { return liveBytes_; }
+    std::size_t arenaBytes() const noexcept { return arenaBytes_; }
+    std::size_t uniqueStrings() const noexcept { return lookupSize_; }
+
+    // Память пула целиком: блоки арены, таблица дескрипторов и таблица интернирования.
+    std::size_t memoryUsage() const noexcept {
+        return arenaBytes_
+               + entries_.memoryUsage()
+               + freeHandles_.memoryUsage()
+               + lookup_.memoryUsage();
+    }
+
+    // Переписывает живые строки в новую арену; дескрипторы сохраняются.
+    void compact() {
+        TextPool fresh(textResource(), tablesResource());
+        fresh.copyLiveFrom(*this);
+        *this = std::move(fresh);
+    }
+
+    // Уплотняет арену, когда мёртвые байты составляют больше половины.
+    bool compactIfFragmented() {
+        std::size_t used = arenaUsed_;
+        if (used < kMinCompactBytes || liveBytes_ * 2 > used) return false;
+        compact();
+        return true;
+    }
+
+private:
+    struct Entry {
+        const char* data = nullptr;
+        std::uint32_t size = 0;
+        std::uint32_t refs = 0;
+        std::size_t hash = 0;
+    };
+
+    static constexpr Handle kEmpty = std::numeric_limits<Handle>::max();
+    static constexpr std::size_t kNotFound = std::numeric_limits<std::size_t>::max();
+    static constexpr std::size_t kBlockSize = 256 * 1024;
+    static constexpr std::size_t kMinBlockSize = 4 * 1024;
+    static constexpr std::size_t kMinCompactBytes = 1024 * 1024;
+
+    const char* append(std::string_view text) {
+        if (text.empty()) return "";
+
+        if (text.size() > kBlockSize / 4) {
+            // Крупные строки получают собственный блок, чтобы не дробить общие.
+            largeBlocks_.push_back(allocateBlock(text.size()));
+            std::memcpy(largeBlocks_.back().get(), text.data(), text.size());
+            arenaBytes_ += text.size();
+            arenaUsed_ += text.size();
+            return largeBlocks_.back().get();
+        }
+
+        if (!claimTail(text.size())) {
+            // Хвост занят другой копией — пул ответвился, например после
+            // отмены. Тогда блоки снова начинаются с малого и растут вдвое.
+            bool forked = !blocks_.empty() && blockUsed_ + text.size() <= blockSize_;
+            std::size_t size = forked || blocks_.empty() ? kMinBlockSize : std::min(blockSize_ * 2, kBlockSize);
+            while (size < text.size()) size *= 2;
+            blocks_.push_back(allocateBlock(size));
+            tail_ = std::allocate_shared<std::atomic<std::size_t>>(
+                std::pmr::polymorphic_allocator<std::atomic<std::size_t>>(textResource_), text.size());
+            arenaBytes_ += size;
+            blockSize_ = size;
+            blockUsed_ = 0;
+        }
+
+        char* dst = blocks_.back().get() + blockUsed_;
+        std::memcpy(dst, text.data(), text.size());
+        blockUsed_ += text.size();
+        arenaUsed_ += text.size();
+        return dst;
+    }
+
+    // Блок возвращается ресурсу, когда его отпустит последняя копия пула.
+    std::shared_ptr<char[]> allocateBlock(std::size_t size) const {
+        std::pmr::memory_resource* resource = textResource_;
+        char* data = static_cast<char*>(resource->allocate(size, 1));
+        return std::shared_ptr<char[]>(data, [resource, size](char* p) { resource->deallocate(p, size, 1); },
+                                       std::pmr::polymorphic_allocator<char>(resource));
+    }
+
+    // Таблица интернирования — плоская открытая адресация по дескрипторам;
+    // хеш хранится в записи, поэтому строки при перестройке не перечитываются.
+    std::size_t findBucket(std::string_view text, std::size_t hash) const {
+        if (lookup_.empty()) return kNotFound;
+        std::size_t mask = lookup_.size() - 1;
+        for (std::size_t i = hash & mask; lookup_[i] != kEmpty; i = (i + 1) & mask) {
+            const Entry& e = entries_[lookup_[i]];
+            if (e.hash == hash && std::string_view(e.data, e.size) == text) return i;
+        }
+        return kNotFound;
+    }
+
+    void insertLookup(Handle handle) {
+        std::size_t mask = lookup_.size() - 1;
+        std::size_t i = entries_[handle].hash & mask;
+        while (lookup_[i] != kEmpty) i = (i + 1) & mask;
+        lookup_.mutate(i) = handle;
+        ++lookupSize_;
+    }
+
+    void eraseLookup(Handle handle) {
+        std::size_t mask = lookup_.size() - 1;
+        std::size_t hole = entries_[handle].hash & mask;
+        while (lookup_[hole] != handle) hole = (hole + 1) & mask;
+
+        for (std::size_t j = (hole + 1) & mask; lookup_[j] != kEmpty; j = (j + 1) & mask) {
+            std::size_t home = entries_[lookup_[j]].hash & mask;
+            bool movable = (hole <= j) ? (home <= hole || home > j)
+                                       : (home <= hole && home > j);
+            if (movable) {
+                lookup_.mutate(hole) = lookup_[j];
+                hole = j;
+            }
+        }
+        lookup_.mutate(hole) = kEmpty;
+        --lookupSize_;
+    }
+
+    void rehashLookup(std::size_t capacity) {
+        lookup_.assign(capacity, kEmpty);
+        lookupSize_ = 0;
+        for (Handle h = 0; h < (Handle)entries_.size(); ++h) {
+            if (entries_[h].refs > 0) insertLookup(h);
+        }
+    }
+
+    // Переписывает в этот (пустой) пул только живые строки другого пула.
+    void copyLiveFrom(const TextPool& other) {
+        entries_.assign(other.entries_.size(), Entry());
+        freeHandles_ = other.freeHandles_;
+        for (Handle h = 0; h < (Handle)other.entries_.size(); ++h) {
+            const Entry& src = other.entries_[h];
+            if (src.refs == 0) continue;
+            Entry& e = entries_.mutate(h);
+            e.data = append(std::string_view(src.data, src.size));
+            e.size = src.size;
+            e.refs = src.refs;
+            e.hash = src.hash;
+            liveBytes_ += src.size;
+        }
+        std::size_t capacity = 64;
+        while (capacity < other.lookupSize_ * 2 + 2) capacity *= 2;
+        rehashLookup(capacity);
+    }
+
+    // Хвост последнего блока: сколько байт в нём занято хоть одной из копий пула.
+    bool claimTail(std::size_t size) {
+        if (!tail_ || blockUsed_ + size > blockSize_) return false;
+        std::size_t expected = blockUsed_;
+        return tail_->compare_exchange_strong(expected, blockUsed_ + size, std::memory_order_relaxed);
+    }
+
+    PersistentVector<std::shared_ptr<char[]>> blocks_;
+    PersistentVector<std::shared_ptr<char[]>> largeBlocks_;
+    std::shared_ptr<std::atomic<std::size_t>> tail_;
+    std::size_t blockSize_ = 0;
+    std::size_t blockUsed_ = 0;
+    std::size_t arenaBytes_ = 0;
+    std::size_t arenaUsed_ = 0;
+    std::size_t liveBytes_ = 0;
+
+    PersistentVector<Entry> entries_;
+    PersistentVector<Handle> freeHandles_;
+    PersistentVector<Handle> lookup_;
+    std::size_t lookupSize_ = 0;
+
+    std::pmr::memory_resource* textResource_ = std::pmr::get_default_resource();
+};
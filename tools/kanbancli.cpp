@@ -0,0 +1,320 @@
+#include "atomicfile.h"
+#include "boardquery.h"
+#include "boardserializer.h"
+#include "boardsnapshot.h"
+#include "taskutils.h"
+
+#include <cstring>
+#include <fstream>
+#include <functional>
+#include <iostream>
+#include <stdexcept>
+#include <string>
+
+// kanban_cli: запросы и массовые правки доски без интерфейса. Файл читается
+// и пишется по одной записи, так что память не зависит от числа задач, а
+// команды можно соединять каналами: kanban_cli assign ... | kanban_cli stats.
+
+namespace {
+
+const char* const kUsage =
+    "Использование: kanban_cli КОМАНДА [параметры]\n"
+    "Команды:\n"
+    "  list                   задачи, по одной на строку\n"
+    "  stats                  число задач по статусам и исполнителям\n"
+    "  set-status --to S      перевести отобранные задачи в статус S\n"
+    "  assign --to ID         назначить отобранные задачи разработчику ID\n"
+    "  convert                переписать доску в другом формате\n"
+    "Отбор задач:\n"
+    "  --status S[,S...]      по статусу\n"
+    "  --assignee ID|none     по исполнителю или без него\n"
+    "  --ids 1,2,5-9          по ID\n"
+    "Ввод и вывод:\n"
+    "  -i, --input FILE       файл доски, JSON или снимок (по умолчанию stdin, только JSON)\n"
+    "  -o, --output FILE      файл результата (по умолчанию stdout); может совпадать с -i\n"
+    "  --format pretty|compact|snapshot  формат результата правки (compact);\n"
+    "                         snapshot требует -o и собирает доску в памяти\n"
+    "  --as text|jsonl|csv    формат списка list (text); jsonl и csv\n"
+    "                         читает импорт задач\n"
+    "Код возврата: 0 — успех, 1 — ошибка, 2 — часть правок отклонена.\n";
+
+struct Options {
+    std::string command;
+    std::string input = "-";
+    std::string output = "-";
+    std::string format = "compact";
+    std::string listAs = "text";
+    std::string to;
+    TaskFilter filter;
+};
+
+bool isSnapshotFile(const std::string& filename)
+{
+    std::ifstream file(filename.c_str(), std::ios::binary);
+    char magic[6] = {};
+    return file.read(magic, sizeof(magic)) && std::memcmp(magic, "KBSNAP", sizeof(magic)) == 0;
+}
+
+// Записи доски из JSON или снимка в порядке файла.
+void readRecords(const std::string& input, BoardRecordHandler& handler)
+{
+    if (input == "-") {
+        BoardSerializer::readRecords(std::cin, handler);
+        return;
+    }
+    if (isSnapshotFile(input)) {
+        BoardSnapshot snap = BoardSnapshot::open(input);
+        std::string name, title, description;
+        for (std::size_t i = 0; i < snap.developerCount(); ++i) {
+            name.assign(snap.developerName(i));
+            handler.developer(snap.developerId(i), name);
+        }
+        for (std::size_t i = 0; i < snap.taskCount(); ++i) {
+            TaskView task = snap.task(i);
+            title.assign(task.title());
+            description.assign(task.description());
+            handler.task(task.id(), title, description, task.status(), task.assignedDeveloper());
+        }
+        return;
+    }
+    std::ifstream file(input.c_str(), std::ios::binary);
+    if (!file) {
+        throw std::runtime_error("Невозможно открыть файл для чтения: " + input);
+    }
+    BoardSerializer::readRecords(file, handler);
+}
+
+void writeOutput(const std::string& output, const std::function<void(std::ostream&)>& write)
+{
+    if (output == "-") {
+        write(std::cout);
+        std::cout.flush();
+        if (!std::cout) throw std::runtime_error("Ошибка записи в stdout");
+    } else {
+        writeFileAtomically(output, write);
+    }
+}
+
+void writeCsvField(std::ostream& out, std::string_view text)
+{
+    out << '"';
+    for (char c : text) {
+        if (c == '"') out << '"';
+        out << c;
+    }
+    out << '"';
+}
+
+class ListHandler : public BoardRecordHandler {
+public:
+    ListHandler(std::ostream& out, const TaskFilter& filter, const std::string& as)
+        : out_(out), filter_(filter), as_(as)
+    {
+        if (as_ == "csv") out_ << "id,title,description,status,assignee\n";
+        else if (as_ != "text" && as_ != "jsonl") throw std::invalid_argument("Неизвестный формат списка: " + as_);
+    }
+
+    void developer(int, std::string&) override {}
+
+    void task(int id, std::string& title, std::string& description,
+              TaskStatus status, std::optional<int> assignee) override {
+        TaskView task(id, title, description, status, assignee);
+        if (!filter_.matches(task)) return;
+
+        if (as_ == "text") {
+            out_ << id << '\t' << taskStatusToString(status) << '\t';
+            if (assignee) out_ << *assignee;
+            else out_ << '-';
+            out_ << '\t' << title << '\n';
+        } else if (as_ == "jsonl") {
+            // Ключи файла доски: строки читает importTasksFromJsonLines.
+            nlohmann::json line = {
+                {"id", id}, {"title", title}, {"description", description},
+                {"status", taskStatusToString(status)}
+            };
+            line["assignedDeveloperId"] = assignee ? nlohmann::json(*assignee) : nlohmann::json(nullptr);
+            out_ << line.dump() << '\n';
+        } else {
+            out_ << id << ',';
+            writeCsvField(out_, title);
+            out_ << ',';
+            writeCsvField(out_, description);
+            out_ << ',' << taskStatusToString(status) << ',';
+            if (assignee) out_ << *assignee;
+            out_ << '\n';
+        }
+    }
+
+private:
+    std::ostream& out_;
+    const TaskFilter& filter_;
+    std::string as_;
+};
+
+class StatsHandler : public BoardRecordHandler {
+public:
+    explicit StatsHandler(const TaskFilter& filter) : filter_(filter) {}
+
+    void developer(int, std::string&) override { ++stats.developers; }
+
+    void task(int id, std::string& title, std::string& description,
+              TaskStatus status, std::optional<int> assignee) override {
+        TaskView task(id, title, description, status, assignee);
+        if (filter_.matches(task)) stats.addTask(task);
+    }
+
+    BoardStats stats;
+
+private:
+    const TaskFilter& filter_;
+};
+
+class BuildingHandler : public BoardRecordHandler {
+public:
+    explicit BuildingHandler(ScrumBoard& board) : builder(board) {}
+
+    void developer(int id, std::string& name) override { builder.addDeveloper(id, name); }
+
+    void task(int id, std::string& title, std::string& description,
+              TaskStatus status, std::optional<int> assignee) override {
+        builder.addTask(id, title, description, status, assignee);
+    }
+
+    BoardBuilder builder;
+};
+
+void printStats(const BoardStats& stats)
+{
+    std::cout << "Разработчиков: " << stats.developers << "\n"
+              << "Задач: " << stats.tasks << "\n";
+    for (std::size_t i = 0; i < kTaskStatusCount; ++i) {
+        std::cout << "  " << taskStatusToString(static_cast<TaskStatus>(i)) << ": " << stats.byStatus[i] << "\n";
+    }
+    std::cout << "Без исполнителя: " << stats.unassigned << "\n"
+              << "Исполнителей с задачами: " << stats.byAssignee.size() << "\n"
+              << "Текст задач, байт: " << stats.textBytes << "\n";
+    auto top = stats.topAssignees(10);
+    if (!top.empty()) {
+        std::cout << "Больше всего задач:\n";
+        for (const auto& [developer, count] : top) std::cout << "  " << developer << ": " << count << "\n";
+    }
+}
+
+int runEdit(const Options& options, const TaskEdit& edit)
+{
+    std::size_t matched = 0, changed = 0, rejected = 0;
+    std::vector<TaskEditFailure> failures;
+    auto edited = [&](BoardRecordHandler& next) {
+        BoardRecordEditor editor(next, options.filter, edit);
+        readRecords(options.input, editor);
+        matched = editor.matched();
+        changed = editor.changed();
+        rejected = editor.rejected();
+        failures = editor.failures();
+    };
+
+    if (options.format == "snapshot") {
+        if (options.output == "-") throw std::invalid_argument("Снимок пишется только в файл: укажите -o");
+        // Снимку нужны индекс и таблица строк целиком, поэтому доска собирается в памяти.
+        ScrumBoard board;
+        BuildingHandler builder(board);
+        edited(builder);
+        builder.builder.finish();
+        saveBoardSnapshot(board, options.output);
+    } else {
+        JsonFormat format;
+        if (options.format == "pretty") format = JsonFormat::Pretty;
+        else if (options.format == "compact") format = JsonFormat::Compact;
+        else throw std::invalid_argument("Неизвестный формат: " + options.format);
+
+        writeOutput(options.output, [&](std::ostream& out) {
+            BoardRecordWriter writer(out, format);
+            edited(writer);
+            writer.finish();
+        });
+    }
+
+    if (options.command != "convert") {
+        std::cerr << "Подходящих задач: " << matched << ", изменено: " << changed
+                  << ", отклонено: " << rejected << "\n";
+        for (const TaskEditFailure& failure : failures) {
+            std::cerr << "  задача " << failure.taskId << ": " << boardErrorMessage(failure.error) << "\n";
+        }
+        if (rejected > failures.size()) std::cerr << "  ...\n";
+    }
+    return rejected ? 2 : 0;
+}
+
+int run(const Options& options)
+{
+    if (options.command == "list") {
+        writeOutput(options.output, [&](std::ostream& out) {
+            ListHandler handler(out, options.filter, options.listAs);
+            readRecords(options.input, handler);
+        });
+        return 0;
+    }
+    if (options.command == "stats") {
+        StatsHandler handler(options.filter);
+        readRecords(options.input, handler);
+        printStats(handler.stats);
+        return 0;
+    }
+    if (options.command == "set-status") {
+        if (options.to.empty()) throw std::invalid_argument("Укажите статус: --to S");
+        TaskEdit edit;
+        edit.status = parseStatusList(options.to).at(0);
+        return runEdit(options, edit);
+    }
+    if (options.command == "assign") {
+        if (options.to.empty()) throw std::invalid_argument("Укажите разработчика: --to ID");
+        TaskEdit edit;
+        edit.assignTo = parseIdList(options.to).at(0);
+        return runEdit(options, edit);
+    }
+    if (options.command == "convert") return runEdit(options, TaskEdit());
+    throw std::invalid_argument("Неизвестная команда: " + options.command);
+}
+
+Options parseOptions(int argc, char* argv[])
+{
+    Options options;
+    options.command = argv[1];
+    for (int i = 2; i < argc; ++i) {
+        std::string option = argv[i];
+        if (i + 1 >= argc) throw std::invalid_argument("Нет значения у параметра " + option);
+        std::string value = argv[++i];
+
+        if (option == "-i" || option == "--input") options.input = value;
+        else if (option == "-o" || option == "--output") options.output = value;
+        else if (option == "--format") options.format = value;
+        else if (option == "--as") options.listAs = value;
+        else if (option == "--to") options.to = value;
+        else if (option == "--status") options.filter.statuses = parseStatusList(value);
+        else if (option == "--ids") options.filter.ids = parseIdList(value);
+        else if (option == "--assignee") {
+            if (value == "none") options.filter.unassigned = true;
+            else options.filter.assignee = parseIdList(value).at(0);
+        }
+        else throw std::invalid_argument("Неизвестный параметр " + option);
+    }
+    return options;
+}
+
+}
+
+int main(int argc, char* argv[])
+{
+    std::ios::sync_with_stdio(false);
+    if (argc < 2 || std::strcmp(argv[1], "-h") == 0 || std::strcmp(argv[1], "--help") == 0) {
+        std::cout << kUsage;
+        return argc < 2 ? 1 : 0;
+    }
+
+    try {
+        return run(parseOptions(argc, argv));
+    } catch (const std::exception& e) {
+        std::cerr << "kanban_cli: " << e.what() << "\n";
+        return 1;
+    }
+}
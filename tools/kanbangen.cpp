@@ -0,0 +1,155 @@
+#include "atomicfile.h"
+#include "boardgenerator.h"
+#include "taskutils.h"
+
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <stdexcept>
+#include <string>
+
+// kanban_gen: пишет файл доски заданного размера и формы, не собирая
+// доску в памяти. Одинаковые параметры дают одинаковый файл.
+
+namespace {
+
+const char* const kUsage =
+    "Использование: kanban_gen [параметры]\n"
+    "  --tasks N              число задач (1000)\n"
+    "  --developers N         число разработчиков (50)\n"
+    "  --seed N               зерно генератора (1)\n"
+    "  --status S=W,...       веса статусов, например Backlog=30,Done=70\n"
+    "  --assigned P           доля назначенных среди Blocked и Done, 0..1 (0.8)\n"
+    "  --title-length A-B     длина заголовка в байтах (12-60)\n"
+    "  --description-length A-B  длина описания в байтах (0-400)\n"
+    "  --id-stride N          шаг между ID задач — случайный от 1 до N (1)\n"
+    "  --shape NAME           готовая форма доски:\n"
+    "                           skewed — задачи сосредоточены у немногих разработчиков\n"
+    "                           one-owner — все назначенные задачи у одного разработчика\n"
+    "                           huge-descriptions — описания от 256 КБ до 1 МБ\n"
+    "                           sparse-ids — ID с большими пропусками\n"
+    "                           escapes — текст со спецсимволами JSON\n"
+    "  --format pretty|compact  формат файла (compact)\n"
+    "  -o, --output FILE      файл результата (по умолчанию stdout)\n";
+
+long long parseNumber(const std::string& text, const char* option)
+{
+    char* end = nullptr;
+    long long value = std::strtoll(text.c_str(), &end, 10);
+    if (text.empty() || *end != '\0') {
+        throw std::invalid_argument(std::string("Ожидалось число: ") + option);
+    }
+    return value;
+}
+
+double parseReal(const std::string& text, const char* option)
+{
+    char* end = nullptr;
+    double value = std::strtod(text.c_str(), &end);
+    if (text.empty() || *end != '\0') {
+        throw std::invalid_argument(std::string("Ожидалось число: ") + option);
+    }
+    return value;
+}
+
+TextLength parseLength(const std::string& text, const char* option)
+{
+    std::size_t dash = text.find('-');
+    if (dash == std::string::npos) {
+        long long length = parseNumber(text, option);
+        return {(std::size_t)length, (std::size_t)length};
+    }
+    long long min = parseNumber(text.substr(0, dash), option);
+    long long max = parseNumber(text.substr(dash + 1), option);
+    if (min < 0 || max < 0) throw std::invalid_argument(std::string("Некорректная длина: ") + option);
+    return {(std::size_t)min, (std::size_t)max};
+}
+
+// Перечисленные статусы получают заданные веса, остальные — ноль.
+void parseStatusWeights(const std::string& text, BoardGeneratorOptions& options)
+{
+    options.statusWeights.fill(0);
+    std::size_t begin = 0;
+    while (begin <= text.size()) {
+        std::size_t end = text.find(',', begin);
+        if (end == std::string::npos) end = text.size();
+        std::string item = text.substr(begin, end - begin);
+        std::size_t eq = item.find('=');
+        if (eq == std::string::npos) throw std::invalid_argument("Ожидалось СТАТУС=ВЕС: " + item);
+        TaskStatus status = stringToTaskStatus(item.substr(0, eq));
+        options.statusWeights[statusIndex(status)] = parseReal(item.substr(eq + 1), "--status");
+        begin = end + 1;
+    }
+}
+
+void applyShape(const std::string& shape, BoardGeneratorOptions& options)
+{
+    if (shape == "skewed") {
+        options.owners = OwnerDistribution::Skewed;
+    } else if (shape == "one-owner") {
+        options.owners = OwnerDistribution::SingleOwner;
+    } else if (shape == "huge-descriptions") {
+        options.descriptionLength = {256 * 1024, 1024 * 1024};
+    } else if (shape == "sparse-ids") {
+        options.idStride = 1000;
+    } else if (shape == "escapes") {
+        options.escapedText = true;
+    } else {
+        throw std::invalid_argument("Неизвестная форма доски: " + shape);
+    }
+}
+
+}
+
+int main(int argc, char* argv[])
+{
+    BoardGeneratorOptions options;
+    JsonFormat format = JsonFormat::Compact;
+    std::string output;
+
+    try {
+        for (int i = 1; i < argc; ++i) {
+            std::string option = argv[i];
+            if (option == "-h" || option == "--help") {
+                std::cout << kUsage;
+                return 0;
+            }
+            if (i + 1 >= argc) throw std::invalid_argument("Нет значения у параметра " + option);
+            std::string value = argv[++i];
+
+            if (option == "--tasks") options.tasks = parseNumber(value, "--tasks");
+            else if (option == "--developers") options.developers = (int)parseNumber(value, "--developers");
+            else if (option == "--seed") options.seed = (std::uint64_t)parseNumber(value, "--seed");
+            else if (option == "--status") parseStatusWeights(value, options);
+            else if (option == "--assigned") options.assignedShare = parseReal(value, "--assigned");
+            else if (option == "--title-length") options.titleLength = parseLength(value, "--title-length");
+            else if (option == "--description-length") options.descriptionLength = parseLength(value, "--description-length");
+            else if (option == "--id-stride") options.idStride = (int)parseNumber(value, "--id-stride");
+            else if (option == "--shape") applyShape(value, options);
+            else if (option == "--format") {
+                if (value == "pretty") format = JsonFormat::Pretty;
+                else if (value == "compact") format = JsonFormat::Compact;
+                else throw std::invalid_argument("Неизвестный формат: " + value);
+            }
+            else if (option == "-o" || option == "--output") output = value;
+            else throw std::invalid_argument("Неизвестный параметр " + option);
+        }
+
+        BoardGenerator generator(options);
+        if (output.empty()) {
+            BoardRecordWriter writer(std::cout, format);
+            generator.write(writer);
+            std::cout.flush();
+        } else {
+            writeFileAtomically(output, [&](std::ostream& out) {
+                BoardRecordWriter writer(out, format);
+                generator.write(writer);
+            });
+            std::cerr << "Записано задач: " << generator.tasksWritten() << " в " << output << "\n";
+        }
+    } catch (const std::exception& e) {
+        std::cerr << "kanban_gen: " << e.what() << "\n\n" << kUsage;
+        return 1;
+    }
+    return 0;
+}
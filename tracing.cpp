@@ -0,0 +1,216 @@
+#include "tracing.h"
+#include "atomicfile.h"
+#include <algorithm>
+#include <cinttypes>
+#include <cstdio>
+#include <memory>
+#include <mutex>
+#include <stdexcept>
+#include <vector>
+#include <nlohmann/json.hpp>
+
+namespace tracing {
+namespace {
+
+// Кольцо событий одного потока. Мьютекс берёт только сам поток при записи
+// и выгрузка трассы, так что он почти никогда не занят.
+struct ThreadBuffer {
+    std::mutex mutex;
+    std::vector<Event> events;
+    std::size_t next = 0;           // самое старое событие, когда кольцо заполнено
+    std::size_t overwritten = 0;
+    std::string name;
+    int tid = 0;
+    bool finished = false;          // поток завершился, буфер нужен только для выгрузки
+};
+
+struct Registry {
+    std::mutex mutex;
+    std::vector<std::shared_ptr<ThreadBuffer>> threads;
+    std::atomic<std::size_t> capacity{kDefaultEventsPerThread};
+    std::int64_t originNs = 0;
+    int nextTid = 1;
+};
+
+// Не разрушается при выходе: потоки могут завершаться позже статических объектов.
+Registry& registry()
+{
+    static Registry* instance = new Registry;
+    return *instance;
+}
+
+// Буфер создаётся и регистрируется при первом событии потока: потоки,
+// которые ничего не записали, в реестр не попадают.
+struct ThreadHandle {
+    ~ThreadHandle() {
+        if (!buffer) return;
+        Registry& r = registry();
+        std::lock_guard<std::mutex> lock(r.mutex);
+        std::lock_guard<std::mutex> bufferLock(buffer->mutex);
+        if (!buffer->events.empty()) {
+            buffer->finished = true;
+            return;
+        }
+        // Выгружать нечего: буфер не ждёт следующего start().
+        r.threads.erase(std::remove(r.threads.begin(), r.threads.end(), buffer), r.threads.end());
+    }
+
+    std::shared_ptr<ThreadBuffer> buffer;
+    std::string name;
+};
+
+ThreadHandle& threadHandle()
+{
+    thread_local ThreadHandle handle;
+    return handle;
+}
+
+ThreadBuffer& threadBuffer()
+{
+    ThreadHandle& handle = threadHandle();
+    if (!handle.buffer) {
+        auto buffer = std::make_shared<ThreadBuffer>();
+        buffer->name = handle.name;
+        Registry& r = registry();
+        std::lock_guard<std::mutex> lock(r.mutex);
+        buffer->tid = r.nextTid++;
+        r.threads.push_back(buffer);
+        handle.buffer = std::move(buffer);
+    }
+    return *handle.buffer;
+}
+
+void writeMicroseconds(std::ostream& out, std::int64_t ns)
+{
+    char text[32];
+    std::snprintf(text, sizeof(text), "%" PRId64 ".%03d", ns / 1000, (int)(ns % 1000));
+    out << text;
+}
+
+}
+
+void start(std::size_t eventsPerThread)
+{
+    Registry& r = registry();
+    std::lock_guard<std::mutex> lock(r.mutex);
+    g_active.store(false, std::memory_order_relaxed);
+
+    // Буферы завершившихся потоков больше не нужны, у остальных — новая запись.
+    std::vector<std::shared_ptr<ThreadBuffer>> alive;
+    for (const std::shared_ptr<ThreadBuffer>& buffer : r.threads) {
+        std::lock_guard<std::mutex> bufferLock(buffer->mutex);
+        if (buffer->finished) continue;
+        buffer->events.clear();
+        buffer->next = 0;
+        buffer->overwritten = 0;
+        alive.push_back(buffer);
+    }
+    r.threads = std::move(alive);
+    r.capacity.store(std::max<std::size_t>(eventsPerThread, 1), std::memory_order_relaxed);
+    r.originNs = now();
+    g_active.store(true, std::memory_order_relaxed);
+}
+
+void stop()
+{
+    g_active.store(false, std::memory_order_relaxed);
+}
+
+void setThreadName(const std::string& name)
+{
+    ThreadHandle& handle = threadHandle();
+    handle.name = name;
+    if (!handle.buffer) return;
+    std::lock_guard<std::mutex> lock(handle.buffer->mutex);
+    handle.buffer->name = name;
+}
+
+void record(const Event& event)
+{
+    ThreadBuffer& buffer = threadBuffer();
+    std::size_t capacity = registry().capacity.load(std::memory_order_relaxed);
+    std::lock_guard<std::mutex> lock(buffer.mutex);
+    if (buffer.events.size() < capacity) {
+        buffer.events.push_back(event);
+        return;
+    }
+    buffer.events[buffer.next] = event;
+    buffer.next = (buffer.next + 1) % buffer.events.size();
+    ++buffer.overwritten;
+}
+
+void writeChromeTrace(std::ostream& out)
+{
+    struct ThreadEvents {
+        int tid;
+        std::string name;
+        std::vector<Event> events;
+    };
+
+    // Копии снимаются под мьютексами, а пишутся без них: потоки не ждут диска.
+    std::vector<ThreadEvents> threads;
+    std::size_t overwritten = 0;
+    std::int64_t originNs;
+    {
+        Registry& r = registry();
+        std::lock_guard<std::mutex> lock(r.mutex);
+        originNs = r.originNs;
+        for (const std::shared_ptr<ThreadBuffer>& buffer : r.threads) {
+            std::lock_guard<std::mutex> bufferLock(buffer->mutex);
+            ThreadEvents copy{buffer->tid, buffer->name, {}};
+            copy.events.reserve(buffer->events.size());
+            copy.events.insert(copy.events.end(), buffer->events.begin() + (std::ptrdiff_t)buffer->next,
+                               buffer->events.end());
+            copy.events.insert(copy.events.end(), buffer->events.begin(),
+                               buffer->events.begin() + (std::ptrdiff_t)buffer->next);
+            overwritten += buffer->overwritten;
+            threads.push_back(std::move(copy));
+        }
+    }
+
+    out << "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[\n";
+    out << "{\"name\":\"process_name\",\"ph\":\"M\",\"pid\":1,\"tid\":0,\"args\":{\"name\":\"kanban\"}}";
+    for (const ThreadEvents& thread : threads) {
+        if (!thread.name.empty()) {
+            out << ",\n{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":" << thread.tid
+                << ",\"args\":{\"name\":" << nlohmann::json(thread.name).dump() << "}}";
+        }
+        for (const Event& event : thread.events) {
+            // Участок, начатый до start(), к этой записи не относится.
+            if (event.startNs < originNs) continue;
+            out << ",\n{\"name\":" << nlohmann::json(event.name).dump()
+                << ",\"cat\":\"kanban\",\"ph\":\"X\",\"pid\":1,\"tid\":" << thread.tid << ",\"ts\":";
+            writeMicroseconds(out, event.startNs - originNs);
+            out << ",\"dur\":";
+            writeMicroseconds(out, event.durationNs);
+            if (event.argName) {
+                out << ",\"args\":{" << nlohmann::json(event.argName).dump() << ':' << event.argValue << '}';
+            }
+            out << '}';
+        }
+    }
+    out << "\n],\"otherData\":{\"overwrittenEvents\":" << overwritten << "}}\n";
+
+    if (!out) {
+        throw std::runtime_error("Ошибка записи трассы");
+    }
+}
+
+void saveChromeTrace(const std::string& filename)
+{
+    writeFileAtomically(filename, [](std::ostream& out) { writeChromeTrace(out); });
+}
+
+std::size_t overwrittenEvents()
+{
+    Registry& r = registry();
+    std::lock_guard<std::mutex> lock(r.mutex);
+    std::size_t total = 0;
+    for (const std::shared_ptr<ThreadBuffer>& buffer : r.threads) {
+        std::lock_guard<std::mutex> bufferLock(buffer->mutex);
+        total += buffer->overwritten;
+    }
+    return total;
+}
+
+}
@@ -0,0 +1,100 @@
+#pragma once
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <ostream>
+#include <string>
+
+// Трассировка горячих путей в формате Chrome trace event: файл открывается
+// в ui.perfetto.dev или chrome://tracing. Участок кода отмечается макросом
+//
+//     KANBAN_TRACE_SCOPE("BoardColumnModel::reload");
+//     KANBAN_TRACE_SCOPE_ARG("ScrumBoard::changeTaskStatuses", "tasks", taskIds.size());
+//
+// и попадает в трассу, если выполнялся между tracing::start() и stop().
+// Каждый поток пишет события в собственное кольцо, так что потоки не ждут
+// друг друга, а при переполнении теряются самые старые события, а не
+// последние секунды сеанса. Пока запись выключена, участок стоит одной
+// атомарной загрузки; при сборке с KANBAN_TRACING=0 макросы пусты, а
+// выражения в их аргументах не вычисляются.
+
+#ifndef KANBAN_TRACING
+#define KANBAN_TRACING 1
+#endif
+
+namespace tracing {
+
+// Имена — строковые литералы: в кольце хранится только указатель.
+struct Event {
+    const char* name;
+    const char* argName;        // nullptr, если у участка нет аргумента
+    std::int64_t argValue;
+    std::int64_t startNs;
+    std::int64_t durationNs;
+};
+
+constexpr std::size_t kDefaultEventsPerThread = 1 << 18;
+
+inline std::atomic<bool> g_active{false};
+
+inline bool active() noexcept { return g_active.load(std::memory_order_relaxed); }
+
+inline std::int64_t now() noexcept {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+// Начинает новую запись, отбрасывая прежние события.
+void start(std::size_t eventsPerThread = kDefaultEventsPerThread);
+void stop();
+
+// Имя потока в трассе; можно вызывать до start(). Поток попадает в трассу
+// только с первым событием, имя до тех пор ничего не стоит.
+void setThreadName(const std::string& name);
+
+void record(const Event& event);
+
+// События всех потоков, включая завершившиеся. Запись можно не
+// останавливать: попадёт то, что записано к моменту вызова.
+void writeChromeTrace(std::ostream& out);
+void saveChromeTrace(const std::string& filename);
+
+// Сколько событий вытеснено из колец с начала записи.
+std::size_t overwrittenEvents();
+
+class Scope {
+public:
+    explicit Scope(const char* name) noexcept
+        : name_(name), startNs_(active() ? now() : -1) {}
+
+    Scope(const char* name, const char* argName, std::int64_t argValue) noexcept
+        : name_(name), argName_(argName), argValue_(argValue), startNs_(active() ? now() : -1) {}
+
+    ~Scope() {
+        if (startNs_ >= 0 && active()) record({name_, argName_, argValue_, startNs_, now() - startNs_});
+    }
+
+    Scope(const Scope&) = delete;
+    Scope& operator=(const Scope&) = delete;
+
+private:
+    const char* name_;
+    const char* argName_ = nullptr;
+    std::int64_t argValue_ = 0;
+    std::int64_t startNs_;
+};
+
+}
+
+#if KANBAN_TRACING
+#define KANBAN_TRACE_CONCAT_(a, b) a##b
+#define KANBAN_TRACE_CONCAT(a, b) KANBAN_TRACE_CONCAT_(a, b)
+#define KANBAN_TRACE_SCOPE(name) \
+    ::tracing::Scope KANBAN_TRACE_CONCAT(kanbanTraceScope_, __LINE__)(name)
+#define KANBAN_TRACE_SCOPE_ARG(name, argName, value) \
+    ::tracing::Scope KANBAN_TRACE_CONCAT(kanbanTraceScope_, __LINE__)(name, argName, (std::int64_t)(value))
+#else
+#define KANBAN_TRACE_SCOPE(name) ((void)0)
+#define KANBAN_TRACE_SCOPE_ARG(name, argName, value) ((void)0)
+#endif